@@ -0,0 +1,572 @@
+// End-to-end fly-through benchmark. Drives Player and Camera along scripted
+// paths and runs the game's per-frame work for each frame: chunk streaming,
+// collision, block raycast, meshing and rendering of sky, chunks, block
+// highlight, water and UI. The render device is the null backend, so it runs headless
+// and counts the GPU traffic each frame would have caused. Reports frame-time
+// percentiles, stall frames (frames over budget in which chunks were loaded or
+// meshed), draw calls, triangles, bytes uploaded and water re-sorts per frame,
+// and heap allocations per frame: overall, in steady frames (nothing loaded or
+// meshed) and per profiled scope.
+//
+//   hackvoxel_flythrough [--scenario sprint|spiral|teleport|hover|walk|all] [--path FILE]
+//                        [--seconds S] [--speed BLOCKS_PER_SECOND]
+//                        [--budget-ms MS] [--overlay] [--output FILE] [--trace FILE]
+//
+// --path replays a recorded path instead: one "x y z yaw pitch" line per frame.
+// --overlay draws the F3 debug overlay every frame, to measure its cost.
+// --trace writes a Chrome trace of the runs (open it in ui.perfetto.dev); long
+// runs fill the per-thread event buffers and drop the later events.
+// The simulation always advances 1/60 s per frame, so every run follows the
+// same path regardless of how fast the machine is.
+
+#include "allocation_tracker.h"
+#include "block_interaction.h"
+#include "camera.h"
+#include "chunk_manager.h"
+#include "log.h"
+#include "null_render_device.h"
+#include "memory_stats.h"
+#include "player.h"
+#include "profiler.h"
+#include "skybox.h"
+#include "trace.h"
+#include "ui.h"
+#include "water_shader.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const float FRAME_SECONDS = 1.0f / 60.0f;
+const float FLIGHT_HEIGHT = 6.0f;      // Blocks above the terrain surface
+const float TELEPORT_DISTANCE = 4096.0f;
+const float TELEPORT_HOLD_SECONDS = 4.0f;
+
+// One frame of a path: eye position and view angles in degrees
+struct PathPoint {
+    glm::vec3 position;
+    float yaw;
+    float pitch;
+};
+
+struct FrameSample {
+    double milliseconds;
+    int loaded;
+    int generated;
+    int meshed;
+    size_t drawCalls;
+    size_t elementsDrawn;
+    size_t bytesUploaded;
+    int allocations;
+    int culled;
+    int occluded;
+    int waterSorts;
+};
+
+// Allocations made inside one profiled scope (children included) over a run
+struct ScopeAllocations {
+    const char* name;
+    long long allocations;
+    long long bytes;
+};
+
+struct ScenarioResult {
+    std::string name;
+    int frames = 0;
+    double spawnMs = 0.0;
+    double meanMs = 0.0, p50Ms = 0.0, p95Ms = 0.0, p99Ms = 0.0, maxMs = 0.0;
+    int overBudgetFrames = 0;
+    int stallFrames = 0;        // Over budget while loading or meshing chunks
+    long long chunksLoaded = 0;
+    long long chunksGenerated = 0;
+    long long meshBuilds = 0;
+    double meanDrawCalls = 0.0;
+    double meanTriangles = 0.0;
+    double meanCulled = 0.0;        // Chunks skipped by cave culling
+    double meanOccluded = 0.0;      // Chunks skipped by occlusion culling
+    double meanWaterSorts = 0.0;    // Chunk water meshes re-sorted for the camera
+    size_t maxDrawCalls = 0;
+    long long bytesUploaded = 0;
+    size_t maxFrameBytesUploaded = 0;
+    double meanAllocations = 0.0;
+    int steadyFrames = 0;           // Frames that loaded and meshed nothing
+    int maxSteadyAllocations = 0;
+    size_t peakCpuBytes = 0;        // Accounted by MemoryStats
+    size_t peakGpuBytes = 0;
+    int finalLoadRadius = 0;
+    std::string memoryReport;       // MemoryStats table after the last frame
+    std::vector<ScopeAllocations> scopeAllocations;   // Most allocations first
+};
+
+// Add a finished profiler frame's scopes to the per-scope totals
+void addScopeAllocations(const Profiler::Frame& frame, std::vector<ScopeAllocations>& totals) {
+    for (int s = 0; s < frame.scopeCount; s++) {
+        const Profiler::Scope& scope = frame.scopes[s];
+        if (scope.allocations == 0) continue;
+        auto it = std::find_if(totals.begin(), totals.end(), [&](const ScopeAllocations& entry) {
+            return std::strcmp(entry.name, scope.name) == 0;
+        });
+        if (it == totals.end()) {
+            totals.push_back({ scope.name, 0, 0 });
+            it = totals.end() - 1;
+        }
+        it->allocations += scope.allocations;
+        it->bytes += static_cast<long long>(scope.allocatedBytes);
+    }
+}
+
+double percentile(const std::vector<double>& sorted, double fraction) {
+    size_t index = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+float flightHeight(const TerrainGenerator& generator, float x, float z) {
+    return generator.sampleColumn(x, z).surfaceHeight + FLIGHT_HEIGHT;
+}
+
+// Straight line along +x
+std::vector<PathPoint> sprintPath(const TerrainGenerator& generator, int frames, float speed) {
+    std::vector<PathPoint> path;
+    for (int i = 0; i < frames; i++) {
+        float x = 8.0f + i * FRAME_SECONDS * speed;
+        float z = 8.0f;
+        path.push_back({ glm::vec3(x, flightHeight(generator, x, z), z), 0.0f, -10.0f });
+    }
+    return path;
+}
+
+// Along +z on foot, looking ahead at eye level, where hills hide the most terrain
+std::vector<PathPoint> walkPath(const TerrainGenerator& generator, int frames, float speed) {
+    std::vector<PathPoint> path;
+    for (int i = 0; i < frames; i++) {
+        float x = 8.0f;
+        float z = 8.0f + i * FRAME_SECONDS * speed;
+        float y = static_cast<float>(generator.sampleColumn(x, z).surfaceHeight + 1);
+        path.push_back({ glm::vec3(x, y, z), 90.0f, 0.0f });
+    }
+    return path;
+}
+
+// Outward spiral around the origin at constant ground speed, turning every frame
+std::vector<PathPoint> spiralPath(const TerrainGenerator& generator, int frames, float speed) {
+    const float ringSpacing = 3.0f * VoxelChunk::CHUNK_SIZE;   // Radius gained per turn
+    std::vector<PathPoint> path;
+    float angle = 0.0f;
+    for (int i = 0; i < frames; i++) {
+        float radius = 8.0f + ringSpacing * angle / 6.2831853f;
+        float x = radius * std::cos(angle);
+        float z = radius * std::sin(angle);
+        // Heading is the tangent of the spiral
+        float yaw = glm::degrees(angle) + 90.0f;
+        path.push_back({ glm::vec3(x, flightHeight(generator, x, z), z), yaw, -10.0f });
+        angle += speed * FRAME_SECONDS / radius;
+    }
+    return path;
+}
+
+// Hover and look around, then jump far enough that nothing loaded is reused
+std::vector<PathPoint> teleportPath(const TerrainGenerator& generator, int frames) {
+    const int holdFrames = static_cast<int>(TELEPORT_HOLD_SECONDS / FRAME_SECONDS);
+    std::vector<PathPoint> path;
+    for (int i = 0; i < frames; i++) {
+        int jump = i / holdFrames;
+        float x = 8.0f + jump * TELEPORT_DISTANCE;
+        float z = 8.0f - jump * TELEPORT_DISTANCE * 0.5f;
+        float yaw = (i % holdFrames) * 360.0f / holdFrames;
+        path.push_back({ glm::vec3(x, flightHeight(generator, x, z), z), yaw, -15.0f });
+    }
+    return path;
+}
+
+// Stay in one place and look around; once streaming finishes every frame is steady state
+std::vector<PathPoint> hoverPath(const TerrainGenerator& generator, int frames) {
+    std::vector<PathPoint> path;
+    glm::vec3 position(8.0f, flightHeight(generator, 8.0f, 8.0f), 8.0f);
+    for (int i = 0; i < frames; i++) {
+        float seconds = i * FRAME_SECONDS;
+        path.push_back({ position, seconds * 45.0f, -20.0f + 15.0f * std::sin(seconds) });
+    }
+    return path;
+}
+
+bool loadPath(const std::string& fileName, std::vector<PathPoint>& path) {
+    std::ifstream file(fileName);
+    if (!file) {
+        std::cerr << "Cannot open path " << fileName << std::endl;
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        PathPoint point;
+        if (fields >> point.position.x >> point.position.y >> point.position.z >> point.yaw >> point.pitch) {
+            path.push_back(point);
+        }
+    }
+    if (path.empty()) {
+        std::cerr << "Path " << fileName << " has no frames" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+ScenarioResult runScenario(const std::string& name, const std::vector<PathPoint>& path, double budgetMs,
+                           bool debugOverlay, bool caveCulling, bool occlusionCulling) {
+    NullRenderDevice device;
+    ChunkManager chunkManager(device);
+    chunkManager.setCaveCulling(caveCulling);
+    chunkManager.setOcclusionCulling(occlusionCulling);
+    BlockInteraction blockInteraction;
+    Skybox skybox;
+    WaterShader waterShader;
+    UI ui;
+    Player player(path.front().position);
+    Camera camera(path.front().position);
+    glm::mat4 projection = glm::perspective(glm::radians(camera.zoom), 800.0f / 600.0f, 0.1f, 1500.0f);
+
+    ScenarioResult result;
+    result.name = name;
+
+    // Spawn, as main() does before the first frame
+    Clock::time_point spawnStart = Clock::now();
+    chunkManager.initialize(player.position);
+    result.spawnMs = std::chrono::duration<double, std::milli>(Clock::now() - spawnStart).count();
+
+    skybox.initialize(device);
+    waterShader.initialize(device);
+    ui.initialize(device);
+    blockInteraction.initialize(device);
+    if (debugOverlay) ui.toggleDebugOverlay();
+    DebugOverlayStats debugStats;
+    debugStats.maxChunks = (2 * ChunkManager::LOAD_DISTANCE + 1) * (2 * ChunkManager::LOAD_DISTANCE + 1);
+    const unsigned int shaderProgram = device.createProgram("", "");
+    device.useProgram(shaderProgram);
+    device.setUniform(shaderProgram, "ourTexture", 0);
+    CameraUniforms cameraUniforms;
+    const UniformBufferHandle cameraBuffer = device.createUniformBuffer(UniformBlock::CAMERA, sizeof(CameraUniforms));
+    const unsigned int atlasTexture = 1;
+
+    std::vector<FrameSample> frames;
+    frames.reserve(path.size());
+    result.scopeAllocations.reserve(Profiler::MAX_SCOPES_PER_FRAME);
+    for (const PathPoint& point : path) {
+        device.resetStats();
+        Clock::time_point start = Clock::now();
+        AllocationTracker::Counts allocationsBefore = AllocationTracker::getThreadCounts();
+        Profiler::get().beginFrame();
+        if (!frames.empty()) {
+            addScopeAllocations(Profiler::get().getFrame(0), result.scopeAllocations);
+        }
+
+        // Player follows the path; the camera sits at eye height like Player::update places it
+        player.position = point.position;
+        camera.position = player.position + glm::vec3(0.0f, player.size.y - 0.2f, 0.0f);
+        camera.yaw = point.yaw;
+        camera.pitch = point.pitch;
+        camera.updateCameraVectors();
+
+        chunkManager.update(player.position);
+        Trace::counter("loaded chunks", chunkManager.getLoadedChunkCount());
+        Trace::counter("pending chunks", chunkManager.getPendingChunkCount());
+        player.isOnGround = player.checkCollision(player.position - glm::vec3(0.0f, 0.1f, 0.0f), chunkManager);
+        RaycastHit hit = blockInteraction.raycastToBlock(camera, chunkManager);
+        if (hit.hit) {
+            ui.setTargetedBlock(chunkManager.getBlockType(hit.blockPosition), hit.blockPosition);
+        } else {
+            ui.clearTargetedBlock();
+        }
+        skybox.update(FRAME_SECONDS);
+
+        // Same draw sequence as main()
+        glm::mat4 view = camera.getViewMatrix();
+        cameraUniforms.view = view;
+        cameraUniforms.projection = projection;
+        cameraUniforms.viewProjection = projection * view;
+        cameraUniforms.position = glm::vec4(camera.position, 1.0f);
+        device.updateUniformBuffer(cameraBuffer, &cameraUniforms, sizeof(cameraUniforms));
+        skybox.render();
+        device.setBlending(false);
+        device.useProgram(shaderProgram);
+        device.bindTexture(0, atlasTexture);
+        chunkManager.render(shaderProgram, player.position, view, projection);
+        blockInteraction.renderBlockHighlight(hit);
+        device.setBlending(true);
+        device.setDepthWrite(false);
+        waterShader.use();
+        waterShader.setTime(static_cast<float>(frames.size()) * FRAME_SECONDS);
+        chunkManager.renderWater(waterShader.getProgram(), camera.position);
+        Trace::counter("water sorts", chunkManager.getLastWaterSortCount());
+        device.setDepthWrite(true);
+        if (debugOverlay) {
+            debugStats.loadedChunks = chunkManager.getLoadedChunkCount();
+            debugStats.renderedChunks = chunkManager.getRenderedChunkCount();
+            debugStats.pendingChunks = chunkManager.getPendingChunkCount();
+            debugStats.culledChunks = chunkManager.getCulledChunkCount() + chunkManager.getOccludedChunkCount();
+            ui.setDebugStats(debugStats);
+        }
+        ui.render(800, 600);
+
+        FrameSample sample;
+        sample.milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        sample.allocations = static_cast<int>(AllocationTracker::getThreadCounts().allocations - allocationsBefore.allocations);
+        sample.loaded = chunkManager.getLastLoadedCount();
+        sample.generated = chunkManager.getLastGeneratedCount();
+        sample.meshed = chunkManager.getLastMeshBuildCount();
+        sample.drawCalls = device.getStats().drawCalls;
+        sample.elementsDrawn = device.getStats().elementsDrawn;
+        sample.bytesUploaded = device.getStats().bytesUploaded;
+        sample.culled = chunkManager.getCulledChunkCount();
+        sample.occluded = chunkManager.getOccludedChunkCount();
+        sample.waterSorts = chunkManager.getLastWaterSortCount();
+        frames.push_back(sample);
+        result.peakCpuBytes = std::max(result.peakCpuBytes, MemoryStats::getCpuBytes());
+        result.peakGpuBytes = std::max(result.peakGpuBytes, MemoryStats::getGpuBytes());
+    }
+    result.finalLoadRadius = chunkManager.getLoadRadius();
+    MemoryStats::formatReport(result.memoryReport);
+    Profiler::get().beginFrame();
+    addScopeAllocations(Profiler::get().getFrame(0), result.scopeAllocations);
+    std::sort(result.scopeAllocations.begin(), result.scopeAllocations.end(),
+              [](const ScopeAllocations& a, const ScopeAllocations& b) { return a.allocations > b.allocations; });
+
+    std::vector<double> sorted;
+    double totalMs = 0.0;
+    double totalDrawCalls = 0.0;
+    double totalElements = 0.0;
+    double totalAllocations = 0.0;
+    double totalCulled = 0.0;
+    double totalOccluded = 0.0;
+    double totalWaterSorts = 0.0;
+    for (const FrameSample& frame : frames) {
+        totalAllocations += frame.allocations;
+        totalCulled += frame.culled;
+        totalOccluded += frame.occluded;
+        totalWaterSorts += frame.waterSorts;
+        if (frame.loaded == 0 && frame.meshed == 0) {
+            result.steadyFrames++;
+            result.maxSteadyAllocations = std::max(result.maxSteadyAllocations, frame.allocations);
+        }
+        sorted.push_back(frame.milliseconds);
+        totalMs += frame.milliseconds;
+        result.chunksLoaded += frame.loaded;
+        result.chunksGenerated += frame.generated;
+        result.meshBuilds += frame.meshed;
+        totalDrawCalls += frame.drawCalls;
+        totalElements += frame.elementsDrawn;
+        result.maxDrawCalls = std::max(result.maxDrawCalls, frame.drawCalls);
+        result.bytesUploaded += frame.bytesUploaded;
+        result.maxFrameBytesUploaded = std::max(result.maxFrameBytesUploaded, frame.bytesUploaded);
+        if (frame.milliseconds > budgetMs) {
+            result.overBudgetFrames++;
+            if (frame.loaded > 0 || frame.meshed > 0) {
+                result.stallFrames++;
+            }
+        }
+    }
+    std::sort(sorted.begin(), sorted.end());
+    result.frames = static_cast<int>(frames.size());
+    result.meanMs = totalMs / frames.size();
+    result.p50Ms = percentile(sorted, 0.50);
+    result.p95Ms = percentile(sorted, 0.95);
+    result.p99Ms = percentile(sorted, 0.99);
+    result.maxMs = sorted.back();
+    result.meanDrawCalls = totalDrawCalls / frames.size();
+    result.meanTriangles = totalElements / 3.0 / frames.size();
+    result.meanAllocations = totalAllocations / frames.size();
+    result.meanCulled = totalCulled / frames.size();
+    result.meanOccluded = totalOccluded / frames.size();
+    result.meanWaterSorts = totalWaterSorts / frames.size();
+    return result;
+}
+
+std::string toJson(const std::vector<ScenarioResult>& results, double budgetMs) {
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    json << "{\n";
+    json << "  \"frames_per_second\": " << 1.0f / FRAME_SECONDS << ",\n";
+    json << "  \"budget_ms\": " << budgetMs << ",\n";
+    json << "  \"scenarios\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const ScenarioResult& r = results[i];
+        json << "    {\"name\": \"" << r.name << "\", \"frames\": " << r.frames
+             << ", \"spawn_ms\": " << r.spawnMs << ", \"mean_ms\": " << r.meanMs
+             << ", \"p50_ms\": " << r.p50Ms << ", \"p95_ms\": " << r.p95Ms << ", \"p99_ms\": " << r.p99Ms
+             << ", \"max_ms\": " << r.maxMs << ", \"over_budget_frames\": " << r.overBudgetFrames
+             << ", \"stall_frames\": " << r.stallFrames << ", \"chunks_loaded\": " << r.chunksLoaded
+             << ", \"chunks_generated\": " << r.chunksGenerated << ", \"mesh_builds\": " << r.meshBuilds
+ << ", \"mean_draw_calls\": " << r.meanDrawCalls << ", \"mean_triangles\": " << r.meanTriangles << ", \"mean_culled_chunks\": " << r.meanCulled
+             << ", \"mean_occluded_chunks\": " << r.meanOccluded << ", \"mean_water_sorts\": " << r.meanWaterSorts
+             << ", \"max_draw_calls\": " << r.maxDrawCalls
+             << ", \"bytes_uploaded\": " << r.bytesUploaded
+             << ", \"max_frame_bytes_uploaded\": " << r.maxFrameBytesUploaded
+             << ", \"mean_allocations\": " << r.meanAllocations << ", \"steady_frames\": " << r.steadyFrames
+             << ", \"max_steady_allocations\": " << r.maxSteadyAllocations
+             << ", \"peak_cpu_bytes\": " << r.peakCpuBytes << ", \"peak_gpu_bytes\": " << r.peakGpuBytes
+             << ", \"final_load_radius\": " << r.finalLoadRadius << "}"
+             << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n}\n";
+    return json.str();
+}
+
+void printUsage() {
+    std::cerr << "usage: hackvoxel_flythrough [--scenario sprint|spiral|teleport|hover|walk|all] [--path FILE]\n"
+                 "                            [--seconds S] [--speed BLOCKS_PER_SECOND]\n"
+                 "                            [--budget-ms MS] [--overlay] [--output FILE] [--trace FILE]\n"
+                 "                            [--memory-budget NAME=MB]...\n"
+                 "                            [--no-cave-culling] [--no-occlusion-culling]" << std::endl;
+}
+
+}
+
+int main(int argc, char** argv) {
+    // The engine logs chunk streaming; keep the report readable
+    Log::setLevel(LogLevel::Warning);
+
+    std::string scenario = "all";
+    std::string pathFile;
+    std::string outputPath;
+    std::string tracePath;
+    float seconds = 20.0f;
+    float speed = Player().sprintSpeed;
+    double budgetMs = 1000.0 / 60.0;
+    bool debugOverlay = false;
+    bool caveCulling = true;
+    bool occlusionCulling = true;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) {
+            scenario = argv[++i];
+        } else if (std::strcmp(argv[i], "--path") == 0 && i + 1 < argc) {
+            pathFile = argv[++i];
+        } else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = static_cast<float>(std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+            speed = static_cast<float>(std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--budget-ms") == 0 && i + 1 < argc) {
+            budgetMs = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--memory-budget") == 0 && i + 1 < argc) {
+            if (!MemoryStats::parseBudget(argv[++i])) {
+                printUsage();
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--overlay") == 0) {
+            debugOverlay = true;
+        } else if (std::strcmp(argv[i], "--no-cave-culling") == 0) {
+            caveCulling = false;
+        } else if (std::strcmp(argv[i], "--no-occlusion-culling") == 0) {
+            occlusionCulling = false;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    int frameCount = std::max(1, static_cast<int>(seconds / FRAME_SECONDS));
+
+    TerrainGenerator generator;
+    std::vector<std::pair<std::string, std::vector<PathPoint>>> scenarios;
+    if (!pathFile.empty()) {
+        std::vector<PathPoint> path;
+        if (!loadPath(pathFile, path)) return 1;
+        scenarios.emplace_back("recorded", path);
+    } else {
+        if (scenario == "sprint" || scenario == "all")
+            scenarios.emplace_back("sprint", sprintPath(generator, frameCount, speed));
+        if (scenario == "spiral" || scenario == "all")
+            scenarios.emplace_back("spiral", spiralPath(generator, frameCount, speed));
+        if (scenario == "teleport" || scenario == "all")
+            scenarios.emplace_back("teleport", teleportPath(generator, frameCount));
+        if (scenario == "hover" || scenario == "all")
+            scenarios.emplace_back("hover", hoverPath(generator, frameCount));
+        if (scenario == "walk" || scenario == "all")
+            scenarios.emplace_back("walk", walkPath(generator, frameCount, speed));
+        if (scenarios.empty()) {
+            printUsage();
+            return 1;
+        }
+    }
+
+    Trace::setThreadName("main");
+    if (!tracePath.empty()) {
+        Trace::start();
+    }
+    std::vector<ScenarioResult> results;
+    for (const auto& entry : scenarios) {
+        std::cerr << "Running " << entry.first << " (" << entry.second.size() << " frames)..." << std::endl;
+        results.push_back(runScenario(entry.first, entry.second, budgetMs, debugOverlay, caveCulling, occlusionCulling));
+    }
+    Log::flush();
+
+    if (!tracePath.empty()) {
+        Trace::stop();
+        if (!Trace::write(tracePath)) return 1;
+        std::cerr << "Wrote " << Trace::getEventCount() << " trace events to " << tracePath;
+        if (Trace::getDroppedCount() > 0) std::cerr << " (" << Trace::getDroppedCount() << " dropped)";
+        std::cerr << std::endl;
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::left << std::setw(10) << "scenario" << std::right
+              << std::setw(8) << "frames" << std::setw(10) << "p50 ms" << std::setw(10) << "p95 ms"
+              << std::setw(10) << "p99 ms" << std::setw(10) << "max ms" << std::setw(8) << "stalls"
+              << std::setw(9) << "loaded" << std::setw(9) << "meshed" << std::setw(8) << "draws" << std::setw(9) << "k tris" << std::setw(8) << "culled" << std::setw(10) << "occluded"
+              << std::setw(9) << "resorts"
+              << std::setw(12) << "upload MB" << std::setw(9) << "allocs" << std::setw(13) << "steady max"
+              << std::setw(10) << "peak cpu" << std::setw(10) << "peak gpu" << std::setw(8) << "radius" << std::endl;
+    for (const ScenarioResult& r : results) {
+        std::cout << std::left << std::setw(10) << r.name << std::right
+                  << std::setw(8) << r.frames << std::setw(10) << r.p50Ms << std::setw(10) << r.p95Ms
+                  << std::setw(10) << r.p99Ms << std::setw(10) << r.maxMs << std::setw(8) << r.stallFrames
+                  << std::setw(9) << r.chunksLoaded << std::setw(9) << r.meshBuilds
+                  << std::setw(8) << static_cast<int>(r.meanDrawCalls + 0.5)
+                  << std::setw(9) << r.meanTriangles / 1000.0
+                  << std::setw(8) << static_cast<int>(r.meanCulled + 0.5)
+                  << std::setw(10) << static_cast<int>(r.meanOccluded + 0.5)
+                  << std::setw(9) << r.meanWaterSorts
+                  << std::setw(12) << r.bytesUploaded / (1024.0 * 1024.0)
+                  << std::setw(9) << r.meanAllocations << std::setw(13) << r.maxSteadyAllocations
+                  << std::setw(10) << r.peakCpuBytes / (1024.0 * 1024.0) << std::setw(10) << r.peakGpuBytes / (1024.0 * 1024.0)
+                  << std::setw(8) << r.finalLoadRadius << std::endl;
+    }
+
+    // Memory by category at the end of each scenario
+    for (const ScenarioResult& r : results) {
+        std::cout << "\n" << r.name << " memory after the last frame:\n" << r.memoryReport;
+    }
+
+    // Where the allocations came from; scopes include their children
+    for (const ScenarioResult& r : results) {
+        if (r.scopeAllocations.empty()) continue;
+        std::cout << "\n" << r.name << " allocations per frame by scope:" << std::endl;
+        for (size_t i = 0; i < r.scopeAllocations.size() && i < 8; i++) {
+            const ScopeAllocations& scope = r.scopeAllocations[i];
+            std::cout << "  " << std::left << std::setw(36) << scope.name << std::right
+                      << std::setw(10) << static_cast<double>(scope.allocations) / r.frames << " ("
+                      << scope.bytes / (1024.0 * r.frames) << " KB)" << std::endl;
+        }
+    }
+
+    if (!outputPath.empty()) {
+        std::ofstream file(outputPath);
+        file << toJson(results, budgetMs);
+        if (!file) {
+            std::cerr << "Cannot write " << outputPath << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
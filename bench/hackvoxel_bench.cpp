@@ -0,0 +1,286 @@
+// Microbenchmarks for the world hot paths: chunk loading, meshing, block
+// raycasts, player collision and chunk map lookups. Every input comes from
+// fixed coordinates or a fixed-seed generator, so runs are comparable over
+// time. Results are written as JSON (ns/op with percentiles, allocations/op).
+//
+//   hackvoxel_bench [--filter SUBSTRING] [--output FILE]
+//
+// Needs no window or GL context: nothing here issues GL calls.
+
+#include "allocation_tracker.h"
+#include "block_interaction.h"
+#include "camera.h"
+#include "chunk_manager.h"
+#include "log.h"
+#include "noise_batch.h"
+#include "null_render_device.h"
+#include "player.h"
+#include "voxel_chunk.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const unsigned int BENCH_SEED = 20240601u;
+const int WORLD_RADIUS = 3;   // Chunks loaded around the origin for world queries
+
+struct Result {
+    std::string name;
+    long long iterations = 0;
+    double meanNs = 0.0;
+    double minNs = 0.0, p50Ns = 0.0, p90Ns = 0.0, p99Ns = 0.0, maxNs = 0.0;
+    double allocsPerOp = 0.0;
+    double bytesPerOp = 0.0;
+};
+
+double percentile(const std::vector<double>& sorted, double fraction) {
+    size_t index = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+/**
+ * Runs op(i) for samples * batch iterations after a short warmup. Each sample
+ * times one batch, so cheap operations are not swamped by clock overhead;
+ * percentiles are over per-op sample times.
+ */
+Result runBenchmark(const std::string& name, int samples, int batch, const std::function<void(long long)>& op) {
+    long long i = 0;
+    for (int warmup = 0; warmup < std::max(1, samples / 10) * batch; warmup++) {
+        op(i++);
+    }
+
+    std::vector<double> sampleNs;
+    sampleNs.reserve(samples);
+    // Counted by the allocation hook linked into this benchmark
+    AllocationTracker::Counts before = AllocationTracker::getThreadCounts();
+    double totalNs = 0.0;
+    for (int s = 0; s < samples; s++) {
+        Clock::time_point start = Clock::now();
+        for (int b = 0; b < batch; b++) {
+            op(i++);
+        }
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        totalNs += ns;
+        sampleNs.push_back(ns / batch);
+    }
+    AllocationTracker::Counts after = AllocationTracker::getThreadCounts();
+    unsigned long long allocations = after.allocations - before.allocations;
+    unsigned long long bytes = after.bytes - before.bytes;
+
+    std::sort(sampleNs.begin(), sampleNs.end());
+    Result result;
+    result.name = name;
+    result.iterations = static_cast<long long>(samples) * batch;
+    result.meanNs = totalNs / result.iterations;
+    result.minNs = sampleNs.front();
+    result.p50Ns = percentile(sampleNs, 0.50);
+    result.p90Ns = percentile(sampleNs, 0.90);
+    result.p99Ns = percentile(sampleNs, 0.99);
+    result.maxNs = sampleNs.back();
+    // Sample vector was reserved up front, so these are the benchmarked code's own
+    result.allocsPerOp = static_cast<double>(allocations) / result.iterations;
+    result.bytesPerOp = static_cast<double>(bytes) / result.iterations;
+    return result;
+}
+
+// Fixed-seed points just above the terrain of the loaded world
+std::vector<glm::vec3> surfacePoints(const ChunkManager& world, int count, float heightAbove) {
+    std::mt19937 rng(BENCH_SEED);
+    float extent = (WORLD_RADIUS + 0.5f) * VoxelChunk::CHUNK_SIZE - 2.0f;
+    std::uniform_real_distribution<float> horizontal(-extent, extent);
+    std::vector<glm::vec3> points;
+    points.reserve(count);
+    while (static_cast<int>(points.size()) < count) {
+        float x = horizontal(rng);
+        float z = horizontal(rng);
+        int surface = world.getSurfaceHeight(x, z);
+        if (surface < 0) continue;
+        points.emplace_back(x, surface + heightAbove, z);
+    }
+    return points;
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+std::string toJson(const std::vector<Result>& results) {
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(1);
+    json << "{\n";
+    json << "  \"seed\": " << BENCH_SEED << ",\n";
+    json << "  \"noise_backend\": \"" << BatchNoise::getBackendName(BatchNoise::getBackend()) << "\",\n";
+    json << "  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        json << "    {\"name\": \"" << jsonEscape(r.name) << "\", \"iterations\": " << r.iterations
+             << ", \"ns_per_op\": " << r.meanNs
+             << ", \"min_ns\": " << r.minNs << ", \"p50_ns\": " << r.p50Ns << ", \"p90_ns\": " << r.p90Ns
+             << ", \"p99_ns\": " << r.p99Ns << ", \"max_ns\": " << r.maxNs
+             << std::setprecision(3) << ", \"allocs_per_op\": " << r.allocsPerOp
+             << std::setprecision(1) << ", \"bytes_per_op\": " << r.bytesPerOp << "}"
+             << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n}\n";
+    return json.str();
+}
+
+// Benchmarks whose name contains filter (all when empty)
+std::vector<Result> runBenchmarks(const std::string& filter) {
+    NullRenderDevice device;
+    ChunkManager world(device);
+    for (int x = -WORLD_RADIUS; x <= WORLD_RADIUS; x++) {
+        for (int z = -WORLD_RADIUS; z <= WORLD_RADIUS; z++) {
+            world.loadChunk(ChunkCoord(x, z));
+        }
+    }
+
+    std::vector<Result> results;
+    auto enabled = [&](const char* name) {
+        return filter.empty() || std::string(name).find(filter) != std::string::npos;
+    };
+
+    if (enabled("chunk_manager.load_chunk")) {
+        // Far from the preloaded area: generate a chunk and drop it again, so the map stays small
+        ChunkManager loader(device);
+        std::vector<ChunkCoord> coords;
+        for (int i = 0; i < 1024; i++) {
+            coords.emplace_back(1000 + i % 32, -1000 + i / 32);
+        }
+        results.push_back(runBenchmark("chunk_manager.load_chunk", 400, 1, [&](long long i) {
+            const ChunkCoord& coord = coords[i % coords.size()];
+            loader.loadChunk(coord);
+            loader.unloadChunk(coord);
+        }));
+    }
+
+    // Meshing inputs: the preloaded chunks, meshed into one reused buffer
+    std::vector<VoxelChunk*> meshChunks;
+    for (int x = -WORLD_RADIUS; x <= WORLD_RADIUS; x++) {
+        for (int z = -WORLD_RADIUS; z <= WORLD_RADIUS; z++) {
+            meshChunks.push_back(world.getChunkAt(x, z));
+        }
+    }
+    ChunkMesh mesh;
+    ChunkMesh waterMesh;
+    for (int lod = 0; lod < VoxelChunk::LOD_LEVELS; lod++) {
+        std::string name = "voxel_chunk.generate_mesh.lod" + std::to_string(lod);
+        if (!enabled(name.c_str())) continue;
+        results.push_back(runBenchmark(name, 200, 1, [&](long long i) {
+            meshChunks[i % meshChunks.size()]->generateMesh(mesh, lod, &waterMesh);
+        }));
+    }
+
+    if (enabled("block_interaction.raycast_to_block")) {
+        // Eye-height rays in fixed random directions, mostly downward into the terrain
+        BlockInteraction interaction;
+        std::vector<glm::vec3> origins = surfacePoints(world, 256, 1.6f);
+        std::mt19937 rng(BENCH_SEED + 1);
+        std::uniform_real_distribution<float> yaw(0.0f, 6.2831853f);
+        std::uniform_real_distribution<float> pitch(-1.2f, 0.3f);
+        std::vector<Camera> cameras;
+        for (const glm::vec3& origin : origins) {
+            float a = yaw(rng), b = pitch(rng);
+            Camera camera(origin);
+            camera.front = glm::vec3(std::cos(a) * std::cos(b), std::sin(b), std::sin(a) * std::cos(b));
+            cameras.push_back(camera);
+        }
+        int hits = 0;
+        results.push_back(runBenchmark("block_interaction.raycast_to_block", 200, 16, [&](long long i) {
+            hits += interaction.raycastToBlock(cameras[i % cameras.size()], world).hit ? 1 : 0;
+        }));
+    }
+
+    if (enabled("player.check_collision")) {
+        // Half the boxes overlap the surface, half are clear of it
+        Player player;
+        std::vector<glm::vec3> positions = surfacePoints(world, 512, 0.5f);
+        for (size_t i = 0; i < positions.size(); i += 2) {
+            positions[i].y += 1.0f;
+        }
+        int collisions = 0;
+        results.push_back(runBenchmark("player.check_collision", 200, 64, [&](long long i) {
+            collisions += player.checkCollision(positions[i % positions.size()], world) ? 1 : 0;
+        }));
+    }
+
+    if (enabled("chunk_manager.get_chunk_at")) {
+        // Mix of loaded and missing chunks around the preloaded area
+        std::mt19937 rng(BENCH_SEED + 2);
+        std::uniform_int_distribution<int> coord(-2 * WORLD_RADIUS, 2 * WORLD_RADIUS);
+        std::vector<ChunkCoord> lookups;
+        for (int i = 0; i < 1024; i++) {
+            lookups.emplace_back(coord(rng), coord(rng));
+        }
+        int found = 0;
+        results.push_back(runBenchmark("chunk_manager.get_chunk_at", 200, 256, [&](long long i) {
+            const ChunkCoord& c = lookups[i % lookups.size()];
+            found += world.getChunkAt(c.x, c.z) ? 1 : 0;
+        }));
+    }
+
+    if (enabled("chunk_manager.get_block_type")) {
+        std::vector<glm::vec3> positions = surfacePoints(world, 1024, -1.0f);
+        int solid = 0;
+        results.push_back(runBenchmark("chunk_manager.get_block_type", 200, 256, [&](long long i) {
+            solid += world.getBlockType(positions[i % positions.size()]) != BlockType::AIR ? 1 : 0;
+        }));
+    }
+
+    return results;
+}
+
+}
+
+int main(int argc, char** argv) {
+    std::string filter;
+    std::string outputPath;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else {
+            std::cerr << "usage: hackvoxel_bench [--filter SUBSTRING] [--output FILE]" << std::endl;
+            return 1;
+        }
+    }
+
+    // ChunkManager logs progress to stdout; keep it out of the JSON
+    Log::setLevel(LogLevel::Warning);
+
+    std::vector<Result> results = runBenchmarks(filter);
+
+    std::string json = toJson(results);
+    if (outputPath.empty()) {
+        std::cout << json;
+    } else {
+        std::ofstream file(outputPath);
+        file << json;
+        if (!file) {
+            std::cerr << "Cannot write " << outputPath << std::endl;
+            return 1;
+        }
+        std::cerr << "Wrote " << results.size() << " results to " << outputPath << std::endl;
+    }
+    return 0;
+}
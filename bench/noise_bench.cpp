@@ -0,0 +1,282 @@
+// Verifies the batched noise kernels against FastNoiseLite and measures terrain
+// generation throughput for every noise backend the CPU supports, with exact
+// and interpolated (sparse lattice) cave/ore noise.
+//
+//   hackvoxel_noise_bench [chunks]
+//
+// Exits with a non-zero status if any backend differs from the scalar path
+// (interpolated caves are approximate by design and only reported).
+
+#include "chunk_coord.h"
+#include "noise_batch.h"
+#include "terrain_generator.h"
+#include "voxel_chunk.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+NoiseSettings makeSettings(int seed, float frequency, FastNoiseLite::FractalType fractalType, int octaves) {
+    NoiseSettings settings;
+    settings.seed = seed;
+    settings.frequency = frequency;
+    settings.fractalType = fractalType;
+    settings.octaves = octaves;
+    return settings;
+}
+
+// Mirrors the fields TerrainGenerator uses, plus a plain single-octave field
+std::vector<NoiseSettings> testSettings() {
+    return {
+        makeSettings(12345, 0.006f, FastNoiseLite::FractalType_FBm, 6),
+        makeSettings(54321, 0.03f, FastNoiseLite::FractalType_FBm, 3),
+        makeSettings(33333, 0.004f, FastNoiseLite::FractalType_Ridged, 4),
+        makeSettings(55555, 0.02f, FastNoiseLite::FractalType_None, 3),
+    };
+}
+
+struct Comparison {
+    long long samples = 0;
+    long long mismatches = 0;   // Not bit-identical
+    float maxDifference = 0.0f;
+
+    void add(float expected, float actual) {
+        samples++;
+        if (std::memcmp(&expected, &actual, sizeof(float)) != 0) mismatches++;
+        maxDifference = std::max(maxDifference, std::fabs(expected - actual));
+    }
+};
+
+// Compare grid fills against per-point getNoise over chunk-sized grids around the origin
+Comparison compareBackend(const NoiseSettings& settings) {
+    BatchNoise noise(settings);
+    Comparison result;
+    const int size = VoxelChunk::CHUNK_SIZE;
+    std::vector<float> out(size * size * size);
+
+    for (int cx = -6; cx < 6; cx++) {
+        for (int cz = -6; cz < 6; cz++) {
+            // 2D at unit spacing, odd width to exercise partial vectors
+            NoiseGrid grid;
+            grid.originX = static_cast<float>(cx * size);
+            grid.originZ = static_cast<float>(cz * size);
+            grid.countX = size + 3;
+            grid.countZ = size;
+            out.resize(grid.countX * grid.countZ);
+            noise.fillGrid2D(grid, out.data());
+            for (int z = 0; z < grid.countZ; z++) {
+                for (int x = 0; x < grid.countX; x++) {
+                    result.add(noise.getNoise(grid.originX + (float)x * grid.stepX, grid.originZ + (float)z * grid.stepZ),
+                               out[z * grid.countX + x]);
+                }
+            }
+
+            // 3D with the ore sampling pattern (non-unit, fractional-free steps)
+            grid.countX = size;
+            grid.countY = size;
+            grid.originY = 3.0f;
+            grid.stepX = grid.stepY = grid.stepZ = 3.0f;
+            out.resize(grid.countX * grid.countY * grid.countZ);
+            noise.fillGrid3D(grid, out.data());
+            for (int y = 0; y < grid.countY; y++) {
+                for (int z = 0; z < grid.countZ; z++) {
+                    for (int x = 0; x < grid.countX; x++) {
+                        result.add(noise.getNoise(grid.originX + (float)x * grid.stepX,
+                                                  grid.originY + (float)y * grid.stepY,
+                                                  grid.originZ + (float)z * grid.stepZ),
+                                   out[(y * grid.countZ + z) * grid.countX + x]);
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+// Chunk coordinates of a square area centred on the origin
+std::vector<ChunkCoord> chunkArea(int chunkCount) {
+    int side = std::max(1, static_cast<int>(std::sqrt(static_cast<double>(chunkCount))));
+    std::vector<ChunkCoord> coords;
+    for (int x = 0; x < side; x++) {
+        for (int z = 0; z < side; z++) {
+            coords.push_back(ChunkCoord(x - side / 2, z - side / 2));
+        }
+    }
+    return coords;
+}
+
+double generateChunks(const TerrainGenerator& generator, const std::vector<ChunkCoord>& coords,
+                      std::vector<std::unique_ptr<VoxelChunk>>& chunks) {
+    chunks.clear();
+    Clock::time_point start = Clock::now();
+    for (const ChunkCoord& coord : coords) {
+        auto chunk = std::make_unique<VoxelChunk>(coord.x, coord.z);
+        generator.generateChunk(*chunk, coord.x, coord.z);
+        chunks.push_back(std::move(chunk));
+    }
+    return secondsSince(start);
+}
+
+long long countDifferentBlocks(const std::vector<std::unique_ptr<VoxelChunk>>& a,
+                               const std::vector<std::unique_ptr<VoxelChunk>>& b) {
+    const int size = VoxelChunk::CHUNK_SIZE;
+    long long different = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        for (int x = 0; x < size; x++) {
+            for (int y = 0; y < size; y++) {
+                for (int z = 0; z < size; z++) {
+                    if (a[i]->getBlockType(x, y, z) != b[i]->getBlockType(x, y, z)) different++;
+                }
+            }
+        }
+    }
+    return different;
+}
+
+long long countOres(const std::vector<std::unique_ptr<VoxelChunk>>& chunks) {
+    const int size = VoxelChunk::CHUNK_SIZE;
+    long long ores = 0;
+    for (const auto& chunk : chunks) {
+        for (int x = 0; x < size; x++) {
+            for (int y = 0; y < size; y++) {
+                for (int z = 0; z < size; z++) {
+                    BlockType type = chunk->getBlockType(x, y, z);
+                    if (type >= BlockType::GOLD_ORE && type <= BlockType::REDSTONE_ORE) ores++;
+                }
+            }
+        }
+    }
+    return ores;
+}
+
+// Air blocks below the column surface (carved out by caves)
+long long countCaveAir(const std::vector<std::unique_ptr<VoxelChunk>>& chunks) {
+    const int size = VoxelChunk::CHUNK_SIZE;
+    long long caveAir = 0;
+    for (const auto& chunk : chunks) {
+        for (int x = 0; x < size; x++) {
+            for (int z = 0; z < size; z++) {
+                for (int y = 1; y < chunk->getColumnHeight(x, z); y++) {
+                    if (chunk->getBlockType(x, y, z) == BlockType::AIR) caveAir++;
+                }
+            }
+        }
+    }
+    return caveAir;
+}
+
+double measureGridThroughput(const BatchNoise& noise, bool volume) {
+    const int size = VoxelChunk::CHUNK_SIZE;
+    std::vector<float> out(size * size * size);
+    NoiseGrid grid;
+    grid.countX = size;
+    grid.countZ = size;
+    grid.countY = volume ? size : 1;
+
+    long long samples = 0;
+    Clock::time_point start = Clock::now();
+    double elapsed = 0.0;
+    for (int i = 0; elapsed < 0.25; i++) {
+        grid.originX = static_cast<float>((i % 64) * size);
+        grid.originZ = static_cast<float>((i / 64) * size);
+        if (volume) {
+            noise.fillGrid3D(grid, out.data());
+        } else {
+            noise.fillGrid2D(grid, out.data());
+        }
+        samples += grid.countX * grid.countY * grid.countZ;
+        elapsed = secondsSince(start);
+    }
+    return samples / elapsed;
+}
+
+}
+
+int main(int argc, char** argv) {
+    int chunkCount = argc > 1 ? std::max(1, std::atoi(argv[1])) : 256;
+    std::vector<BatchNoise::Backend> backends;
+    for (BatchNoise::Backend backend : { BatchNoise::Backend::SCALAR, BatchNoise::Backend::SSE41, BatchNoise::Backend::AVX2 }) {
+        if (BatchNoise::isBackendSupported(backend)) backends.push_back(backend);
+    }
+    std::cout << "Best noise backend: " << BatchNoise::getBackendName(BatchNoise::getBestBackend()) << std::endl;
+
+    bool identical = true;
+
+    // 1. Grid fills against single-sample FastNoiseLite calls
+    std::cout << "\nGrid accuracy (vs FastNoiseLite)" << std::endl;
+    for (BatchNoise::Backend backend : backends) {
+        BatchNoise::setBackend(backend);
+        for (const NoiseSettings& settings : testSettings()) {
+            Comparison result = compareBackend(settings);
+            identical = identical && result.mismatches == 0;
+            std::cout << "  " << std::setw(7) << BatchNoise::getBackendName(backend)
+                      << "  seed " << std::setw(5) << settings.seed
+                      << "  samples " << result.samples
+                      << "  non-identical " << result.mismatches
+                      << "  max diff " << result.maxDifference << std::endl;
+        }
+    }
+
+    // 2. Whole chunks: reference pointwise generation vs batched per backend
+    std::vector<ChunkCoord> coords = chunkArea(chunkCount);
+    TerrainGenerator generator;
+    std::vector<std::unique_ptr<VoxelChunk>> reference, batched;
+
+    generator.setBatchedNoise(false);
+    double pointwiseSeconds = generateChunks(generator, coords, reference);
+    std::cout << "\nChunk generation (" << coords.size() << " chunks)" << std::endl;
+    std::cout << "  pointwise        " << std::fixed << std::setprecision(1)
+              << coords.size() / pointwiseSeconds << " chunks/s" << std::endl;
+
+    generator.setBatchedNoise(true);
+    for (BatchNoise::Backend backend : backends) {
+        BatchNoise::setBackend(backend);
+        double seconds = generateChunks(generator, coords, batched);
+        long long different = countDifferentBlocks(reference, batched);
+        identical = identical && different == 0;
+        std::cout << "  batched " << std::setw(7) << BatchNoise::getBackendName(backend) << "  "
+                  << coords.size() / seconds << " chunks/s  (" << pointwiseSeconds / seconds << "x, "
+                  << different << " blocks differ)" << std::endl;
+    }
+
+    // Interpolated caves are approximate: report how much of the world they change
+    generator.setInterpolatedCaves(true);
+    for (BatchNoise::Backend backend : backends) {
+        BatchNoise::setBackend(backend);
+        double seconds = generateChunks(generator, coords, batched);
+        long long different = countDifferentBlocks(reference, batched);
+        double blocks = static_cast<double>(coords.size()) * VoxelChunk::CHUNK_SIZE * VoxelChunk::CHUNK_SIZE * VoxelChunk::CHUNK_SIZE;
+        std::cout << "  sparse  " << std::setw(7) << BatchNoise::getBackendName(backend) << "  "
+                  << coords.size() / seconds << " chunks/s  (" << pointwiseSeconds / seconds << "x, "
+                  << std::setprecision(2) << 100.0 * different / blocks << "% of blocks differ, "
+                  << countCaveAir(reference) << " -> " << countCaveAir(batched) << " cave blocks, "
+                  << countOres(reference) << " -> " << countOres(batched) << " ores)"
+                  << std::setprecision(1) << std::endl;
+    }
+    generator.setInterpolatedCaves(false);
+
+    // 3. Raw noise throughput of the chunk-sized grid calls
+    std::cout << "\nNoise throughput (Msamples/s, cave field settings)" << std::endl;
+    BatchNoise caveField(testSettings()[1]);
+    for (BatchNoise::Backend backend : backends) {
+        BatchNoise::setBackend(backend);
+        std::cout << "  " << std::setw(7) << BatchNoise::getBackendName(backend)
+                  << "  2D " << measureGridThroughput(caveField, false) / 1e6
+                  << "  3D " << measureGridThroughput(caveField, true) / 1e6 << std::endl;
+    }
+
+    std::cout << "\n" << (identical ? "All backends match the scalar path" : "MISMATCH against the scalar path") << std::endl;
+    return identical ? 0 : 1;
+}
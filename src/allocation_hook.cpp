@@ -0,0 +1,48 @@
+// Replacement global operator new/delete that count every allocation for
+// AllocationTracker. Compiled into an executable (not a library) so the
+// replacement is always linked: debug builds of the game and the benchmarks.
+// Over-aligned allocations keep the standard library's implementation.
+
+#include "allocation_tracker.h"
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+struct HookRegistration {
+    HookRegistration() { AllocationTracker::setEnabled(); }
+} registration;
+
+void* countedAllocate(std::size_t size) {
+    AllocationTracker::recordAllocation(size);
+    return std::malloc(size ? size : 1);
+}
+
+}
+
+void* operator new(std::size_t size) {
+    void* pointer = countedAllocate(size);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new[](std::size_t size) {
+    void* pointer = countedAllocate(size);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
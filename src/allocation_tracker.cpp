@@ -0,0 +1,30 @@
+#include "allocation_tracker.h"
+
+namespace {
+
+// Plain thread_locals with constant initialization, safe to touch from operator new
+thread_local unsigned long long threadAllocations = 0;
+thread_local unsigned long long threadBytes = 0;
+bool hookLinked = false;
+
+}
+
+bool AllocationTracker::isEnabled() {
+    return hookLinked;
+}
+
+AllocationTracker::Counts AllocationTracker::getThreadCounts() {
+    Counts counts;
+    counts.allocations = threadAllocations;
+    counts.bytes = threadBytes;
+    return counts;
+}
+
+void AllocationTracker::recordAllocation(size_t bytes) {
+    threadAllocations++;
+    threadBytes += bytes;
+}
+
+void AllocationTracker::setEnabled() {
+    hookLinked = true;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * AllocationTracker counts heap allocations per thread. The counting itself
+ * happens in a replacement global operator new (allocation_hook.cpp) that is only
+ * linked into debug builds and the benchmarks; elsewhere the counts stay zero
+ * and isEnabled() is false.
+ *
+ * Profiler reads the counts around every PROFILE_SCOPE, so each profiled
+ * subsystem reports the allocations it made in a frame.
+ */
+class AllocationTracker {
+public:
+    struct Counts {
+        unsigned long long allocations = 0;
+        unsigned long long bytes = 0;
+    };
+
+    // Whether the operator new hook is linked into this executable
+    static bool isEnabled();
+
+    // Allocations made by the calling thread since it started
+    static Counts getThreadCounts();
+
+    // Used by the hook
+    static void recordAllocation(size_t bytes);
+    static void setEnabled();
+};
@@ -0,0 +1,218 @@
+#include "bitmap_font.h"
+#include "log.h"
+#include "memory_stats.h"
+
+namespace {
+
+const int FIRST_CHAR = 32;
+const int CHAR_COUNT = 95;          // ' ' to '~'
+const int SOLID_CELL = CHAR_COUNT;  // Filled cell after the glyphs
+const int CELL_SIZE = 8;
+const int COLUMNS = 16;
+const int ATLAS_WIDTH = COLUMNS * CELL_SIZE;
+const int ATLAS_HEIGHT = 6 * CELL_SIZE;
+
+// Glyph rows top to bottom, bit 4 is the leftmost pixel
+const unsigned char GLYPHS[CHAR_COUNT][BitmapFont::GLYPH_HEIGHT] = {
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },   // space
+    { 0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04 },   // !
+    { 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00 },   // "
+    { 0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A },   // #
+    { 0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04 },   // $
+    { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 },   // %
+    { 0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D },   // &
+    { 0x04, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00 },   // apostrophe
+    { 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02 },   // (
+    { 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08 },   // )
+    { 0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00 },   // *
+    { 0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00 },   // +
+    { 0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08 },   // ,
+    { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 },   // -
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C },   // .
+    { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 },   // /
+    { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E },   // 0
+    { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E },   // 1
+    { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F },   // 2
+    { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E },   // 3
+    { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 },   // 4
+    { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E },   // 5
+    { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E },   // 6
+    { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 },   // 7
+    { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E },   // 8
+    { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C },   // 9
+    { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 },   // :
+    { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08 },   // ;
+    { 0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02 },   // <
+    { 0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00 },   // =
+    { 0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08 },   // >
+    { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04 },   // ?
+    { 0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E },   // @
+    { 0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 },   // A
+    { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E },   // B
+    { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E },   // C
+    { 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C },   // D
+    { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F },   // E
+    { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 },   // F
+    { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F },   // G
+    { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 },   // H
+    { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E },   // I
+    { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C },   // J
+    { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 },   // K
+    { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F },   // L
+    { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 },   // M
+    { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 },   // N
+    { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E },   // O
+    { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 },   // P
+    { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D },   // Q
+    { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 },   // R
+    { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E },   // S
+    { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 },   // T
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E },   // U
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 },   // V
+    { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A },   // W
+    { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 },   // X
+    { 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04, 0x04 },   // Y
+    { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F },   // Z
+    { 0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E },   // [
+    { 0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00 },   // backslash
+    { 0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E },   // ]
+    { 0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00 },   // ^
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F },   // _
+    { 0x08, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00 },   // `
+    { 0x00, 0x00, 0x0E, 0x01, 0x0F, 0x11, 0x0F },   // a
+    { 0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x1E },   // b
+    { 0x00, 0x00, 0x0E, 0x10, 0x10, 0x11, 0x0E },   // c
+    { 0x01, 0x01, 0x0D, 0x13, 0x11, 0x11, 0x0F },   // d
+    { 0x00, 0x00, 0x0E, 0x11, 0x1F, 0x10, 0x0E },   // e
+    { 0x06, 0x09, 0x08, 0x1C, 0x08, 0x08, 0x08 },   // f
+    { 0x00, 0x0F, 0x11, 0x11, 0x0F, 0x01, 0x0E },   // g
+    { 0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x11 },   // h
+    { 0x04, 0x00, 0x0C, 0x04, 0x04, 0x04, 0x0E },   // i
+    { 0x02, 0x00, 0x06, 0x02, 0x02, 0x12, 0x0C },   // j
+    { 0x10, 0x10, 0x12, 0x14, 0x18, 0x14, 0x12 },   // k
+    { 0x0C, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E },   // l
+    { 0x00, 0x00, 0x1A, 0x15, 0x15, 0x11, 0x11 },   // m
+    { 0x00, 0x00, 0x16, 0x19, 0x11, 0x11, 0x11 },   // n
+    { 0x00, 0x00, 0x0E, 0x11, 0x11, 0x11, 0x0E },   // o
+    { 0x00, 0x00, 0x1E, 0x11, 0x1E, 0x10, 0x10 },   // p
+    { 0x00, 0x00, 0x0D, 0x13, 0x0F, 0x01, 0x01 },   // q
+    { 0x00, 0x00, 0x16, 0x19, 0x10, 0x10, 0x10 },   // r
+    { 0x00, 0x00, 0x0E, 0x10, 0x0E, 0x01, 0x1E },   // s
+    { 0x08, 0x08, 0x1C, 0x08, 0x08, 0x09, 0x06 },   // t
+    { 0x00, 0x00, 0x11, 0x11, 0x11, 0x13, 0x0D },   // u
+    { 0x00, 0x00, 0x11, 0x11, 0x11, 0x0A, 0x04 },   // v
+    { 0x00, 0x00, 0x11, 0x11, 0x15, 0x15, 0x0A },   // w
+    { 0x00, 0x00, 0x11, 0x0A, 0x04, 0x0A, 0x11 },   // x
+    { 0x00, 0x00, 0x11, 0x11, 0x0F, 0x01, 0x0E },   // y
+    { 0x00, 0x00, 0x1F, 0x02, 0x04, 0x08, 0x1F },   // z
+    { 0x02, 0x04, 0x04, 0x08, 0x04, 0x04, 0x02 },   // {
+    { 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 },   // |
+    { 0x08, 0x04, 0x04, 0x02, 0x04, 0x04, 0x08 },   // }
+    { 0x00, 0x00, 0x08, 0x15, 0x02, 0x00, 0x00 },   // ~
+};
+
+}
+
+BitmapFont::BitmapFont() : device(nullptr), texture(0) {
+}
+
+BitmapFont::~BitmapFont() {
+    if (device && texture) {
+        device->deleteTexture(texture);
+        MemoryStats::add(MemoryCategory::TEXTURES, -static_cast<long long>(ATLAS_WIDTH * ATLAS_HEIGHT * 4));
+    }
+}
+
+bool BitmapFont::initialize(RenderDevice& renderDevice) {
+    device = &renderDevice;
+
+    // Texture rows run bottom to top, so the top glyph row goes highest in its cell
+    std::vector<unsigned char> pixels(ATLAS_WIDTH * ATLAS_HEIGHT * 4, 0);
+    auto setPixel = [&](int x, int y) {
+        unsigned char* pixel = &pixels[(y * ATLAS_WIDTH + x) * 4];
+        pixel[0] = pixel[1] = pixel[2] = pixel[3] = 255;
+    };
+    for (int glyph = 0; glyph < CHAR_COUNT; glyph++) {
+        int cellX = (glyph % COLUMNS) * CELL_SIZE;
+        int cellY = (glyph / COLUMNS) * CELL_SIZE;
+        for (int row = 0; row < GLYPH_HEIGHT; row++) {
+            for (int column = 0; column < GLYPH_WIDTH; column++) {
+                if (GLYPHS[glyph][row] & (1 << (GLYPH_WIDTH - 1 - column))) {
+                    setPixel(cellX + column, cellY + GLYPH_HEIGHT - 1 - row);
+                }
+            }
+        }
+    }
+    int solidX = (SOLID_CELL % COLUMNS) * CELL_SIZE;
+    int solidY = (SOLID_CELL / COLUMNS) * CELL_SIZE;
+    for (int y = 0; y < CELL_SIZE; y++) {
+        for (int x = 0; x < CELL_SIZE; x++) {
+            setPixel(solidX + x, solidY + y);
+        }
+    }
+
+    texture = device->createTexture(ATLAS_WIDTH, ATLAS_HEIGHT, pixels.data());
+    if (texture == 0) {
+        LOG_ERROR("Failed to create font texture");
+        return false;
+    }
+    MemoryStats::add(MemoryCategory::TEXTURES, ATLAS_WIDTH * ATLAS_HEIGHT * 4);
+    return true;
+}
+
+glm::vec2 BitmapFont::getSolidTexCoord() const {
+    float x = (SOLID_CELL % COLUMNS) * CELL_SIZE + CELL_SIZE * 0.5f;
+    float y = (SOLID_CELL / COLUMNS) * CELL_SIZE + CELL_SIZE * 0.5f;
+    return glm::vec2(x / ATLAS_WIDTH, y / ATLAS_HEIGHT);
+}
+
+template <typename Visit>
+void BitmapFont::forEachGlyph(const char* text, float scale, Visit visit) const {
+    float penX = 0.0f, penY = 0.0f;
+    for (const char* c = text; *c; c++) {
+        if (*c == '\n') {
+            penX = 0.0f;
+            penY -= LINE_HEIGHT * scale;
+            continue;
+        }
+        int glyph = static_cast<unsigned char>(*c) - FIRST_CHAR;
+        if (glyph < 0 || glyph >= CHAR_COUNT) glyph = '?' - FIRST_CHAR;
+        if (glyph != 0) {
+            float u0 = static_cast<float>((glyph % COLUMNS) * CELL_SIZE) / ATLAS_WIDTH;
+            float v0 = static_cast<float>((glyph / COLUMNS) * CELL_SIZE) / ATLAS_HEIGHT;
+            visit(penX, penY, u0, v0, u0 + static_cast<float>(GLYPH_WIDTH) / ATLAS_WIDTH,
+                  v0 + static_cast<float>(GLYPH_HEIGHT) / ATLAS_HEIGHT);
+        }
+        penX += ADVANCE * scale;
+    }
+}
+
+float BitmapFont::measure(const char* text, float scale) const {
+    int longest = 0, current = 0;
+    for (const char* c = text; *c; c++) {
+        current = *c == '\n' ? 0 : current + 1;
+        if (current > longest) longest = current;
+    }
+    // The last glyph has no gap after it
+    return longest > 0 ? (longest * ADVANCE - (ADVANCE - GLYPH_WIDTH)) * scale : 0.0f;
+}
+
+void BitmapFont::addText(QuadBatch& batch, const char* text, float x, float y, const glm::vec4& color,
+                         float scale) const {
+    forEachGlyph(text, scale, [&](float glyphX, float glyphY, float u0, float v0, float u1, float v1) {
+        batch.addQuad(x + glyphX, y + glyphY, GLYPH_WIDTH * scale, GLYPH_HEIGHT * scale, color, u0, v0, u1, v1);
+    });
+}
+
+void BitmapFont::layout(const char* text, const glm::vec4& color, float scale, TextLayout& out) const {
+    out.vertices.clear();
+    out.quadCount = 0;
+    forEachGlyph(text, scale, [&](float glyphX, float glyphY, float u0, float v0, float u1, float v1) {
+        size_t start = out.vertices.size();
+        out.vertices.resize(start + QuadBatch::FLOATS_PER_QUAD);
+        QuadBatch::writeQuad(&out.vertices[start], glyphX, glyphY, GLYPH_WIDTH * scale, GLYPH_HEIGHT * scale,
+                             color, u0, v0, u1, v1);
+        out.quadCount++;
+    });
+    out.width = measure(text, scale);
+}
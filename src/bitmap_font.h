@@ -0,0 +1,63 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include "quad_batch.h"
+#include "render_device.h"
+
+// Quads of a string laid out once, for labels drawn every frame
+struct TextLayout {
+    std::vector<float> vertices;   // QuadBatch format, origin at the bottom left of the first line
+    int quadCount = 0;
+    float width = 0.0f;
+};
+
+/**
+ * BitmapFont is a built-in 5x7 pixel font for printable ASCII, baked at
+ * startup into a 128x48 texture of 8x8 cells (white, coverage in alpha).
+ * Text is emitted as textured quads into a QuadBatch, so any amount of text
+ * drawn between texture changes costs a single draw. One cell is solid, so
+ * plain rectangles can share the texture (and the draw) via getSolidTexCoord().
+ *
+ * Positions are pixels with the origin at the bottom left of the first line;
+ * '\n' starts a new line below. Integer scales keep the glyphs crisp.
+ */
+class BitmapFont {
+public:
+    static const int GLYPH_WIDTH = 5;
+    static const int GLYPH_HEIGHT = 7;
+    static const int ADVANCE = 6;        // Pixels per character at scale 1
+    static const int LINE_HEIGHT = 9;    // Pixels per line at scale 1
+
+    BitmapFont();
+    ~BitmapFont();
+
+    BitmapFont(const BitmapFont&) = delete;
+    BitmapFont& operator=(const BitmapFont&) = delete;
+
+    // Bake the atlas and upload it (call after the graphics context is ready)
+    bool initialize(RenderDevice& device);
+
+    unsigned int getTexture() const { return texture; }
+
+    // Texture coordinate inside the solid cell
+    glm::vec2 getSolidTexCoord() const;
+
+    // Width in pixels of the longest line
+    float measure(const char* text, float scale = 1.0f) const;
+
+    // Append quads for a string; the batch should have getTexture() set
+    void addText(QuadBatch& batch, const char* text, float x, float y, const glm::vec4& color,
+                 float scale = 1.0f) const;
+
+    // Lay a string out once; draw it with batch.addQuads(layout.vertices.data(), layout.quadCount, x, y)
+    void layout(const char* text, const glm::vec4& color, float scale, TextLayout& out) const;
+
+private:
+    // Visit the glyph quads of a string: visit(x, y, u0, v0, u1, v1), origin at 0, 0
+    template <typename Visit>
+    void forEachGlyph(const char* text, float scale, Visit visit) const;
+
+    RenderDevice* device;          // Set by initialize()
+    unsigned int texture;
+};
@@ -1,7 +1,7 @@
 #include "block_database.h"
 
-std::map<BlockType, std::string> BlockDatabase::blockNames;
-std::map<BlockType, std::string> BlockDatabase::blockDescriptions;
+std::map<BlockType, const char*> BlockDatabase::blockNames;
+std::map<BlockType, const char*> BlockDatabase::blockDescriptions;
 bool BlockDatabase::initialized = false;
 
 void BlockDatabase::initialize() {
@@ -46,7 +46,7 @@ void BlockDatabase::initialize() {
     initialized = true;
 }
 
-std::string BlockDatabase::getBlockName(BlockType blockType) {
+const char* BlockDatabase::getBlockName(BlockType blockType) {
     initialize();
     auto it = blockNames.find(blockType);
     if (it != blockNames.end()) {
@@ -55,7 +55,7 @@ std::string BlockDatabase::getBlockName(BlockType blockType) {
     return "Unknown Block";
 }
 
-std::string BlockDatabase::getBlockDescription(BlockType blockType) {
+const char* BlockDatabase::getBlockDescription(BlockType blockType) {
     initialize();
     auto it = blockDescriptions.find(blockType);
     if (it != blockDescriptions.end()) {
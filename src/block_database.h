@@ -6,14 +6,15 @@
 
 class BlockDatabase {
 public:
-    static std::string getBlockName(BlockType blockType);
-    static std::string getBlockDescription(BlockType blockType);
+    // Static strings, so lookups never allocate
+    static const char* getBlockName(BlockType blockType);
+    static const char* getBlockDescription(BlockType blockType);
     static bool isBlockSolid(BlockType blockType);
     static bool isBlockTransparent(BlockType blockType);
     
 private:
-    static std::map<BlockType, std::string> blockNames;
-    static std::map<BlockType, std::string> blockDescriptions;
+    static std::map<BlockType, const char*> blockNames;
+    static std::map<BlockType, const char*> blockDescriptions;
     static bool initialized;
     static void initialize();
 };
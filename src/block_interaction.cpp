@@ -1,8 +1,8 @@
 #include "block_interaction.h"
-#include <iostream>
+#include "log.h"
+#include "profiler.h"
 #include <cmath>
 #include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
 
 // Highlight shader sources
 const char* highlightVertexShader = R"(
@@ -10,11 +10,16 @@ const char* highlightVertexShader = R"(
 layout (location = 0) in vec3 aPos;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+layout(std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 cameraPosition;
+};
 
 void main() {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = viewProjection * model * vec4(aPos, 1.0);
 }
 )";
 
@@ -28,35 +33,40 @@ void main() {
 )";
 
 BlockInteraction::BlockInteraction() {
-    highlightVAO = 0;
-    highlightVBO = 0;
-    highlightEBO = 0;
+    device = nullptr;
+    highlightMesh = 0;
     highlightShaderProgram = 0;
+    highlightModelLocation = -1;
 }
 
-bool BlockInteraction::initialize() {
+bool BlockInteraction::initialize(RenderDevice& renderDevice) {
+    device = &renderDevice;
+    
     // Create highlight shader
-    highlightShaderProgram = createHighlightShader();
+    highlightShaderProgram = device->createProgram(highlightVertexShader, highlightFragmentShader);
     if (highlightShaderProgram == 0) {
-        std::cerr << "Failed to create highlight shader" << std::endl;
+        LOG_ERROR("Failed to create highlight shader");
         return false;
     }
+    highlightModelLocation = device->getUniformLocation(highlightShaderProgram, "model");
     
     // Initialize highlight rendering
     initializeHighlight();
     
-    std::cout << "Block interaction system initialized" << std::endl;
+    LOG_INFO("Block interaction system initialized");
     return true;
 }
 
 void BlockInteraction::cleanup() {
-    if (highlightVAO) glDeleteVertexArrays(1, &highlightVAO);
-    if (highlightVBO) glDeleteBuffers(1, &highlightVBO);
-    if (highlightEBO) glDeleteBuffers(1, &highlightEBO);
-    if (highlightShaderProgram) glDeleteProgram(highlightShaderProgram);
+    if (!device) return;
+    if (highlightMesh) device->deleteMesh(highlightMesh);
+    if (highlightShaderProgram) device->deleteProgram(highlightShaderProgram);
+    highlightMesh = 0;
+    highlightShaderProgram = 0;
 }
 
 RaycastHit BlockInteraction::raycastToBlock(const Camera& camera, ChunkManager& chunkManager, float maxDistance) {
+    PROFILE_SCOPE("BlockInteraction::raycastToBlock");
     RaycastHit hit;
     
     glm::vec3 rayOrigin = camera.position;
@@ -183,30 +193,24 @@ glm::vec3 BlockInteraction::getPlacementPosition(const RaycastHit& hit) {
     return hit.blockPosition + hit.normal;
 }
 
-void BlockInteraction::renderBlockHighlight(const RaycastHit& hit, GLuint shaderProgram, 
-                                           const glm::mat4& view, const glm::mat4& projection) {
-    if (!hit.hit) return;
+void BlockInteraction::renderBlockHighlight(const RaycastHit& hit) {
+    if (!hit.hit || !device) return;
     
-    glUseProgram(highlightShaderProgram);
+    device->useProgram(highlightShaderProgram);
     
     // Set up matrices
     glm::mat4 model = glm::translate(glm::mat4(1.0f), hit.blockPosition);
     model = glm::scale(model, glm::vec3(1.01f)); // Slightly larger than block to avoid z-fighting
     
-    glUniformMatrix4fv(glGetUniformLocation(highlightShaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(model));
-    glUniformMatrix4fv(glGetUniformLocation(highlightShaderProgram, "view"), 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(glGetUniformLocation(highlightShaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+    device->setUniform(highlightModelLocation, model);
     
     // Render wireframe highlight
-    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-    glLineWidth(2.0f);
+    device->setWireframe(true, 2.0f);
     
-    glBindVertexArray(highlightVAO);
-    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    device->drawMesh(highlightMesh, PrimitiveType::TRIANGLES, 36);
     
     // Reset polygon mode
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    device->setWireframe(false);
 }
 
 bool BlockInteraction::testBlockAt(const glm::vec3& worldPos, ChunkManager& chunkManager) {
@@ -233,54 +237,6 @@ glm::vec3 BlockInteraction::calculateFaceNormal(const glm::vec3& rayDir, const g
     }
 }
 
-GLuint BlockInteraction::createHighlightShader() {
-    // Compile vertex shader
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &highlightVertexShader, NULL);
-    glCompileShader(vertexShader);
-    
-    // Check for compilation errors
-    int success;
-    char infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cerr << "Highlight vertex shader compilation failed: " << infoLog << std::endl;
-        return 0;
-    }
-    
-    // Compile fragment shader
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &highlightFragmentShader, NULL);
-    glCompileShader(fragmentShader);
-    
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cerr << "Highlight fragment shader compilation failed: " << infoLog << std::endl;
-        return 0;
-    }
-    
-    // Create shader program
-    GLuint shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-    
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cerr << "Highlight shader program linking failed: " << infoLog << std::endl;
-        return 0;
-    }
-    
-    // Clean up shaders
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-    
-    return shaderProgram;
-}
-
 void BlockInteraction::initializeHighlight() {
     // Cube vertices for highlighting
     float vertices[] = {
@@ -307,20 +263,8 @@ void BlockInteraction::initializeHighlight() {
         20, 21, 22,  22, 23, 20   // top
     };
     
-    glGenVertexArrays(1, &highlightVAO);
-    glGenBuffers(1, &highlightVBO);
-    glGenBuffers(1, &highlightEBO);
-    
-    glBindVertexArray(highlightVAO);
-    
-    glBindBuffer(GL_ARRAY_BUFFER, highlightVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, highlightEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-    
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    
-    glBindVertexArray(0);
+    VertexLayout layout = { { 3, 0, 0, 0 }, 1 };
+    highlightMesh = device->createMesh(layout);
+    device->updateMesh(highlightMesh, vertices, sizeof(vertices) / sizeof(float),
+                       indices, sizeof(indices) / sizeof(unsigned int), BufferUsage::STATIC);
 }
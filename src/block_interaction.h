@@ -1,9 +1,9 @@
 #pragma once
 
-#include <glad/gl.h>
 #include <glm/glm.hpp>
 #include "camera.h"
 #include "chunk_manager.h"
+#include "render_device.h"
 #include "voxel_chunk.h"
 
 struct RaycastHit {
@@ -31,12 +31,11 @@ public:
     // Get the position where a new block should be placed (adjacent to hit block)
     glm::vec3 getPlacementPosition(const RaycastHit& hit);
     
-    // Highlight the currently targeted block
-    void renderBlockHighlight(const RaycastHit& hit, GLuint shaderProgram, 
-                             const glm::mat4& view, const glm::mat4& projection);
+    // Highlight the currently targeted block (camera from the camera uniform buffer)
+    void renderBlockHighlight(const RaycastHit& hit);
     
-    // Initialize highlighting system
-    bool initialize();
+    // Initialize highlighting system (raycasts and edits work without it)
+    bool initialize(RenderDevice& device);
     
     // Cleanup
     void cleanup();
@@ -48,12 +47,11 @@ private:
     // Get the face normal based on ray direction and hit position
     glm::vec3 calculateFaceNormal(const glm::vec3& rayDir, const glm::vec3& blockPos, const glm::vec3& hitPos);
     
-    // OpenGL objects for block highlighting
-    GLuint highlightVAO, highlightVBO, highlightEBO;
-    GLuint highlightShaderProgram;
-    
-    // Create highlight shader
-    GLuint createHighlightShader();
+    // GPU objects for block highlighting
+    RenderDevice* device;          // Set by initialize()
+    MeshHandle highlightMesh;
+    unsigned int highlightShaderProgram;
+    UniformLocation highlightModelLocation;
     
     // Initialize highlight rendering
     void initializeHighlight();
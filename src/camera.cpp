@@ -30,46 +30,41 @@ glm::mat4 Camera::getViewMatrix() {
 
 // ============================================================================
 // PROCESS KEYBOARD INPUT FOR CAMERA MOVEMENT
-// Handles WASD movement, QE for vertical movement, and ESC to close window
+// Handles WASD movement and QE for vertical movement
 // ============================================================================
-void Camera::processKeyboard(GLFWwindow* window, float deltaTime) {
+void Camera::processKeyboard(const MovementInput& input, float deltaTime) {
     // Calculate movement speed based on frame time for smooth movement
     float velocity = movementSpeed * deltaTime;
 
     // Forward movement (W key)
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) {
+    if (input.forward) {
         position += front * velocity;
     }
     
     // Backward movement (S key)
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
+    if (input.backward) {
         position -= front * velocity;
     }
     
     // Left strafe movement (A key)
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) {
+    if (input.left) {
         position -= right * velocity;
     }
     
     // Right strafe movement (D key)
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) {
+    if (input.right) {
         position += right * velocity;
     }
     
     // Upward movement (Q key)
-    if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS) {
+    if (input.up) {
         position -= up * velocity;
     }
     
     // Downward movement (E key)
-    if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS) {
+    if (input.down) {
         position += up * velocity;
     }
-    
-    // Exit application (ESC key)
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
-        glfwSetWindowShouldClose(window, true);
-    }
 }
 
 // ============================================================================
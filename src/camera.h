@@ -1,10 +1,22 @@
 #pragma once
 
-#include <glad/gl.h>
-#include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+/**
+ * Movement keys held this frame. The window layer fills it in, so the camera
+ * and player never talk to GLFW and also run headless.
+ */
+struct MovementInput {
+    bool forward = false;   // W
+    bool backward = false;  // S
+    bool left = false;      // A
+    bool right = false;     // D
+    bool up = false;        // Q (free camera) / Space (player jump)
+    bool down = false;      // E (free camera)
+    bool sprint = false;    // Left Shift
+};
+
 /**
  * Camera class for handling first-person camera movement and mouse look
  * Provides WASD movement, QE for up/down, and mouse look functionality
@@ -56,7 +68,7 @@ public:
     // ============================================================================
     // INPUT PROCESSING METHODS
     // ============================================================================
-    void processKeyboard(GLFWwindow* window, float deltaTime);
+    void processKeyboard(const MovementInput& input, float deltaTime);
     void processMouseMovement(double xpos, double ypos);
 
     // ============================================================================
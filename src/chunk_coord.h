@@ -0,0 +1,28 @@
+#pragma once
+
+#include <functional>
+
+// Hash function for chunk coordinates
+struct ChunkCoord {
+    int x, z;
+    
+    ChunkCoord(int x, int z) : x(x), z(z) {}
+    
+    bool operator==(const ChunkCoord& other) const {
+        return x == other.x && z == other.z;
+    }
+    
+    // Distance calculation for sorting
+    float distanceSquared(const ChunkCoord& other) const {
+        float dx = x - other.x;
+        float dz = z - other.z;
+        return dx * dx + dz * dz;
+    }
+};
+
+// Custom hash function for ChunkCoord
+struct ChunkCoordHash {
+    std::size_t operator()(const ChunkCoord& coord) const {
+        return std::hash<int>()(coord.x) ^ (std::hash<int>()(coord.z) << 1);
+    }
+};
@@ -1,167 +1,347 @@
 #include "chunk_manager.h"
+#include "log.h"
+#include "memory_stats.h"
+#include "profiler.h"
 #include <algorithm>
-#include <iostream>
 #include <cmath>
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
 
-ChunkManager::ChunkManager() 
+namespace {
+
+// Super-chunk region holding a chunk
+ChunkCoord toSuperChunkRegion(const ChunkCoord& coord) {
+    const int size = SuperChunkMesh::SIZE;
+    auto floorDiv = [](int value) { return value >= 0 ? value / size : -((-value + size - 1) / size); };
+    return ChunkCoord(floorDiv(coord.x), floorDiv(coord.z));
+}
+
+}
+
+ChunkManager::ChunkManager(RenderDevice& device) 
     : lastPlayerChunk(0, 0)
+    , loadRadius(LOAD_DISTANCE)
     , lastRenderedCount(0)
-{    // Initialize enhanced noise generators for realistic terrain
-    heightNoise.SetSeed(12345);
-    heightNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-    heightNoise.SetFrequency(0.006f);  // Even smoother base terrain
-    heightNoise.SetFractalType(FastNoiseLite::FractalType_FBm);
-    heightNoise.SetFractalOctaves(6);  // More detail layers
-    heightNoise.SetFractalLacunarity(2.0f);
-    heightNoise.SetFractalGain(0.5f);
-    
-    // Enhanced cave generation
-    caveNoise.SetSeed(54321);
-    caveNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-    caveNoise.SetFrequency(0.03f);
-    caveNoise.SetFractalType(FastNoiseLite::FractalType_FBm);
-    caveNoise.SetFractalOctaves(3);
-    
-    // Large-scale biome distribution
-    biomeNoise.SetSeed(99999);
-    biomeNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-    biomeNoise.SetFrequency(0.0025f);  // Even larger biome regions
-    
-    // Climate system with fractal detail
-    temperatureNoise.SetSeed(11111);
-    temperatureNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-    temperatureNoise.SetFrequency(0.003f);
-    temperatureNoise.SetFractalType(FastNoiseLite::FractalType_FBm);
-    temperatureNoise.SetFractalOctaves(3);
-    
-    humidityNoise.SetSeed(22222);
-    humidityNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-    humidityNoise.SetFrequency(0.0035f);
-    humidityNoise.SetFractalType(FastNoiseLite::FractalType_FBm);
-    humidityNoise.SetFractalOctaves(3);
-    
-    // Mountain ridge generation
-    ridgeNoise.SetSeed(33333);
-    ridgeNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-    ridgeNoise.SetFrequency(0.004f);
-    ridgeNoise.SetFractalType(FastNoiseLite::FractalType_Ridged);
-    ridgeNoise.SetFractalOctaves(4);
-    
-    // Erosion patterns for realistic terrain
-    erosionNoise.SetSeed(44444);
-    erosionNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-    erosionNoise.SetFrequency(0.015f);
-    erosionNoise.SetFractalType(FastNoiseLite::FractalType_FBm);
-    erosionNoise.SetFractalOctaves(2);
-    
-    // Vegetation density
-    vegetationNoise.SetSeed(55555);
-    vegetationNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-    vegetationNoise.SetFrequency(0.02f);
-    
-    std::cout << "ChunkManager initialized with procedural terrain generation" << std::endl;
+    , lastCulledCount(0)
+    , lastOccludedCount(0)
+    , lastLoadedCount(0)
+    , lastGeneratedCount(0)
+    , lastMeshBuildCount(0)
+    , lastWaterSortCount(0)
+    , lastSuperChunkDrawCount(0)
+    , device(device)
+    , farTerrain(terrainGenerator, RENDER_DISTANCE, device)
+    , ringCenter(0, 0)
+    , ringsValid(false)
+    , caveCulling(true)
+    , occlusionCulling(true)
+    , activeSuperChunks(0)
+{
+    // Coarse-lattice cave/ore noise: much cheaper chunk loads, visually equivalent caves
+    terrainGenerator.setInterpolatedCaves(true);
+    
+    // Sized for everything inside the unload distance, so streaming never rehashes
+    const int maxLoaded = (2 * UNLOAD_DISTANCE + 1) * (2 * UNLOAD_DISTANCE + 1);
+    loadedChunks.reserve(maxLoaded);
+    chunkMeshes.reserve(maxLoaded);
+    chunksInRange.reserve((2 * LOAD_DISTANCE + 1) * (2 * LOAD_DISTANCE + 1));
+    pendingChunks.reserve((2 * LOAD_DISTANCE + 1) * (2 * LOAD_DISTANCE + 1));
+    chunksToUnload.reserve(maxLoaded);
+    
+    // Every ring sized for all the chunk positions at its distance
+    std::vector<int> ringSizes(RENDER_DISTANCE * RENDER_DISTANCE + 1, 0);
+    for (int dx = -RENDER_DISTANCE; dx <= RENDER_DISTANCE; dx++) {
+        for (int dz = -RENDER_DISTANCE; dz <= RENDER_DISTANCE; dz++) {
+            if (dx * dx + dz * dz <= RENDER_DISTANCE * RENDER_DISTANCE) {
+                ringSizes[dx * dx + dz * dz]++;
+            }
+        }
+    }
+    renderRings.resize(ringSizes.size());
+    for (size_t i = 0; i < ringSizes.size(); i++) {
+        renderRings[i].reserve(ringSizes[i]);
+    }
+    waterDraws.reserve((2 * RENDER_DISTANCE + 1) * (2 * RENDER_DISTANCE + 1));
+    
+    const int gridSide = 2 * RENDER_DISTANCE + 1;
+    chunkGrid.resize(gridSide * gridSide);
+    visibilityEntries.resize(gridSide * gridSide * VoxelChunk::SECTION_COUNT);
+    visibleChunks.resize(gridSide * gridSide);
+    mergedChunks.resize(gridSide * gridSide);
+    visibilityQueue.reserve(gridSide * gridSide * VoxelChunk::SECTION_COUNT * (VoxelChunk::FACE_COUNT + 1));
+    chunkPool.reserve(MAX_POOLED_CHUNKS);
+    meshBufferPool.reserve(MAX_POOLED_CHUNKS);
+    
+    // As many super-chunk meshes as regions can fit the band around any center
+    size_t maxRegions = 0;
+    for (int x = 0; x < SuperChunkMesh::SIZE; x++) {
+        for (int z = 0; z < SuperChunkMesh::SIZE; z++) {
+            getSuperChunkRegions(ChunkCoord(x, z), superChunkRegions);
+            maxRegions = std::max(maxRegions, superChunkRegions.size());
+        }
+    }
+    superChunkRegions.reserve(maxRegions);
+    superChunks.reserve(maxRegions);
+    for (size_t i = 0; i < maxRegions; i++) {
+        superChunks.push_back(std::make_unique<SuperChunkMesh>(device));
+    }
+    LOG_INFO("ChunkManager initialized with procedural terrain generation");
 }
 
 ChunkManager::~ChunkManager() {
-    loadedChunks.clear();    std::cout << "ChunkManager destroyed" << std::endl;
+    chunkMeshes.clear();
+    loadedChunks.clear();
+    chunkPool.clear();
+    meshBufferPool.clear();
+    updateMemoryStats();
+    LOG_INFO("ChunkManager destroyed");
+}
+
+void ChunkManager::shutdown() {
+    for (auto& ring : renderRings) {
+        ring.clear();
+    }
+    std::fill(chunkGrid.begin(), chunkGrid.end(), nullptr);
+    ringsValid = false;
+    waterDraws.clear();
+    chunkMeshes.clear();
+    meshBufferPool.clear();
+    activeSuperChunks = 0;
+    superChunks.clear();
+    farTerrain.clear();
+    updateMemoryStats();
+}
+
+bool ChunkManager::openWorldCache(const std::string& path) {
+    if (!worldCache.open(path, terrainGenerator)) {
+        return false;
+    }
+    LOG_INFO("Using world cache " << path << " (" << worldCache.getChunkCount() << " chunks)");
+    return true;
 }
 
 void ChunkManager::initialize(const glm::vec3& playerPosition) {
-    // Load initial chunks around player spawn position
+    // Only the chunks right around the player block the first frame
     ChunkCoord playerChunk = worldToChunkCoord(playerPosition);
-    std::cout << "Loading initial chunks around player position (" << playerChunk.x << ", " << playerChunk.z << ")..." << std::endl;
+    LOG_INFO("Loading spawn chunks around player position (" << playerChunk.x << ", " << playerChunk.z << ")...");
     
-    std::vector<ChunkCoord> initialChunks = getChunksInRange(playerChunk, LOAD_DISTANCE);
-    for (const auto& coord : initialChunks) {
+    getChunksInRange(playerChunk, SPAWN_RADIUS, chunksInRange);
+    size_t spawnCount = chunksInRange.size();
+    for (const auto& coord : chunksInRange) {
         loadChunk(coord);
     }
-      lastPlayerChunk = playerChunk;
-    std::cout << "Loaded " << initialChunks.size() << " initial chunks" << std::endl;
+    
+    queueMissingChunks(playerChunk);
+    lastPlayerChunk = playerChunk;
+    LOG_INFO("Loaded " << spawnCount << " spawn chunks, streaming "
+              << pendingChunks.size() << " more");
 }
 
 void ChunkManager::update(const glm::vec3& playerPosition) {
+    PROFILE_SCOPE("ChunkManager::update");
     ChunkCoord currentPlayerChunk = worldToChunkCoord(playerPosition);
     
     // Only update chunks if player moved to a different chunk
     if (!(currentPlayerChunk == lastPlayerChunk)) {
-        std::cout << "Player moved to chunk (" << currentPlayerChunk.x << ", " << currentPlayerChunk.z << ")" << std::endl;
-        
-        // Clear temporary arrays
-        chunksToLoad.clear();
-        chunksToUnload.clear();
-        
-        // Find chunks that should be loaded
-        std::vector<ChunkCoord> requiredChunks = getChunksInRange(currentPlayerChunk, LOAD_DISTANCE);
-        
-        // Find chunks to load (required but not loaded)
-        for (const auto& coord : requiredChunks) {
-            if (loadedChunks.find(coord) == loadedChunks.end()) {
-                chunksToLoad.push_back(coord);
-            }
-        }
+        LOG_DEBUG("Player moved to chunk (" << currentPlayerChunk.x << ", " << currentPlayerChunk.z << ")");
         
         // Find chunks to unload (too far from player)
+        int unloadDistance = loadRadius + (UNLOAD_DISTANCE - LOAD_DISTANCE);
+        chunksToUnload.clear();
         for (const auto& pair : loadedChunks) {
             const ChunkCoord& coord = pair.first;
             float distSq = coord.distanceSquared(currentPlayerChunk);
-            if (distSq > UNLOAD_DISTANCE * UNLOAD_DISTANCE) {
+            if (distSq > unloadDistance * unloadDistance) {
                 chunksToUnload.push_back(coord);
             }
         }
         
-        // Load new chunks
-        for (const auto& coord : chunksToLoad) {
-            loadChunk(coord);
-        }
-        
         // Unload distant chunks
         for (const auto& coord : chunksToUnload) {
             unloadChunk(coord);
         }
         
-        if (!chunksToLoad.empty() || !chunksToUnload.empty()) {
-            std::cout << "Loaded " << chunksToLoad.size() << " chunks, unloaded " 
-                      << chunksToUnload.size() << " chunks. Total: " << loadedChunks.size() << std::endl;
+        // Requeue what is missing around the new position, nearest first
+        queueMissingChunks(currentPlayerChunk);
+        
+        if (!pendingChunks.empty() || !chunksToUnload.empty()) {
+            LOG_DEBUG("Queued " << pendingChunks.size() << " chunks, unloaded " 
+                      << chunksToUnload.size() << " chunks. Total: " << loadedChunks.size());
         }
         
         lastPlayerChunk = currentPlayerChunk;
     }
+    
+    loadPendingChunks();
+    
+    updateMemoryStats();
+    enforceMemoryBudgets(currentPlayerChunk);
+    
+    // Stream in the distant horizon a few tiles at a time
+    farTerrain.update(playerPosition);
 }
 
 void ChunkManager::render(unsigned int shaderProgram, const glm::vec3& playerPosition,
                          const glm::mat4& view, const glm::mat4& projection) {
+    PROFILE_SCOPE("ChunkManager::render");
     ChunkCoord playerChunk = worldToChunkCoord(playerPosition);
     
-    // Set up matrices
-    glUseProgram(shaderProgram);
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+    device.useProgram(shaderProgram);
+    UniformLocation modelLocation = device.getUniformLocation(shaderProgram, "model");
     
-    // Clear render list
-    chunksToRender.clear();
+    // The render set only changes with the player's chunk and with loads/unloads
+    if (!ringsValid || !(playerChunk == ringCenter)) {
+        rebuildRenderRings(playerChunk);
+    }
     
-    // Collect chunks to render and sort by distance
-    for (const auto& pair : loadedChunks) {
-        const ChunkCoord& coord = pair.first;
-        if (shouldRenderChunk(coord, playerPosition)) {
-            chunksToRender.emplace_back(coord, pair.second.get());
-        }
+    // Above the world every chunk top is in view, so the walk would find them all
+    bool culling = caveCulling && playerPosition.y < VoxelChunk::CHUNK_SIZE;
+    if (culling) {
+        PROFILE_SCOPE("ChunkManager::findVisibleChunks");
+        findVisibleChunks(playerChunk, playerPosition.y);
     }
     
-    // Sort chunks by distance to player (closest first for better depth testing)
-    std::sort(chunksToRender.begin(), chunksToRender.end(),
-              [&playerChunk](const auto& a, const auto& b) {
-                  return a.first.distanceSquared(playerChunk) < b.first.distanceSquared(playerChunk);
-              });
+    if (occlusionCulling) {
+        PROFILE_SCOPE("ChunkManager::drawOccluders");
+        drawOccluders(playerChunk, projection * view);
+    }
+    
+    // Face directions are culled per chunk against the eye, not the player
+    glm::vec3 cameraPosition = glm::vec3(glm::inverse(view)[3]);
+    
+    // Draw ring by ring, nearest first for better depth testing, dropping to
+    // coarser meshes with distance
+    lastCulledCount = 0;
+    lastOccludedCount = 0;
+    lastMeshBuildCount = 0;
+    waterDraws.clear();
+    int rendered = 0;
+    int neighborRebuilds = 0;
+    prepareSuperChunks(playerChunk);
+    for (int distSq = 0; distSq < static_cast<int>(renderRings.size()); distSq++) {
+        int lod = getLodForDistance(static_cast<float>(distSq));
+        for (RenderEntry& entry : renderRings[distSq]) {
+            // A super-chunk draws merged chunks, except for their water, which
+            // has to be sorted with the nearer chunks' water
+            MergedState merged = getMergedState(entry.coord, playerChunk);
+            if (merged == MergedState::MERGED) {
+                continue;
+            }
+            bool waterOnly = merged == MergedState::MERGED_WITH_WATER;
+            if (culling && !isChunkVisible(entry.coord, playerChunk)) {
+                if (!waterOnly) lastCulledCount++;
+                continue;
+            }
+            glm::vec3 min(entry.coord.x * VoxelChunk::CHUNK_SIZE, 0.0f, entry.coord.z * VoxelChunk::CHUNK_SIZE);
+            glm::vec3 max = min + glm::vec3(VoxelChunk::CHUNK_SIZE, entry.chunk->getTopHeight(), VoxelChunk::CHUNK_SIZE);
+            if (occlusionCulling && occlusionBuffer.isOccluded(min, max)) {
+                if (!waterOnly) lastOccludedCount++;
+                continue;
+            }
+            
+            // A first mesh waits for the neighbours streaming in around it, so
+            // it doesn't have to be rebuilt for each of them a frame later
+            ChunkNeighbors neighbors = getNeighbors(entry.coord);
+            if (!(entry.buffers && entry.buffers->isBuilt(lod)) && isAwaitingNeighbors(entry.coord, neighbors)) {
+                continue;
+            }
+            
+            if (!entry.buffers) {
+                std::unique_ptr<ChunkMeshBuffers>& buffers = chunkMeshes[entry.coord];
+                if (!buffers) {
+                    if (!meshBufferPool.empty()) {
+                        buffers = std::move(meshBufferPool.back());
+                        meshBufferPool.pop_back();
+                    } else {
+                        buffers = std::make_unique<ChunkMeshBuffers>(device);
+                    }
+                }
+                entry.buffers = buffers.get();
+            }
+            if (neighborRebuilds < MAX_NEIGHBOR_REBUILDS_PER_FRAME &&
+                entry.buffers->getState(*entry.chunk, lod, neighbors) == ChunkMeshBuffers::MeshState::OUTDATED) {
+                entry.buffers->rebuild(*entry.chunk, lod, neighbors, meshScratch, waterScratch);
+                neighborRebuilds++;
+                lastMeshBuildCount++;
+            }
+            if (waterOnly) {
+                if (entry.buffers->getState(*entry.chunk, lod, neighbors) == ChunkMeshBuffers::MeshState::STALE) {
+                    entry.buffers->rebuild(*entry.chunk, lod, neighbors, meshScratch, waterScratch);
+                    lastMeshBuildCount++;
+                }
+            } else {
+                unsigned int faceMask = getFacingDirections(min, max, cameraPosition);
+                if (entry.buffers->render(*entry.chunk, lod, neighbors, modelLocation, faceMask,
+                                          getSkirtMask(entry.coord, lod), meshScratch, waterScratch)) {
+                    lastMeshBuildCount++;
+                }
+                rendered++;
+            }
+            if (entry.buffers->hasWater(lod)) {
+                waterDraws.push_back({ entry.chunk, entry.buffers, lod });
+            }
+        }
+    }
     
-    // Render sorted chunks
-    for (const auto& pair : chunksToRender) {
-        pair.second->render(shaderProgram);
+    // Merged far regions, culled as a whole, after the nearer chunks
+    lastSuperChunkDrawCount = 0;
+    for (int i = 0; i < activeSuperChunks; i++) {
+        SuperChunkMesh& superChunk = *superChunks[i];
+        if (!superChunk.isCurrent()) continue;
+        if (culling) {
+            bool visible = false;
+            for (int member = 0; member < SuperChunkMesh::MEMBER_COUNT && !visible; member++) {
+                visible = superChunk.isMember(member) &&
+                          isChunkVisible(superChunk.getMemberCoord(member), playerChunk);
+            }
+            if (!visible) {
+                lastCulledCount += superChunk.getMemberCount();
+                continue;
+            }
+        }
+        glm::vec3 min = superChunk.getBoundsMin();
+        glm::vec3 max = superChunk.getBoundsMax();
+        if (occlusionCulling && occlusionBuffer.isOccluded(min, max)) {
+            lastOccludedCount += superChunk.getMemberCount();
+            continue;
+        }
+        superChunk.render(modelLocation, getFacingDirections(min, max, cameraPosition));
+        rendered += superChunk.getMemberCount();
+        lastSuperChunkDrawCount++;
     }
+    lastRenderedCount = rendered;
+    
+    // Horizon last so nearby voxel terrain already occupies the depth buffer
+    farTerrain.render(modelLocation);
+}
+
+unsigned int ChunkManager::getFacingDirections(const glm::vec3& min, const glm::vec3& max,
+                                               const glm::vec3& cameraPosition) {
+    // A face is only seen from the side its normal points to, so a direction
+    // is dropped when the camera is behind the bounds' plane on that side: no
+    // face of that direction inside the bounds can face it
+    unsigned int mask = 0;
+    if (cameraPosition.z > min.z) mask |= 1u << 0;   // +Z
+    if (cameraPosition.z < max.z) mask |= 1u << 1;   // -Z
+    if (cameraPosition.x > min.x) mask |= 1u << 2;   // +X
+    if (cameraPosition.x < max.x) mask |= 1u << 3;   // -X
+    if (cameraPosition.y > min.y) mask |= 1u << 4;   // +Y
+    if (cameraPosition.y < max.y) mask |= 1u << 5;   // -Y
+    return mask;
+}
+
+void ChunkManager::renderWater(unsigned int waterProgram, const glm::vec3& cameraPosition) {
+    PROFILE_SCOPE("ChunkManager::renderWater");
+    lastWaterSortCount = 0;
+    if (waterDraws.empty()) return;
     
-    lastRenderedCount = chunksToRender.size();
+    device.useProgram(waterProgram);
+    UniformLocation modelLocation = device.getUniformLocation(waterProgram, "model");
+    // The rings already order the chunks by distance, which is as close as
+    // whole chunks can be sorted; walking them backwards is farthest first
+    for (auto it = waterDraws.rbegin(); it != waterDraws.rend(); ++it) {
+        if (it->buffers->renderWater(*it->chunk, it->lod, modelLocation, cameraPosition, waterSortScratch)) {
+            lastWaterSortCount++;
+        }
+    }
 }
 
 bool ChunkManager::isBlockSolid(const glm::vec3& worldPosition) const {
@@ -230,316 +410,474 @@ ChunkCoord ChunkManager::worldToChunkCoord(float x, float z) const {
     return ChunkCoord(chunkX, chunkZ);
 }
 
-void ChunkManager::loadChunk(const ChunkCoord& coord) {
+bool ChunkManager::loadChunk(const ChunkCoord& coord) {
+    PROFILE_SCOPE("ChunkManager::loadChunk");
     // Don't load if already exists
     if (loadedChunks.find(coord) != loadedChunks.end()) {
-        return;
+        return false;
     }
     
-    // Create new chunk
-    auto chunk = std::make_unique<VoxelChunk>(coord.x, coord.z);    // Generate highly realistic terrain using advanced noise systems
-    for (int x = 0; x < VoxelChunk::CHUNK_SIZE; x++) {
-        for (int z = 0; z < VoxelChunk::CHUNK_SIZE; z++) {
-            float worldX = coord.x * VoxelChunk::CHUNK_SIZE + x;
-            float worldZ = coord.z * VoxelChunk::CHUNK_SIZE + z;
-            
-            // Multi-layered terrain generation
-            float baseHeight = heightNoise.GetNoise(worldX, worldZ);
-            float temperatureValue = temperatureNoise.GetNoise(worldX, worldZ);
-            float humidityValue = humidityNoise.GetNoise(worldX, worldZ);
-            float ridgeValue = ridgeNoise.GetNoise(worldX, worldZ);
-            float erosionValue = erosionNoise.GetNoise(worldX, worldZ);
-            float vegetationValue = vegetationNoise.GetNoise(worldX, worldZ);
-            
-            // Advanced biome determination with realistic climate zones
-            enum BiomeType { 
-                ARCTIC_TUNDRA, BOREAL_FOREST, TEMPERATE_GRASSLANDS, 
-                TEMPERATE_FOREST, MEDITERRANEAN, DESERT, 
-                TROPICAL_GRASSLANDS, TROPICAL_RAINFOREST, ALPINE,
-                COASTAL_PLAINS, RIVER_VALLEY, MOUNTAIN_PEAKS
-            };
-            
-            BiomeType biome;
-            
-            // Realistic biome classification based on Whittaker biome model
-            if (temperatureValue < -0.5f) {
-                biome = ARCTIC_TUNDRA;
-            } else if (temperatureValue < -0.2f) {
-                if (humidityValue > 0.2f) {
-                    biome = BOREAL_FOREST;
-                } else {
-                    biome = ARCTIC_TUNDRA;
-                }
-            } else if (temperatureValue < 0.2f) {
-                if (humidityValue < -0.3f) {
-                    biome = TEMPERATE_GRASSLANDS;
-                } else if (humidityValue > 0.3f) {
-                    biome = TEMPERATE_FOREST;
-                } else {
-                    biome = MEDITERRANEAN;
-                }
-            } else {
-                if (humidityValue < -0.4f) {
-                    biome = DESERT;
-                } else if (humidityValue < 0.0f) {
-                    biome = TROPICAL_GRASSLANDS;
-                } else {
-                    biome = TROPICAL_RAINFOREST;
-                }
-            }
-            
-            // Elevation-based biome modifiers
-            float elevation = baseHeight + ridgeValue * 0.3f;
-            if (elevation > 0.6f) {
-                biome = MOUNTAIN_PEAKS;
-            } else if (elevation > 0.3f && (biome == TEMPERATE_FOREST || biome == BOREAL_FOREST)) {
-                biome = ALPINE;
-            } else if (elevation < -0.3f) {
-                biome = COASTAL_PLAINS;
-            }
-            
-            // River generation using erosion patterns
-            bool isRiver = false;
-            if (erosionValue > 0.4f && erosionValue < 0.5f && elevation > -0.2f && elevation < 0.3f) {
-                isRiver = true;
-                biome = RIVER_VALLEY;
-            }
-            
-            // Calculate realistic height based on biome and geological features
-            int surfaceHeight;
-            switch (biome) {
-                case MOUNTAIN_PEAKS:
-                    surfaceHeight = static_cast<int>((baseHeight * 0.2f + 0.8f) * 15 + ridgeValue * 12 + 15);
-                    break;
-                case ALPINE:
-                    surfaceHeight = static_cast<int>((baseHeight * 0.3f + 0.7f) * 10 + ridgeValue * 6 + 12);
-                    break;
-                case BOREAL_FOREST:
-                case TEMPERATE_FOREST:
-                case TROPICAL_RAINFOREST:
-                    surfaceHeight = static_cast<int>((baseHeight * 0.4f + 0.6f) * 8 + erosionValue * 2 + 8);
-                    break;                case DESERT: {
-                    // Desert dunes with wind erosion patterns
-                    float duneHeight = sin(worldX * 0.02f) * cos(worldZ * 0.015f) * 3.0f;
-                    surfaceHeight = static_cast<int>((baseHeight * 0.3f + 0.7f) * 5 + duneHeight + 6);
-                    break;
-                }
-                case COASTAL_PLAINS:
-                    surfaceHeight = static_cast<int>((baseHeight * 0.2f + 0.8f) * 3 + 4);
-                    break;
-                case RIVER_VALLEY:
-                    surfaceHeight = static_cast<int>((baseHeight * 0.3f + 0.7f) * 4 + 5);
-                    break;
-                case ARCTIC_TUNDRA:
-                    surfaceHeight = static_cast<int>((baseHeight * 0.3f + 0.7f) * 6 + erosionValue + 6);
-                    break;
-                default:
-                    surfaceHeight = static_cast<int>((baseHeight * 0.4f + 0.6f) * 7 + erosionValue * 1.5f + 7);
-                    break;
-            }
-            
-            // Ensure reasonable height limits
-            surfaceHeight = std::clamp(surfaceHeight, 3, 25);
-            
-            // Special case: Water level for rivers and coastal areas
-            int waterLevel = 6; // Sea level
-            if (isRiver || biome == COASTAL_PLAINS) {
-                surfaceHeight = std::max(surfaceHeight, waterLevel);
-            }
-            
-            // Generate terrain layers
-            for (int y = 0; y < VoxelChunk::CHUNK_SIZE; y++) {
-                BlockType blockType = BlockType::AIR;
-                
-                if (y == 0) {
-                    // Bedrock layer
-                    blockType = BlockType::BEDROCK;
-                } else if (y <= surfaceHeight) {
-                    // Check for caves
-                    float caveValue = caveNoise.GetNoise(worldX, y * 2.0f, worldZ);
-                    if (caveValue > 0.45f && y > 1 && y < surfaceHeight - 1) {
-                        blockType = BlockType::AIR; // Cave
-                    } else {
-                        // Generate ore deposits
-                        float oreNoise = caveNoise.GetNoise(worldX * 3.0f, y * 3.0f, worldZ * 3.0f);
-                        bool isOre = false;
-                        
-                        if (y < 4 && oreNoise > 0.85f) {
-                            // Deep ores
-                            if (oreNoise > 0.98f) {
-                                blockType = BlockType::DIAMOND_ORE;
-                                isOre = true;
-                            } else if (oreNoise > 0.95f) {
-                                blockType = BlockType::EMERALD_ORE;
-                                isOre = true;
-                            } else if (oreNoise > 0.90f) {
-                                blockType = BlockType::GOLD_ORE;
-                                isOre = true;
-                            }
-                        } else if (y < 8 && oreNoise > 0.80f) {
-                            // Mid-level ores
-                            if (oreNoise > 0.92f) {
-                                blockType = BlockType::IRON_ORE;
-                                isOre = true;
-                            } else if (oreNoise > 0.88f) {
-                                blockType = BlockType::REDSTONE_ORE;
-                                isOre = true;
-                            }
-                        }                        if (!isOre) {
-                            // Realistic terrain generation based on biome and geology
-                            if (y == surfaceHeight) {
-                                // Surface blocks based on realistic biome characteristics
-                                switch (biome) {
-                                    case DESERT:
-                                        blockType = BlockType::SAND;
-                                        break;
-                                    case COASTAL_PLAINS:
-                                        blockType = BlockType::SAND;
-                                        break;
-                                    case ARCTIC_TUNDRA:
-                                        blockType = BlockType::SNOW;
-                                        break;
-                                    case MOUNTAIN_PEAKS:
-                                        if (surfaceHeight > 20) {
-                                            blockType = BlockType::SNOW;
-                                        } else {
-                                            blockType = BlockType::STONE;
-                                        }
-                                        break;
-                                    case ALPINE:
-                                        if (surfaceHeight > 16) {
-                                            blockType = BlockType::SNOW;
-                                        } else if (vegetationValue > 0.3f) {
-                                            blockType = BlockType::GRASS;
-                                        } else {
-                                            blockType = BlockType::STONE;
-                                        }
-                                        break;
-                                    case RIVER_VALLEY:
-                                        if (y <= waterLevel) {
-                                            blockType = BlockType::WATER;
-                                        } else {
-                                            blockType = BlockType::GRASS;
-                                        }
-                                        break;
-                                    case BOREAL_FOREST:
-                                    case TEMPERATE_FOREST:
-                                    case TROPICAL_RAINFOREST:
-                                        blockType = BlockType::GRASS;
-                                        break;
-                                    case TEMPERATE_GRASSLANDS:
-                                    case TROPICAL_GRASSLANDS:
-                                    case MEDITERRANEAN:
-                                        blockType = BlockType::GRASS;
-                                        break;
-                                    default:
-                                        blockType = BlockType::GRASS;
-                                        break;
-                                }
-                            } else if (y > surfaceHeight - 4) {
-                                // Sub-surface layers with realistic soil profiles
-                                switch (biome) {
-                                    case DESERT:
-                                    case COASTAL_PLAINS:
-                                        if (y > surfaceHeight - 3) {
-                                            blockType = BlockType::SAND;
-                                        } else {
-                                            blockType = BlockType::DIRT;
-                                        }
-                                        break;
-                                    case TROPICAL_RAINFOREST:
-                                        // Rich soil layers
-                                        blockType = BlockType::DIRT;
-                                        break;
-                                    case MOUNTAIN_PEAKS:
-                                    case ALPINE:
-                                        if (y > surfaceHeight - 2) {
-                                            blockType = BlockType::DIRT;
-                                        } else {
-                                            blockType = BlockType::STONE;
-                                        }
-                                        break;
-                                    case RIVER_VALLEY:
-                                        if (y <= waterLevel) {
-                                            blockType = BlockType::WATER;
-                                        } else {
-                                            blockType = BlockType::DIRT;
-                                        }
-                                        break;
-                                    default:
-                                        blockType = BlockType::DIRT;
-                                        break;
-                                }
-                            } else if (y > surfaceHeight - 10) {
-                                // Bedrock transition zone with geological variation
-                                if ((biome == MOUNTAIN_PEAKS || biome == ALPINE) && 
-                                    ridgeValue > 0.2f) {
-                                    blockType = BlockType::COBBLESTONE;
-                                } else if (erosionValue > 0.6f) {
-                                    // Weathered stone
-                                    blockType = BlockType::COBBLESTONE;
-                                } else {
-                                    blockType = BlockType::STONE;
-                                }
-                            } else {
-                                // Deep geological layers
-                                if (y < 3) {
-                                    blockType = BlockType::BEDROCK;
-                                } else {
-                                    blockType = BlockType::STONE;
-                                }
-                            }
-                        }
-                    }
-                }
-                
-                // Set the block
-                chunk->setBlock(x, y, z, blockType);
-            }
-        }
+    // Reuse an unloaded chunk object when there is one
+    std::unique_ptr<VoxelChunk> chunk;
+    if (!chunkPool.empty()) {
+        chunk = std::move(chunkPool.back());
+        chunkPool.pop_back();
+        chunk->reset(coord.x, coord.z);
+    } else {
+        chunk = std::make_unique<VoxelChunk>(coord.x, coord.z);
     }
     
-    // Generate mesh after setting all blocks
+    // Read the chunk from the world cache, or fill it with generated terrain
+    bool generated = !worldCache.loadChunk(*chunk, coord.x, coord.z);
+    if (generated) {
+        chunk->reset(coord.x, coord.z);
+        terrainGenerator.generateChunk(*chunk, coord.x, coord.z);
+    }
+    
+    // Mark the mesh for (lazy) generation after setting all blocks
     chunk->regenerateMesh();
     
+    VoxelChunk* loaded = chunk.get();
     loadedChunks[coord] = std::move(chunk);
+    addToRenderRings(coord, loaded);
+    return generated;
+}
+
+void ChunkManager::queueMissingChunks(const ChunkCoord& center) {
+    pendingChunks.clear();
+    getChunksInRange(center, loadRadius, chunksInRange);
+    for (const auto& coord : chunksInRange) {
+        if (isInLoadRange(coord, center) && loadedChunks.find(coord) == loadedChunks.end()) {
+            pendingChunks.push_back(coord);
+        }
+    }
+    std::sort(pendingChunks.begin(), pendingChunks.end(),
+              [&center](const ChunkCoord& a, const ChunkCoord& b) {
+                  return a.distanceSquared(center) > b.distanceSquared(center);
+              });
+}
+
+void ChunkManager::loadPendingChunks() {
+    // Cached chunks are cheap to read, so more of them fit in a frame than generated ones
+    int loaded = 0;
+    int generated = 0;
+    for (; loaded < MAX_CHUNK_LOADS_PER_FRAME && generated < MAX_CHUNK_GENERATIONS_PER_FRAME &&
+           !pendingChunks.empty(); loaded++) {
+        if (loadChunk(pendingChunks.back())) {
+            generated++;
+        }
+        pendingChunks.pop_back();
+    }
+    lastLoadedCount = loaded;
+    lastGeneratedCount = generated;
 }
 
 void ChunkManager::unloadChunk(const ChunkCoord& coord) {
+    // Nothing is kept for reuse while the chunks are over budget
+    bool pool = getChunkBudgetUse() <= 1.0f;
+    
     auto it = loadedChunks.find(coord);
     if (it != loadedChunks.end()) {
+        removeFromRenderRings(coord);
+        // A merged region holding the chunk can't be drawn any more
+        for (int i = 0; i < activeSuperChunks; i++) {
+            int member = superChunks[i]->getMemberIndex(coord);
+            if (member >= 0 && superChunks[i]->isMember(member)) superChunks[i]->invalidate();
+        }
+        if (pool && chunkPool.size() < MAX_POOLED_CHUNKS) {
+            chunkPool.push_back(std::move(it->second));
+        }
         loadedChunks.erase(it);
     }
+    
+    auto meshIt = chunkMeshes.find(coord);
+    if (meshIt != chunkMeshes.end()) {
+        if (pool && meshBufferPool.size() < MAX_POOLED_CHUNKS) {
+            meshIt->second->invalidate();
+            meshBufferPool.push_back(std::move(meshIt->second));
+        }
+        chunkMeshes.erase(meshIt);
+    }
 }
 
-std::vector<ChunkCoord> ChunkManager::getChunksInRange(const ChunkCoord& center, int range) const {
-    std::vector<ChunkCoord> chunks;
-    chunks.reserve((2 * range + 1) * (2 * range + 1));
+void ChunkManager::findVisibleChunks(const ChunkCoord& cameraChunk, float playerY) {
+    // Face directions as in VoxelChunk::generateMesh: +Z, -Z, +X, -X, +Y, -Y.
+    // The opposite of face f is f ^ 1.
+    static const int stepX[VoxelChunk::FACE_COUNT] = { 0, 0, 1, -1, 0, 0 };
+    static const int stepY[VoxelChunk::FACE_COUNT] = { 0, 0, 0, 0, 1, -1 };
+    static const int stepZ[VoxelChunk::FACE_COUNT] = { 1, -1, 0, 0, 0, 0 };
+    const int topFace = 4;
+    const int sections = VoxelChunk::SECTION_COUNT;
+    const int side = 2 * RENDER_DISTANCE + 1;
+    
+    std::fill(visibilityEntries.begin(), visibilityEntries.end(), 0);
+    std::fill(visibleChunks.begin(), visibleChunks.end(), 0);
+    
+    // Start in every section the player's body spans, since the eye sits
+    // somewhere above the feet
+    int lowest = std::clamp(static_cast<int>(std::floor(playerY)) / VoxelChunk::SECTION_HEIGHT, 0, sections - 1);
+    int highest = std::clamp(static_cast<int>(std::floor(playerY + 2.0f)) / VoxelChunk::SECTION_HEIGHT, 0, sections - 1);
+    int cameraSection = lowest;
+    visibilityQueue.clear();
+    for (int section = lowest; section <= highest; section++) {
+        visibilityQueue.push_back({ RENDER_DISTANCE, RENDER_DISTANCE, section, -1, false });
+        visibilityEntries[(RENDER_DISTANCE * side + RENDER_DISTANCE) * sections + section] = 1 << VoxelChunk::FACE_COUNT;
+    }
+    visibleChunks[RENDER_DISTANCE * side + RENDER_DISTANCE] = 1;
     
+    bool skyReached = false;
+    bool skyEntered = false;
+    size_t head = 0;
+    for (;;) {
+        while (head < visibilityQueue.size()) {
+            VisibilityStep step = visibilityQueue[head++];
+            const VoxelChunk* chunk = chunkGrid[step.x * side + step.z];
+            
+            // Where the walk starts it looks out of every open face
+            auto seesFace = [&](int face) {
+                if (!chunk) return true;
+                return step.entryFace < 0 ? chunk->isFaceOpen(step.section, face)
+                                          : chunk->canSeeThrough(step.section, step.entryFace, face);
+            };
+            
+            int dx = step.x - RENDER_DISTANCE, dz = step.z - RENDER_DISTANCE;
+            for (int face = 0; face < VoxelChunk::FACE_COUNT; face++) {
+                // Only walk away from the player (or down from the sky), so no path doubles back
+                if (dx * stepX[face] < 0 || dz * stepZ[face] < 0) continue;
+                if (step.fromSky ? stepY[face] > 0 : (step.section - cameraSection) * stepY[face] < 0) continue;
+                if (!seesFace(face)) continue;
+                
+                int x = step.x + stepX[face], z = step.z + stepZ[face];
+                int section = step.section + stepY[face];
+                if (section < 0) continue;   // Bedrock
+                if (section == sections) {
+                    skyReached = true;
+                    continue;
+                }
+                int nextDx = x - RENDER_DISTANCE, nextDz = z - RENDER_DISTANCE;
+                if (nextDx * nextDx + nextDz * nextDz > RENDER_DISTANCE * RENDER_DISTANCE) continue;
+                
+                int entryFace = face ^ 1;
+                uint8_t& entries = visibilityEntries[(x * side + z) * sections + section];
+                if (entries & (1 << entryFace)) continue;
+                entries |= 1 << entryFace;
+                visibleChunks[x * side + z] = 1;
+                visibilityQueue.push_back({ x, z, section, entryFace, step.fromSky });
+            }
+        }
+        if (!skyReached || skyEntered) break;
+        
+        // Open sky is one space above the whole world: enter every open-topped
+        // chunk from above and keep walking from there
+        skyEntered = true;
+        for (int x = 0; x < side; x++) {
+            for (int z = 0; z < side; z++) {
+                int dx = x - RENDER_DISTANCE, dz = z - RENDER_DISTANCE;
+                if (dx * dx + dz * dz > RENDER_DISTANCE * RENDER_DISTANCE) continue;
+                const VoxelChunk* chunk = chunkGrid[x * side + z];
+                uint8_t& entries = visibilityEntries[(x * side + z) * sections + sections - 1];
+                if ((chunk && !chunk->isFaceOpen(sections - 1, topFace)) || (entries & (1 << topFace))) continue;
+                entries |= 1 << topFace;
+                visibleChunks[x * side + z] = 1;
+                visibilityQueue.push_back({ x, z, sections - 1, topFace, true });
+            }
+        }
+    }
+}
+
+void ChunkManager::drawOccluders(const ChunkCoord& cameraChunk, const glm::mat4& viewProjection) {
+    occlusionBuffer.begin(viewProjection);
+    for (const auto& pair : loadedChunks) {
+        const ChunkCoord& coord = pair.first;
+        if (std::abs(coord.x - cameraChunk.x) > OCCLUDER_DISTANCE || std::abs(coord.z - cameraChunk.z) > OCCLUDER_DISTANCE) {
+            continue;
+        }
+        const VoxelChunk& chunk = *pair.second;
+        glm::vec3 origin(coord.x * VoxelChunk::CHUNK_SIZE, 0.0f, coord.z * VoxelChunk::CHUNK_SIZE);
+        for (int i = 0; i < chunk.getOccluderCount(); i++) {
+            const VoxelChunk::OccluderBox& box = chunk.getOccluder(i);
+            occlusionBuffer.addOccluder(origin + glm::vec3(box.minX, box.minY, box.minZ),
+                                        origin + glm::vec3(box.maxX, box.maxY, box.maxZ));
+        }
+    }
+    occlusionBuffer.finish();
+}
+
+bool ChunkManager::isChunkVisible(const ChunkCoord& coord, const ChunkCoord& cameraChunk) const {
+    int x = coord.x - cameraChunk.x + RENDER_DISTANCE;
+    int z = coord.z - cameraChunk.z + RENDER_DISTANCE;
+    const int side = 2 * RENDER_DISTANCE + 1;
+    if (x < 0 || x >= side || z < 0 || z >= side) return true;
+    return visibleChunks[x * side + z] != 0;
+}
+
+void ChunkManager::updateMemoryStats() {
+    MemoryStats::set(MemoryCategory::CHUNK_BLOCKS, loadedChunks.size() * sizeof(VoxelChunk));
+    MemoryStats::set(MemoryCategory::CHUNK_POOL, chunkPool.size() * sizeof(VoxelChunk));
+    MemoryStats::set(MemoryCategory::MESH_SCRATCH,
+                     (meshScratch.vertices.capacity() + waterScratch.vertices.capacity()) * sizeof(float) +
+                     (meshScratch.indices.capacity() + waterScratch.indices.capacity() +
+                      waterSortScratch.indices.capacity()) * sizeof(unsigned int) +
+                     waterSortScratch.quads.capacity() * sizeof(waterSortScratch.quads[0]));
+}
+
+float ChunkManager::getChunkBudgetUse() const {
+    return std::max(MemoryStats::getBudgetUse(MemoryCategory::CHUNK_BLOCKS),
+                    MemoryStats::getBudgetUse(MemoryCategory::CHUNK_MESHES));
+}
+
+void ChunkManager::enforceMemoryBudgets(const ChunkCoord& playerChunk) {
+    float use = getChunkBudgetUse();
+    int radius = loadRadius;
+    if (use > 1.0f) {
+        // Pooled objects hold memory that nothing draws, so they go first
+        if (!chunkPool.empty() || !meshBufferPool.empty()) {
+            chunkPool.clear();
+            meshBufferPool.clear();
+            updateMemoryStats();
+            return;
+        }
+        if (loadRadius == MIN_LOAD_RADIUS) return;
+        
+        // Drop the outer ring; mesh memory only shrinks when chunks go away
+        loadRadius--;
+        chunksToUnload.clear();
+        for (const auto& pair : loadedChunks) {
+            if (!isInLoadRange(pair.first, playerChunk)) {
+                chunksToUnload.push_back(pair.first);
+            }
+        }
+        for (const auto& coord : chunksToUnload) {
+            unloadChunk(coord);
+        }
+        updateMemoryStats();
+    } else if (loadRadius < LOAD_DISTANCE && pendingChunks.empty() && lastMeshBuildCount == 0) {
+        // Grow once everything is loaded and meshed and one more ring, at the
+        // current cost per chunk, would still leave some headroom
+        float grown = loadRadius + 1.0f;
+        if (use * grown * grown / (static_cast<float>(loadRadius) * loadRadius) >= 0.9f) return;
+        loadRadius++;
+    } else {
+        return;
+    }
+    
+    queueMissingChunks(playerChunk);
+    farTerrain.setInnerDistance(std::min(loadRadius, static_cast<int>(RENDER_DISTANCE)));
+    LOG_INFO("Load radius " << radius << " -> " << loadRadius << " chunks (chunk memory at "
+             << static_cast<int>(use * 100.0f) << "% of budget)");
+}
+
+void ChunkManager::getChunksInRange(const ChunkCoord& center, int range, std::vector<ChunkCoord>& out) const {
+    out.clear();
     for (int x = center.x - range; x <= center.x + range; x++) {
         for (int z = center.z - range; z <= center.z + range; z++) {
-            chunks.emplace_back(x, z);
+            out.emplace_back(x, z);
         }
     }
+}
+
+int ChunkManager::getLodForDistance(float distSq) const {
+    if (distSq > LOD2_DISTANCE * LOD2_DISTANCE) return 2;
+    if (distSq > LOD1_DISTANCE * LOD1_DISTANCE) return 1;
+    return 0;
+}
+
+void ChunkManager::rebuildRenderRings(const ChunkCoord& center) {
+    for (auto& ring : renderRings) {
+        ring.clear();
+    }
+    std::fill(chunkGrid.begin(), chunkGrid.end(), nullptr);
+    ringCenter = center;
+    ringsValid = true;
+    for (const auto& pair : loadedChunks) {
+        addToRenderRings(pair.first, pair.second.get());
+    }
+    updateSuperChunkRegions(center);
+}
+
+void ChunkManager::getSuperChunkRegions(const ChunkCoord& center, std::vector<SuperChunkRegion>& out) const {
+    out.clear();
+    ChunkCoord first = toSuperChunkRegion(ChunkCoord(center.x - RENDER_DISTANCE, center.z - RENDER_DISTANCE));
+    ChunkCoord last = toSuperChunkRegion(ChunkCoord(center.x + RENDER_DISTANCE, center.z + RENDER_DISTANCE));
+    for (int x = first.x; x <= last.x; x++) {
+        for (int z = first.z; z <= last.z; z++) {
+            // Members are the chunks within render distance drawn at the merged level
+            unsigned int mask = 0;
+            int count = 0;
+            for (int member = 0; member < SuperChunkMesh::MEMBER_COUNT; member++) {
+                ChunkCoord coord(x * SuperChunkMesh::SIZE + member / SuperChunkMesh::SIZE,
+                                 z * SuperChunkMesh::SIZE + member % SuperChunkMesh::SIZE);
+                float distSq = coord.distanceSquared(center);
+                if (distSq <= RENDER_DISTANCE * RENDER_DISTANCE &&
+                    getLodForDistance(distSq) == SuperChunkMesh::LOD) {
+                    mask |= 1u << member;
+                    count++;
+                }
+            }
+            if (count >= MIN_SUPER_CHUNK_MEMBERS) out.push_back({ ChunkCoord(x, z), mask });
+        }
+    }
+}
+
+void ChunkManager::updateSuperChunkRegions(const ChunkCoord& center) {
+    getSuperChunkRegions(center, superChunkRegions);
     
-    return chunks;
+    // Meshes whose region is still in the band keep it (and their merge, if
+    // the members are the same) and move to the front; the regions left over
+    // go to the others
+    int kept = 0;
+    for (int i = 0; i < activeSuperChunks; i++) {
+        const ChunkCoord& region = superChunks[i]->getRegion();
+        auto it = std::find_if(superChunkRegions.begin(), superChunkRegions.end(),
+                               [&](const SuperChunkRegion& candidate) { return candidate.region == region; });
+        if (it == superChunkRegions.end()) continue;
+        superChunks[i]->setRegion(it->region, it->memberMask);
+        std::swap(superChunks[i], superChunks[kept++]);
+        *it = superChunkRegions.back();
+        superChunkRegions.pop_back();
+    }
+    for (const SuperChunkRegion& candidate : superChunkRegions) {
+        // A spare may still hold a merge of the region from an earlier visit,
+        // whose members have been unloaded since
+        superChunks[kept]->invalidate();
+        superChunks[kept++]->setRegion(candidate.region, candidate.memberMask);
+    }
+    activeSuperChunks = kept;
 }
 
-bool ChunkManager::shouldRenderChunk(const ChunkCoord& coord, const glm::vec3& playerPosition) const {
-    ChunkCoord playerChunk = worldToChunkCoord(playerPosition);
-    float distSq = coord.distanceSquared(playerChunk);
-    return distSq <= RENDER_DISTANCE * RENDER_DISTANCE;
+void ChunkManager::prepareSuperChunks(const ChunkCoord& cameraChunk) {
+    std::fill(mergedChunks.begin(), mergedChunks.end(), 0);
+    const int side = 2 * RENDER_DISTANCE + 1;
+    int builds = 0;
+    VoxelChunk* members[SuperChunkMesh::MEMBER_COUNT];
+    for (int i = 0; i < activeSuperChunks; i++) {
+        SuperChunkMesh& superChunk = *superChunks[i];
+        if (!superChunk.isCurrent()) {
+            if (builds >= MAX_SUPER_CHUNK_BUILDS_PER_FRAME) continue;
+            bool complete = true;
+            for (int member = 0; member < SuperChunkMesh::MEMBER_COUNT && complete; member++) {
+                ChunkCoord coord = superChunk.getMemberCoord(member);
+                members[member] = superChunk.isMember(member) ? getChunkAt(coord.x, coord.z) : nullptr;
+                complete = members[member] != nullptr || !superChunk.isMember(member);
+            }
+            if (!complete) continue;
+            superChunk.build(members, meshScratch, waterScratch, superChunkScratch);
+            builds++;
+            lastMeshBuildCount++;
+        }
+        for (int member = 0; member < SuperChunkMesh::MEMBER_COUNT; member++) {
+            if (!superChunk.isMember(member)) continue;
+            ChunkCoord coord = superChunk.getMemberCoord(member);
+            int x = coord.x - cameraChunk.x + RENDER_DISTANCE;
+            int z = coord.z - cameraChunk.z + RENDER_DISTANCE;
+            if (x >= 0 && x < side && z >= 0 && z < side) {
+                mergedChunks[x * side + z] = static_cast<uint8_t>(
+                    superChunk.hasMemberWater(member) ? MergedState::MERGED_WITH_WATER : MergedState::MERGED);
+            }
+        }
+    }
+}
+
+ChunkManager::MergedState ChunkManager::getMergedState(const ChunkCoord& coord, const ChunkCoord& cameraChunk) const {
+    int x = coord.x - cameraChunk.x + RENDER_DISTANCE;
+    int z = coord.z - cameraChunk.z + RENDER_DISTANCE;
+    const int side = 2 * RENDER_DISTANCE + 1;
+    if (x < 0 || x >= side || z < 0 || z >= side) return MergedState::NOT_MERGED;
+    return static_cast<MergedState>(mergedChunks[x * side + z]);
+}
+
+void ChunkManager::addToRenderRings(const ChunkCoord& coord, VoxelChunk* chunk) {
+    if (!ringsValid) return;
+    int x = coord.x - ringCenter.x + RENDER_DISTANCE;
+    int z = coord.z - ringCenter.z + RENDER_DISTANCE;
+    const int side = 2 * RENDER_DISTANCE + 1;
+    if (x >= 0 && x < side && z >= 0 && z < side) chunkGrid[x * side + z] = chunk;
+    int distSq = static_cast<int>(coord.distanceSquared(ringCenter));
+    if (distSq >= static_cast<int>(renderRings.size())) return;
+    renderRings[distSq].push_back({ coord, chunk, nullptr });
+}
+
+void ChunkManager::removeFromRenderRings(const ChunkCoord& coord) {
+    if (!ringsValid) return;
+    int x = coord.x - ringCenter.x + RENDER_DISTANCE;
+    int z = coord.z - ringCenter.z + RENDER_DISTANCE;
+    const int side = 2 * RENDER_DISTANCE + 1;
+    if (x >= 0 && x < side && z >= 0 && z < side) chunkGrid[x * side + z] = nullptr;
+    int distSq = static_cast<int>(coord.distanceSquared(ringCenter));
+    if (distSq >= static_cast<int>(renderRings.size())) return;
+    std::vector<RenderEntry>& ring = renderRings[distSq];
+    for (size_t i = 0; i < ring.size(); i++) {
+        if (ring[i].coord == coord) {
+            ring.erase(ring.begin() + i);
+            return;
+        }
+    }
+}
+
+VoxelChunk* ChunkManager::getGridChunk(const ChunkCoord& coord) const {
+    int x = coord.x - ringCenter.x + RENDER_DISTANCE;
+    int z = coord.z - ringCenter.z + RENDER_DISTANCE;
+    const int side = 2 * RENDER_DISTANCE + 1;
+    if (x < 0 || x >= side || z < 0 || z >= side) return nullptr;
+    return chunkGrid[x * side + z];
+}
+
+namespace {
+
+// Chunk offsets of the sides, as in ChunkNeighbors
+const int SIDE_STEP_X[ChunkMesh::SIDES] = { 0, 0, 1, -1 };
+const int SIDE_STEP_Z[ChunkMesh::SIDES] = { 1, -1, 0, 0 };
+
+}
+
+ChunkNeighbors ChunkManager::getNeighbors(const ChunkCoord& coord) const {
+    ChunkNeighbors neighbors;
+    for (int side = 0; side < ChunkMesh::SIDES; side++) {
+        neighbors.chunks[side] = getGridChunk(ChunkCoord(coord.x + SIDE_STEP_X[side], coord.z + SIDE_STEP_Z[side]));
+    }
+    return neighbors;
+}
+
+bool ChunkManager::isInLoadRange(const ChunkCoord& coord, const ChunkCoord& center) const {
+    return coord.distanceSquared(center) <= static_cast<float>(loadRadius * loadRadius);
+}
+
+bool ChunkManager::isAwaitingNeighbors(const ChunkCoord& coord, const ChunkNeighbors& neighbors) const {
+    for (int side = 0; side < ChunkMesh::SIDES; side++) {
+        ChunkCoord neighbor(coord.x + SIDE_STEP_X[side], coord.z + SIDE_STEP_Z[side]);
+        if (!neighbors.chunks[side] && isInLoadRange(neighbor, lastPlayerChunk)) return true;
+    }
+    return false;
+}
+
+unsigned int ChunkManager::getSkirtMask(const ChunkCoord& coord, int lod) const {
+    unsigned int mask = 0;
+    for (int side = 0; side < ChunkMesh::SIDES; side++) {
+        ChunkCoord neighbor(coord.x + SIDE_STEP_X[side], coord.z + SIDE_STEP_Z[side]);
+        float distSq = neighbor.distanceSquared(ringCenter);
+        bool sameLevel = getGridChunk(neighbor) && distSq <= RENDER_DISTANCE * RENDER_DISTANCE &&
+                         getLodForDistance(distSq) == lod;
+        if (!sameLevel) mask |= 1u << side;
+    }
+    return mask;
 }
 
 int ChunkManager::getSurfaceHeight(float worldX, float worldZ) const {
-    VoxelChunk* chunk = getChunk(glm::vec3(worldX, 0, worldZ));
+    ChunkCoord coord = worldToChunkCoord(worldX, worldZ);
+    VoxelChunk* chunk = getChunkAt(coord.x, coord.z);
     if (!chunk) return -1;
     
-    // Find the highest solid block at this X,Z position
-    for (int y = VoxelChunk::CHUNK_SIZE - 1; y >= 0; y--) {
-        if (isBlockSolid(glm::vec3(worldX, y, worldZ))) {
-            return y;
-        }
-    }
-    return -1; // No solid blocks found
+    int localX = static_cast<int>(std::floor(worldX)) - coord.x * VoxelChunk::CHUNK_SIZE;
+    int localZ = static_cast<int>(std::floor(worldZ)) - coord.z * VoxelChunk::CHUNK_SIZE;
+    return chunk->getColumnHeight(localX, localZ);
+}
+
+BlockType ChunkManager::getSurfaceBlock(float worldX, float worldZ) const {
+    ChunkCoord coord = worldToChunkCoord(worldX, worldZ);
+    VoxelChunk* chunk = getChunkAt(coord.x, coord.z);
+    if (!chunk) return BlockType::AIR;
+    
+    int localX = static_cast<int>(std::floor(worldX)) - coord.x * VoxelChunk::CHUNK_SIZE;
+    int localZ = static_cast<int>(std::floor(worldZ)) - coord.z * VoxelChunk::CHUNK_SIZE;
+    return chunk->getColumnTopBlock(localX, localZ);
 }
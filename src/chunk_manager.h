@@ -4,55 +4,87 @@
 #include <unordered_set>
 #include <vector>
 #include <memory>
+#include <string>
 #include <glm/glm.hpp>
 #include "voxel_chunk.h"
-#include "FastNoiseLite.h"
-
-// Hash function for chunk coordinates
-struct ChunkCoord {
-    int x, z;
-    
-    ChunkCoord(int x, int z) : x(x), z(z) {}
-    
-    bool operator==(const ChunkCoord& other) const {
-        return x == other.x && z == other.z;
-    }
-    
-    // Distance calculation for sorting
-    float distanceSquared(const ChunkCoord& other) const {
-        float dx = x - other.x;
-        float dz = z - other.z;
-        return dx * dx + dz * dz;
-    }
-};
-
-// Custom hash function for ChunkCoord
-struct ChunkCoordHash {
-    std::size_t operator()(const ChunkCoord& coord) const {
-        return std::hash<int>()(coord.x) ^ (std::hash<int>()(coord.z) << 1);
-    }
-};
+#include "chunk_coord.h"
+#include "terrain_generator.h"
+#include "far_terrain.h"
+#include "chunk_mesh_buffers.h"
+#include "world_cache.h"
+#include "occlusion_buffer.h"
+#include "super_chunk_mesh.h"
 
 class ChunkManager {
 public:
     // Configuration constants
-    static const int RENDER_DISTANCE = 8;     // Chunks to render around player
-    static const int LOAD_DISTANCE = 10;      // Chunks to keep loaded around player
-    static const int UNLOAD_DISTANCE = 12;    // Distance at which to unload chunks
+    static const int RENDER_DISTANCE = 16;    // Chunks to render around player
+    static const int LOAD_DISTANCE = 16;      // Chunks to keep loaded around player
+    static const int UNLOAD_DISTANCE = 18;    // Distance at which to unload chunks
+    
+    // Level-of-detail bands: chunks beyond these distances use 2x and 4x meshes.
+    // Around spawn the 16-chunk radius comes to ~340k triangles (190k full,
+    // 110k 2x, 40k 4x), under the ~570k of the old 8-chunk full-detail radius.
+    static const int LOD1_DISTANCE = 6;
+    static const int LOD2_DISTANCE = 11;
+    
+    // Chunks around the player loaded before the first frame (3x3); the rest of
+    // the load distance streams in nearest first, a few chunks per frame
+    static const int SPAWN_RADIUS = 1;
+    static const int MAX_CHUNK_GENERATIONS_PER_FRAME = 4;
+    static const int MAX_CHUNK_LOADS_PER_FRAME = 16;   // Including cheap world cache reads
+    
+    // Unloaded chunks and their mesh buffers kept for reuse by later loads
+    static const int MAX_POOLED_CHUNKS = 64;
     
-    ChunkManager();
+    // Over a chunk block or chunk mesh memory budget the load radius shrinks a
+    // ring at a time, down to this; it grows back once the next ring would fit
+    static const int MIN_LOAD_RADIUS = 4;
+    
+    // Chunks within this many chunks of the player (on each axis) are drawn
+    // into the occlusion buffer; nearby terrain hides the most
+    static const int OCCLUDER_DISTANCE = 4;
+    
+    // The chunks of a region of SuperChunkMesh::SIZE^2 that lie in the
+    // coarsest level-of-detail band (at least MIN_SUPER_CHUNK_MEMBERS of them)
+    // are drawn as one merged mesh. Merges are rebuilt after a member changes
+    // or the band moves over the region, this many per frame; the members are
+    // drawn one by one until then.
+    static const int MIN_SUPER_CHUNK_MEMBERS = 2;
+    static const int MAX_SUPER_CHUNK_BUILDS_PER_FRAME = 2;
+    
+    // Chunk meshes built before a neighbour loaded still draw correctly, with
+    // the faces toward it; this many a frame are rebuilt to drop them
+    static const int MAX_NEIGHBOR_REBUILDS_PER_FRAME = 8;
+    
+    // All GPU work goes through device, which must outlive the manager
+    explicit ChunkManager(RenderDevice& device);
     ~ChunkManager();
     
+    // Free every GPU buffer (chunk, merged and horizon meshes) while the
+    // graphics context is still current; the manager only keeps its chunk data
+    void shutdown();
+    
     // Core update function - call every frame
     void update(const glm::vec3& playerPosition);
     
-    // Initialize chunks after OpenGL is ready
+    // Map a pregenerated world cache; chunks it covers are read instead of generated.
+    // Call before initialize. Returns false (and generates everything) if unusable.
+    bool openWorldCache(const std::string& path);
+    
+    // Load the spawn chunks and queue the rest of the load distance
     void initialize(const glm::vec3& playerPosition);
     
-    // Rendering
+    // Rendering; rebuilds stale chunk meshes on the way. The camera matrices
+    // reach the shader through the camera uniform buffer; here they only cull.
     void render(unsigned int shaderProgram, const glm::vec3& playerPosition, 
                 const glm::mat4& view, const glm::mat4& projection);
     
+    // Translucent pass: the water of the chunks the last render() drew, with
+    // the water program, farthest chunks first and each chunk's faces back to
+    // front. Call after all opaque geometry, with blending on and depth writes off.
+    void renderWater(unsigned int waterProgram, const glm::vec3& cameraPosition);
+    
     // World queries for collision detection
     bool isBlockSolid(const glm::vec3& worldPosition) const;
     BlockType getBlockType(const glm::vec3& worldPosition) const;
@@ -64,43 +96,212 @@ public:
     // Statistics
     int getLoadedChunkCount() const { return loadedChunks.size(); }
     int getRenderedChunkCount() const { return lastRenderedCount; }
+    int getFarTileCount() const { return farTerrain.getTileCount(); }
+    int getPendingChunkCount() const { return static_cast<int>(pendingChunks.size()); }
+    int getLoadRadius() const { return loadRadius; }
+    int getCulledChunkCount() const { return lastCulledCount; }
+    
+    // Cave culling: skip chunks within render distance that the camera chunk
+    // cannot see into through open space. On by default.
+    void setCaveCulling(bool enable) { caveCulling = enable; }
+    bool getCaveCulling() const { return caveCulling; }
+    
+    // Occlusion culling: skip chunks whose bounds are hidden behind the solid
+    // parts of nearby chunks, rasterized on the CPU. On by default.
+    void setOcclusionCulling(bool enable) { occlusionCulling = enable; }
+    bool getOcclusionCulling() const { return occlusionCulling; }
+    int getOccludedChunkCount() const { return lastOccludedCount; }
+    
+    // Merged far regions drawn by the last render() call
+    int getSuperChunkDrawCount() const { return lastSuperChunkDrawCount; }
+    
+    // Work done by the last update() / render() call (frame stall attribution)
+    int getLastLoadedCount() const { return lastLoadedCount; }
+    int getLastGeneratedCount() const { return lastGeneratedCount; }
+    int getLastMeshBuildCount() const { return lastMeshBuildCount; }
+    int getLastWaterSortCount() const { return lastWaterSortCount; }
+    
+    const TerrainGenerator& getTerrainGenerator() const { return terrainGenerator; }
     
-    // Helper method to find surface height at world position
+    // Surface queries backed by the per-chunk column summaries (O(1));
+    // -1 / AIR when the chunk is not loaded or the column is empty
     int getSurfaceHeight(float worldX, float worldZ) const;
+    BlockType getSurfaceBlock(float worldX, float worldZ) const;
+    
+    // Load or drop a single chunk right away, bypassing the streaming queue.
+    // loadChunk returns true if the chunk had to be generated.
+    bool loadChunk(const ChunkCoord& coord);
+    void unloadChunk(const ChunkCoord& coord);
     
 private:
     // Convert world position to chunk coordinates
     ChunkCoord worldToChunkCoord(const glm::vec3& worldPosition) const;
     ChunkCoord worldToChunkCoord(float x, float z) const;
     
-    // Chunk loading/unloading
-    void loadChunk(const ChunkCoord& coord);
-    void unloadChunk(const ChunkCoord& coord);
+    // Streaming queue around the player
+    void queueMissingChunks(const ChunkCoord& center);
+    void loadPendingChunks();
+    
+    // Chunks around a position, into out (cleared first, capacity reused)
+    void getChunksInRange(const ChunkCoord& center, int range, std::vector<ChunkCoord>& out) const;
+    
+    // Pick the mesh level of detail for a chunk at the given squared chunk distance
+    int getLodForDistance(float distSq) const;
+    
+    // Render set upkeep: re-bucket every loaded chunk around a new center, or
+    // add / remove one chunk as it loads or unloads
+    void rebuildRenderRings(const ChunkCoord& center);
+    void addToRenderRings(const ChunkCoord& coord, VoxelChunk* chunk);
+    void removeFromRenderRings(const ChunkCoord& coord);
     
-    // Get chunks that should be loaded around a position
-    std::vector<ChunkCoord> getChunksInRange(const ChunkCoord& center, int range) const;
+    // A region and the chunks of it in the coarsest level-of-detail band
+    struct SuperChunkRegion {
+        ChunkCoord region;
+        unsigned int memberMask;
+    };
     
-    // Check if chunk should be rendered based on distance
-    bool shouldRenderChunk(const ChunkCoord& coord, const glm::vec3& playerPosition) const;
+    // Assign super-chunk meshes to the regions around a new center that reach
+    // into the coarsest level-of-detail band, keeping the meshes of regions
+    // still in it (which only rebuild if their members changed)
+    void updateSuperChunkRegions(const ChunkCoord& center);
+    
+    // Regions the super-chunk meshes would serve around a center, into out
+    void getSuperChunkRegions(const ChunkCoord& center, std::vector<SuperChunkRegion>& out) const;
+    
+    // Rebuild stale super-chunks within the frame's budget and mark the chunks
+    // of current ones in mergedChunks
+    void prepareSuperChunks(const ChunkCoord& cameraChunk);
+    
+    // Whether a current super-chunk covers a chunk this frame, and if so
+    // whether the chunk still draws its own water
+    enum class MergedState : uint8_t { NOT_MERGED, MERGED, MERGED_WITH_WATER };
+    MergedState getMergedState(const ChunkCoord& coord, const ChunkCoord& cameraChunk) const;
+    
+    // Walk from the player's sections through the sections' face visibility and
+    // mark every chunk within render distance it reaches. Chunks not loaded yet
+    // count as open, and open sky reached anywhere enters all open-topped chunks.
+    void findVisibleChunks(const ChunkCoord& cameraChunk, float playerY);
+    bool isChunkVisible(const ChunkCoord& coord, const ChunkCoord& cameraChunk) const;
+    
+    // Loaded chunk on the ring grid, null outside it or where none is loaded
+    VoxelChunk* getGridChunk(const ChunkCoord& coord) const;
+    
+    // The loaded chunks beside a chunk, for building its meshes
+    ChunkNeighbors getNeighbors(const ChunkCoord& coord) const;
+    
+    // Whether a chunk lies in the load circle around a center, the same
+    // distance test update() unloads by
+    bool isInLoadRange(const ChunkCoord& coord, const ChunkCoord& center) const;
+    
+    // Whether a neighbour of a chunk is missing but about to be loaded
+    bool isAwaitingNeighbors(const ChunkCoord& coord, const ChunkNeighbors& neighbors) const;
+    
+    // Sides (as in ChunkNeighbors) of a chunk drawn at lod whose skirts are
+    // needed: the neighbour there is not drawn at the same level of detail
+    unsigned int getSkirtMask(const ChunkCoord& coord, int lod) const;
+    
+    // Bit per face direction (as in VoxelChunk::generateMesh) that can face a
+    // camera at cameraPosition from somewhere inside the bounds
+    static unsigned int getFacingDirections(const glm::vec3& min, const glm::vec3& max,
+                                            const glm::vec3& cameraPosition);
+    
+    // Rasterize the occluder boxes of the chunks around the player
+    void drawOccluders(const ChunkCoord& cameraChunk, const glm::mat4& viewProjection);
+    
+    // Report the chunk categories to MemoryStats
+    void updateMemoryStats();
+    
+    // Fraction of the tighter of the chunk block and chunk mesh budgets in use
+    float getChunkBudgetUse() const;
+    
+    // Shrink or grow the load radius to stay within the memory budgets
+    void enforceMemoryBudgets(const ChunkCoord& playerChunk);
     
 private:
     // Chunk storage
     std::unordered_map<ChunkCoord, std::unique_ptr<VoxelChunk>, ChunkCoordHash> loadedChunks;
     
+    // GPU meshes of loaded chunks, created the first time a chunk is drawn
+    std::unordered_map<ChunkCoord, std::unique_ptr<ChunkMeshBuffers>, ChunkCoordHash> chunkMeshes;
+    ChunkMesh meshScratch;
+    ChunkMesh waterScratch;
+    WaterSortScratch waterSortScratch;
+    
+    // Chunks with water drawn by the last render(), for the water pass; in
+    // render ring order, so nearest first to within a ring
+    struct WaterDraw {
+        VoxelChunk* chunk;
+        ChunkMeshBuffers* buffers;
+        int lod;
+    };
+    std::vector<WaterDraw> waterDraws;
+    
     // Tracking
     ChunkCoord lastPlayerChunk;
-    mutable int lastRenderedCount;    // Enhanced terrain generation with realistic noise systems
-    FastNoiseLite heightNoise;
-    FastNoiseLite caveNoise;
-    FastNoiseLite biomeNoise;
-    FastNoiseLite temperatureNoise;
-    FastNoiseLite humidityNoise;
-    FastNoiseLite ridgeNoise;       // For mountain ridges
-    FastNoiseLite erosionNoise;     // For erosion patterns
-    FastNoiseLite vegetationNoise;  // For vegetation density
+    int loadRadius;    // LOAD_DISTANCE unless a memory budget is tight
+    mutable int lastRenderedCount;
+    int lastCulledCount;
+    int lastOccludedCount;
+    int lastLoadedCount;
+    int lastGeneratedCount;
+    int lastMeshBuildCount;
+    int lastWaterSortCount;
+    int lastSuperChunkDrawCount;
+    
+    RenderDevice& device;
+    
+    // Procedural terrain, its pregenerated spawn area and the heightmap-only
+    // horizon beyond the load distance
+    TerrainGenerator terrainGenerator;
+    WorldCache worldCache;
+    FarTerrain farTerrain;
+    
+    // Recycled chunk objects and mesh buffers, so streaming does not allocate
+    std::vector<std::unique_ptr<VoxelChunk>> chunkPool;
+    std::vector<std::unique_ptr<ChunkMeshBuffers>> meshBufferPool;
     
     // Cache for performance
-    std::vector<ChunkCoord> chunksToLoad;
+    std::vector<ChunkCoord> chunksInRange;
     std::vector<ChunkCoord> chunksToUnload;
-    std::vector<std::pair<ChunkCoord, VoxelChunk*>> chunksToRender;
+    std::vector<ChunkCoord> pendingChunks;   // Sorted farthest first so the nearest pops off the back
+    
+    // Loaded chunks within render distance, bucketed by squared chunk distance
+    // from ringCenter, so drawing them ring by ring is nearest first without a
+    // sort. Kept up to date by loads and unloads, and re-bucketed only when the
+    // player enters another chunk, so the order is stable between frames.
+    struct RenderEntry {
+        ChunkCoord coord;
+        VoxelChunk* chunk;
+        ChunkMeshBuffers* buffers;   // Null until first drawn
+    };
+    std::vector<std::vector<RenderEntry>> renderRings;   // RENDER_DISTANCE^2 + 1 rings
+    ChunkCoord ringCenter;
+    bool ringsValid;
+    
+    // Loaded chunks on a (2 * RENDER_DISTANCE + 1)^2 grid around ringCenter,
+    // kept with the render rings
+    std::vector<VoxelChunk*> chunkGrid;
+    
+    // Cave culling walk state: entry faces per section of each grid cell
+    struct VisibilityStep {
+        int x, z;         // Grid cell
+        int section;
+        int entryFace;    // Face the walk entered through, -1 where it starts
+        bool fromSky;     // Entered from above, so it may walk down toward the player
+    };
+    bool caveCulling;
+    std::vector<uint8_t> visibilityEntries;   // Bit per entry face and section; nonzero = visible
+    std::vector<uint8_t> visibleChunks;       // Per grid cell
+    std::vector<VisibilityStep> visibilityQueue;
+    
+    bool occlusionCulling;
+    OcclusionBuffer occlusionBuffer;
+    
+    // Merged far regions. The first activeSuperChunks serve the regions around
+    // ringCenter; the rest are spare, so moving around never allocates them.
+    std::vector<std::unique_ptr<SuperChunkMesh>> superChunks;
+    int activeSuperChunks;
+    std::vector<SuperChunkRegion> superChunkRegions;
+    std::vector<uint8_t> mergedChunks;        // MergedState per visibility grid cell
+    ChunkMesh superChunkScratch;
 };
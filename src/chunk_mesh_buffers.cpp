@@ -0,0 +1,228 @@
+#include "chunk_mesh_buffers.h"
+#include "log.h"
+#include "memory_stats.h"
+#include "profiler.h"
+#include <algorithm>
+#include <glm/gtc/matrix_transform.hpp>
+
+ChunkMeshBuffers::ChunkMeshBuffers(RenderDevice& device)
+    : device(device)
+{
+}
+
+ChunkMeshBuffers::~ChunkMeshBuffers()
+{
+    for (LodMesh& mesh : lodMeshes) {
+        if (mesh.mesh) device.deleteMesh(mesh.mesh);
+        if (mesh.waterMesh) device.deleteMesh(mesh.waterMesh);
+        MemoryStats::add(MemoryCategory::CHUNK_MESHES, -static_cast<long long>(mesh.bytes));
+    }
+}
+
+void ChunkMeshBuffers::invalidate()
+{
+    for (LodMesh& mesh : lodMeshes) {
+        mesh.indexCount = 0;
+        mesh.waterIndexCount = 0;
+        mesh.waterCenters.clear();
+        mesh.waterSorted = false;
+        mesh.uploaded = false;
+        mesh.neighbors = ChunkNeighbors();
+    }
+}
+
+namespace {
+
+const int FLOATS_PER_VERTEX = 8;
+
+glm::vec3 chunkOrigin(const VoxelChunk& chunk)
+{
+    return glm::vec3(chunk.getWorldX() * VoxelChunk::CHUNK_SIZE, 0, chunk.getWorldZ() * VoxelChunk::CHUNK_SIZE);
+}
+
+glm::mat4 chunkModelMatrix(const VoxelChunk& chunk)
+{
+    return glm::translate(glm::mat4(1.0f), chunkOrigin(chunk));
+}
+
+// The camera's place relative to a chunk, as far as the order of the chunk's
+// water faces is concerned: its block cell at full detail, and only which side
+// of the chunk it is on per axis for coarser levels. Cells outside the chunk
+// clamp to one past its edge, so moving away from a chunk never re-sorts it.
+glm::ivec3 waterSortCell(const glm::vec3& localCamera, int lod)
+{
+    const int cellSize = lod == 0 ? 1 : VoxelChunk::CHUNK_SIZE;
+    const int lastCell = VoxelChunk::CHUNK_SIZE / cellSize;
+    glm::ivec3 cell = glm::ivec3(glm::floor(localCamera / static_cast<float>(cellSize)));
+    return glm::clamp(cell, glm::ivec3(-1), glm::ivec3(lastCell));
+}
+
+}
+
+ChunkMeshBuffers::MeshState ChunkMeshBuffers::getState(const VoxelChunk& chunk, int lod,
+                                                       const ChunkNeighbors& neighbors) const
+{
+    const LodMesh& mesh = lodMeshes[std::clamp(lod, 0, VoxelChunk::LOD_LEVELS - 1)];
+    if (!mesh.uploaded || mesh.revision != chunk.getMeshRevision()) return MeshState::STALE;
+
+    // Faces against a neighbour are skirts, which are drawn whenever that
+    // neighbour is missing, so a neighbour coming or going leaves no hole. A
+    // neighbour that changed under the mesh can, though.
+    MeshState state = MeshState::CURRENT;
+    for (int side = 0; side < ChunkMesh::SIDES; side++) {
+        const VoxelChunk* built = mesh.neighbors.chunks[side];
+        const VoxelChunk* current = neighbors.chunks[side];
+        if (!current) continue;
+        if (!built) {
+            state = MeshState::OUTDATED;
+        } else if (built != current || mesh.neighborRevisions[side] != current->getMeshRevision()) {
+            return MeshState::STALE;
+        }
+    }
+    return state;
+}
+
+void ChunkMeshBuffers::rebuild(const VoxelChunk& chunk, int lod, const ChunkNeighbors& neighbors,
+                               ChunkMesh& scratch, ChunkMesh& waterScratch)
+{
+    lod = std::clamp(lod, 0, VoxelChunk::LOD_LEVELS - 1);
+    LodMesh& mesh = lodMeshes[lod];
+    chunk.generateMesh(scratch, lod, &waterScratch, &neighbors);
+    PROFILE_SCOPE("ChunkMeshBuffers::upload");
+    if (!mesh.mesh) {
+        mesh.mesh = device.createMesh(RenderDevice::terrainLayout());
+    }
+    device.updateMesh(mesh.mesh, scratch.vertices.data(), scratch.vertices.size(),
+                      scratch.indices.data(), scratch.indices.size(), BufferUsage::STATIC);
+    mesh.indexCount = scratch.indices.size();
+    std::copy(scratch.rangeStart, scratch.rangeStart + ChunkMesh::RANGE_COUNT + 1, mesh.rangeStart);
+    // Most chunks are dry; their water mesh is only created once they get water
+    if (!waterScratch.indices.empty() || mesh.waterIndexCount > 0) {
+        if (!mesh.waterMesh) {
+            mesh.waterMesh = device.createMesh(RenderDevice::terrainLayout());
+        }
+        device.updateMesh(mesh.waterMesh, waterScratch.vertices.data(), waterScratch.vertices.size(),
+                          waterScratch.indices.data(), waterScratch.indices.size(), BufferUsage::STATIC);
+    }
+    mesh.waterIndexCount = waterScratch.indices.size();
+    
+    // Quads are four consecutive vertices, so their centres are all the
+    // water pass needs to order them
+    size_t waterQuads = waterScratch.vertices.size() / (4 * FLOATS_PER_VERTEX);
+    mesh.waterCenters.resize(waterQuads);
+    for (size_t quad = 0; quad < waterQuads; quad++) {
+        const float* v = &waterScratch.vertices[quad * 4 * FLOATS_PER_VERTEX];
+        glm::vec3 sum(0.0f);
+        for (int corner = 0; corner < 4; corner++) {
+            sum += glm::vec3(v[corner * FLOATS_PER_VERTEX], v[corner * FLOATS_PER_VERTEX + 1], v[corner * FLOATS_PER_VERTEX + 2]);
+        }
+        mesh.waterCenters[quad] = sum * 0.25f;
+    }
+    mesh.waterSorted = false;
+    
+    size_t bytes = (scratch.vertices.size() + waterScratch.vertices.size()) * sizeof(float) +
+                   (scratch.indices.size() + waterScratch.indices.size()) * sizeof(unsigned int) +
+                   waterQuads * sizeof(glm::vec3);
+    MemoryStats::add(MemoryCategory::CHUNK_MESHES, static_cast<long long>(bytes) - static_cast<long long>(mesh.bytes));
+    mesh.bytes = bytes;
+    mesh.uploaded = true;
+    mesh.revision = chunk.getMeshRevision();
+    mesh.neighbors = neighbors;
+    for (int side = 0; side < ChunkMesh::SIDES; side++) {
+        const VoxelChunk* neighbor = neighbors.chunks[side];
+        mesh.neighborRevisions[side] = neighbor ? neighbor->getMeshRevision() : 0;
+    }
+}
+
+bool ChunkMeshBuffers::render(const VoxelChunk& chunk, int lod, const ChunkNeighbors& neighbors,
+                              UniformLocation modelLocation, unsigned int faceMask, unsigned int skirtMask,
+                              ChunkMesh& scratch, ChunkMesh& waterScratch)
+{
+    lod = std::clamp(lod, 0, VoxelChunk::LOD_LEVELS - 1);
+    LodMesh& mesh = lodMeshes[lod];
+
+    // Meshes are built lazily the first time a level is needed after a change
+    bool rebuilt = getState(chunk, lod, neighbors) == MeshState::STALE;
+    if (rebuilt) {
+        rebuild(chunk, lod, neighbors, scratch, waterScratch);
+    }
+
+    if (mesh.indexCount == 0) {
+        LOG_DEBUG("Chunk (" << chunk.getWorldX() << "," << chunk.getWorldZ() << ") has no mesh to render");
+        return rebuilt;
+    }
+
+    device.setUniform(modelLocation, chunkModelMatrix(chunk));
+    drawFaceRanges(device, mesh.mesh, mesh.rangeStart, faceMask, skirtMask);
+    return rebuilt;
+}
+
+void ChunkMeshBuffers::drawFaceRanges(RenderDevice& device, MeshHandle mesh, const size_t* rangeStart,
+                                      unsigned int faceMask, unsigned int skirtMask)
+{
+    // The kept directions and skirts as index ranges, merging neighbours
+    unsigned int keep = 0;
+    for (int face = 0; face < ChunkMesh::FACE_DIRECTIONS; face++) {
+        if (!(faceMask & (1u << face))) continue;
+        keep |= 1u << ChunkMesh::faceRange(face);
+        if (face < ChunkMesh::SIDES && (skirtMask & (1u << face))) keep |= 1u << ChunkMesh::skirtRange(face);
+    }
+    size_t firsts[ChunkMesh::RANGE_COUNT];
+    size_t counts[ChunkMesh::RANGE_COUNT];
+    int rangeCount = 0;
+    for (int range = 0; range < ChunkMesh::RANGE_COUNT; range++) {
+        size_t first = rangeStart[range];
+        size_t count = rangeStart[range + 1] - first;
+        if (!(keep & (1u << range)) || count == 0) continue;
+        if (rangeCount > 0 && firsts[rangeCount - 1] + counts[rangeCount - 1] == first) {
+            counts[rangeCount - 1] += count;
+        } else {
+            firsts[rangeCount] = first;
+            counts[rangeCount] = count;
+            rangeCount++;
+        }
+    }
+    if (rangeCount == 1) {
+        device.drawMesh(mesh, PrimitiveType::TRIANGLES, counts[0], firsts[0]);
+    } else if (rangeCount > 1) {
+        device.drawMeshRanges(mesh, PrimitiveType::TRIANGLES, firsts, counts, rangeCount);
+    }
+}
+
+bool ChunkMeshBuffers::renderWater(const VoxelChunk& chunk, int lod, UniformLocation modelLocation,
+                                   const glm::vec3& cameraPosition, WaterSortScratch& scratch)
+{
+    lod = std::clamp(lod, 0, VoxelChunk::LOD_LEVELS - 1);
+    LodMesh& mesh = lodMeshes[lod];
+    if (mesh.waterIndexCount == 0) return false;
+
+    glm::vec3 localCamera = cameraPosition - chunkOrigin(chunk);
+    glm::ivec3 cell = waterSortCell(localCamera, lod);
+    bool resorted = !mesh.waterSorted || cell != mesh.waterSortCell;
+    if (resorted) {
+        PROFILE_SCOPE("ChunkMeshBuffers::sortWater");
+        scratch.quads.clear();
+        for (size_t quad = 0; quad < mesh.waterCenters.size(); quad++) {
+            glm::vec3 offset = mesh.waterCenters[quad] - localCamera;
+            scratch.quads.emplace_back(glm::dot(offset, offset), static_cast<unsigned int>(quad));
+        }
+        // Farthest first
+        std::sort(scratch.quads.begin(), scratch.quads.end(),
+                  [](const std::pair<float, unsigned int>& a, const std::pair<float, unsigned int>& b) {
+                      return a.first > b.first;
+                  });
+        scratch.indices.clear();
+        for (const auto& entry : scratch.quads) {
+            unsigned int first = entry.second * 4;
+            const unsigned int pattern[] = { first, first + 1, first + 2, first + 2, first + 3, first };
+            scratch.indices.insert(scratch.indices.end(), pattern, pattern + 6);
+        }
+        device.updateIndices(mesh.waterMesh, scratch.indices.data(), scratch.indices.size());
+        mesh.waterSortCell = cell;
+        mesh.waterSorted = true;
+    }
+
+    device.setUniform(modelLocation, chunkModelMatrix(chunk));
+    device.drawMesh(mesh.waterMesh, PrimitiveType::TRIANGLES, mesh.waterIndexCount);
+    return resorted;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <utility>
+#include <vector>
+#include "render_device.h"
+#include "voxel_chunk.h"
+
+// Reused buffers for re-sorting water meshes, shared by all chunks
+struct WaterSortScratch {
+    std::vector<std::pair<float, unsigned int>> quads;   // Squared camera distance, quad
+    std::vector<unsigned int> indices;
+};
+
+/**
+ * ChunkMeshBuffers holds the GPU copies of one chunk's level-of-detail meshes,
+ * each an opaque mesh plus a translucent water mesh. A level is rebuilt and
+ * re-uploaded lazily, the first time it is drawn after the chunk's mesh
+ * revision (or a neighbour it was built against) changed. Keeps all GPU work
+ * out of VoxelChunk itself.
+ *
+ * Water faces blend correctly only when drawn back to front. Each level keeps
+ * the centres of its water quads and re-sorts its water indices when the
+ * camera has moved to another block cell relative to the chunk (at full
+ * detail) or to another side of it (coarser levels), not every frame.
+ */
+class ChunkMeshBuffers {
+public:
+    explicit ChunkMeshBuffers(RenderDevice& device);
+    ~ChunkMeshBuffers();
+
+    ChunkMeshBuffers(const ChunkMeshBuffers&) = delete;
+    ChunkMeshBuffers& operator=(const ChunkMeshBuffers&) = delete;
+
+    // How a level compares to the chunk and its current neighbours. A
+    // neighbour that unloaded since the build leaves the level current: the
+    // skirts toward it are drawn from then on.
+    enum class MeshState {
+        CURRENT,
+        OUTDATED,   // A neighbour loaded since: draws fine, with faces it now hides
+        STALE       // The chunk or a neighbour it was built against changed
+    };
+    MeshState getState(const VoxelChunk& chunk, int lod, const ChunkNeighbors& neighbors) const;
+    
+    // Rebuild and re-upload a level. The scratch meshes are reused across
+    // chunks for the CPU meshes so steady-state rebuilds don't allocate.
+    void rebuild(const VoxelChunk& chunk, int lod, const ChunkNeighbors& neighbors,
+                 ChunkMesh& scratch, ChunkMesh& waterScratch);
+    
+    // Draw the opaque mesh of a level with the terrain program in use,
+    // rebuilding the level first if stale. Only the face directions whose bit
+    // is set in faceMask are drawn, with the skirts of the sides in skirtMask,
+    // adjacent ranges merged, all in one draw. Returns true if the level had
+    // to be rebuilt.
+    bool render(const VoxelChunk& chunk, int lod, const ChunkNeighbors& neighbors, UniformLocation modelLocation,
+                unsigned int faceMask, unsigned int skirtMask, ChunkMesh& scratch, ChunkMesh& waterScratch);
+    
+    // Draw the water mesh of a level back to front with the water program in
+    // use; the level must have been refreshed by render() this frame. Returns
+    // true if the faces had to be re-sorted for the camera position.
+    bool renderWater(const VoxelChunk& chunk, int lod, UniformLocation modelLocation,
+                     const glm::vec3& cameraPosition, WaterSortScratch& scratch);
+    
+    // Whether a level has been built since the buffers were created or invalidated
+    bool isBuilt(int lod) const { return lodMeshes[lod].uploaded; }
+    
+    // Whether the level uploaded last has any water to draw
+    bool hasWater(int lod) const { return lodMeshes[lod].waterIndexCount > 0; }
+    
+    // Draw the face directions of a mesh built from a ChunkMesh whose bits are
+    // set in faceMask, and the skirts of those in skirtMask, as few index
+    // ranges as possible in one call
+    static void drawFaceRanges(RenderDevice& device, MeshHandle mesh, const size_t* rangeStart,
+                               unsigned int faceMask, unsigned int skirtMask);
+
+    // Forget the uploaded meshes so the buffers can serve another chunk; the
+    // GPU buffers are kept and refilled on the next render
+    void invalidate();
+
+private:
+    struct LodMesh {
+        MeshHandle mesh = 0;
+        MeshHandle waterMesh = 0;
+        size_t indexCount = 0;
+        size_t rangeStart[ChunkMesh::RANGE_COUNT + 1] = {};   // Index ranges as in ChunkMesh
+        size_t waterIndexCount = 0;
+        size_t bytes = 0;          // Uploaded vertex and index data of both meshes, and waterCenters
+        bool uploaded = false;
+        unsigned int revision = 0;
+        ChunkNeighbors neighbors;                            // Built against these
+        unsigned int neighborRevisions[ChunkMesh::SIDES] = {};
+        std::vector<glm::vec3> waterCenters;   // Chunk-local, one per water quad
+        glm::ivec3 waterSortCell = glm::ivec3(0);   // Camera cell the indices are sorted for
+        bool waterSorted = false;
+    };
+
+    RenderDevice& device;
+    LodMesh lodMeshes[VoxelChunk::LOD_LEVELS];
+};
@@ -0,0 +1,198 @@
+#include "far_terrain.h"
+#include "memory_stats.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Floor division so negative chunk coordinates map to the correct tile
+int floorDiv(int value, int divisor) {
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+// Horizon heights sit below the real surface so overlapping voxel chunks always win
+const float HORIZON_SINK = 2.0f;
+
+}
+
+FarTerrain::FarTerrain(const TerrainGenerator& generator, int innerDistance, RenderDevice& device)
+    : generator(generator)
+    , device(device)
+    , innerDistance(innerDistance)
+    , lastPlayerChunk(0, 0)
+    , hasPlayerChunk(false)
+{
+}
+
+FarTerrain::~FarTerrain() {
+    clear();
+}
+
+void FarTerrain::clear() {
+    for (auto& pair : tiles) {
+        destroyTile(pair.second);
+    }
+    tiles.clear();
+    pendingTiles.clear();
+    hasPlayerChunk = false;
+}
+
+void FarTerrain::update(const glm::vec3& playerPosition) {
+    PROFILE_SCOPE("FarTerrain::update");
+    ChunkCoord playerChunk(static_cast<int>(std::floor(playerPosition.x / VoxelChunk::CHUNK_SIZE)),
+                           static_cast<int>(std::floor(playerPosition.z / VoxelChunk::CHUNK_SIZE)));
+
+    if (!hasPlayerChunk || !(playerChunk == lastPlayerChunk)) {
+        // Evict tiles that left the ring (with one tile of hysteresis on the outside)
+        for (auto it = tiles.begin(); it != tiles.end();) {
+            if (!tileInRing(it->first, playerChunk, FAR_DISTANCE + TILE_CHUNKS)) {
+                destroyTile(it->second);
+                it = tiles.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        // Queue every missing tile that overlaps the ring
+        pendingTiles.clear();
+        int tileRange = FAR_DISTANCE / TILE_CHUNKS + 1;
+        int centerX = floorDiv(playerChunk.x, TILE_CHUNKS);
+        int centerZ = floorDiv(playerChunk.z, TILE_CHUNKS);
+        for (int tx = centerX - tileRange; tx <= centerX + tileRange; tx++) {
+            for (int tz = centerZ - tileRange; tz <= centerZ + tileRange; tz++) {
+                ChunkCoord tileCoord(tx, tz);
+                if (tiles.find(tileCoord) == tiles.end() &&
+                    tileInRing(tileCoord, playerChunk, FAR_DISTANCE)) {
+                    pendingTiles.push_back(tileCoord);
+                }
+            }
+        }
+        std::sort(pendingTiles.begin(), pendingTiles.end(),
+                  [&](const ChunkCoord& a, const ChunkCoord& b) {
+                      return tileDistanceSquared(a, playerChunk) > tileDistanceSquared(b, playerChunk);
+                  });
+
+        lastPlayerChunk = playerChunk;
+        hasPlayerChunk = true;
+    }
+
+    for (int built = 0; built < MAX_TILE_BUILDS_PER_FRAME && !pendingTiles.empty(); built++) {
+        buildTile(pendingTiles.back());
+        pendingTiles.pop_back();
+    }
+}
+
+void FarTerrain::setInnerDistance(int distance) {
+    if (distance == innerDistance) return;
+    innerDistance = distance;
+    hasPlayerChunk = false;
+}
+
+void FarTerrain::render(UniformLocation modelLocation) {
+    if (tiles.empty()) return;
+
+    // Tile vertices are already in world space
+    glm::mat4 model(1.0f);
+    device.setUniform(modelLocation, model);
+
+    for (const auto& pair : tiles) {
+        const Tile& tile = pair.second;
+        if (tile.indexCount == 0) continue;
+        device.drawMesh(tile.mesh, PrimitiveType::TRIANGLES, tile.indexCount);
+    }
+}
+
+float FarTerrain::tileDistanceSquared(const ChunkCoord& tileCoord, const ChunkCoord& playerChunk) const {
+    // Distance from the player chunk to the nearest chunk of the tile
+    int minX = tileCoord.x * TILE_CHUNKS, maxX = minX + TILE_CHUNKS - 1;
+    int minZ = tileCoord.z * TILE_CHUNKS, maxZ = minZ + TILE_CHUNKS - 1;
+    ChunkCoord nearest(std::clamp(playerChunk.x, minX, maxX), std::clamp(playerChunk.z, minZ, maxZ));
+    return nearest.distanceSquared(playerChunk);
+}
+
+bool FarTerrain::tileInRing(const ChunkCoord& tileCoord, const ChunkCoord& playerChunk, int outerDistance) const {
+    if (tileDistanceSquared(tileCoord, playerChunk) > static_cast<float>(outerDistance * outerDistance)) {
+        return false;
+    }
+
+    // Skip tiles whose every chunk is already drawn as voxels
+    int minX = tileCoord.x * TILE_CHUNKS, maxX = minX + TILE_CHUNKS - 1;
+    int minZ = tileCoord.z * TILE_CHUNKS, maxZ = minZ + TILE_CHUNKS - 1;
+    int farX = std::max(std::abs(minX - playerChunk.x), std::abs(maxX - playerChunk.x));
+    int farZ = std::max(std::abs(minZ - playerChunk.z), std::abs(maxZ - playerChunk.z));
+    return farX * farX + farZ * farZ > innerDistance * innerDistance;
+}
+
+void FarTerrain::buildTile(const ChunkCoord& tileCoord) {
+    const int cells = TILE_CHUNKS * VoxelChunk::CHUNK_SIZE / SAMPLE_SPACING;
+    const int samples = cells + 3; // One extra sample on each side for seamless normals
+    const float originX = static_cast<float>(tileCoord.x * TILE_CHUNKS * VoxelChunk::CHUNK_SIZE);
+    const float originZ = static_cast<float>(tileCoord.z * TILE_CHUNKS * VoxelChunk::CHUNK_SIZE);
+
+    std::vector<float> heights(samples * samples);
+    std::vector<BlockType> topBlocks(samples * samples);
+    for (int i = 0; i < samples; i++) {
+        for (int j = 0; j < samples; j++) {
+            float worldX = originX + (i - 1) * SAMPLE_SPACING;
+            float worldZ = originZ + (j - 1) * SAMPLE_SPACING;
+            TerrainColumn column = generator.sampleColumn(worldX, worldZ);
+
+            // Voxel chunks are only CHUNK_SIZE tall, so clip the surface the same way
+            int surface = std::min(column.surfaceHeight, VoxelChunk::CHUNK_SIZE - 1);
+            heights[i * samples + j] = surface + 1.0f - HORIZON_SINK;
+            topBlocks[i * samples + j] = generator.getLayerBlock(column, surface);
+        }
+    }
+    auto heightAt = [&](int i, int j) { return heights[(i + 1) * samples + (j + 1)]; };
+
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    vertices.reserve((cells + 1) * (cells + 1) * 8);
+    indices.reserve(cells * cells * 6);
+
+    for (int i = 0; i <= cells; i++) {
+        for (int j = 0; j <= cells; j++) {
+            float h = heightAt(i, j);
+            glm::vec3 normal = glm::normalize(glm::vec3(heightAt(i - 1, j) - heightAt(i + 1, j),
+                                                        2.0f * SAMPLE_SPACING,
+                                                        heightAt(i, j - 1) - heightAt(i, j + 1)));
+
+            // Sample the middle of the surface block's texture for a flat distant colour
+            TextureAtlas::TextureUV uv = VoxelChunk::getTextureForBlock(topBlocks[(i + 1) * samples + (j + 1)], 4);
+            float u = (uv.u1 + uv.u2) * 0.5f;
+            float v = (uv.v1 + uv.v2) * 0.5f;
+
+            float vertex[] = {
+                originX + i * SAMPLE_SPACING, h, originZ + j * SAMPLE_SPACING,
+                normal.x, normal.y, normal.z,
+                u, v
+            };
+            vertices.insert(vertices.end(), vertex, vertex + 8);
+        }
+    }
+
+    for (int i = 0; i < cells; i++) {
+        for (int j = 0; j < cells; j++) {
+            unsigned int a = i * (cells + 1) + j;
+            unsigned int b = (i + 1) * (cells + 1) + j;
+            unsigned int quad[] = { a, b, b + 1, b + 1, a + 1, a };
+            indices.insert(indices.end(), quad, quad + 6);
+        }
+    }
+
+    // Same layout as chunk meshes: position, normal, texture coordinate
+    Tile tile;
+    tile.mesh = device.createMesh(RenderDevice::terrainLayout());
+    device.updateMesh(tile.mesh, vertices.data(), vertices.size(), indices.data(), indices.size(), BufferUsage::STATIC);
+    tile.indexCount = indices.size();
+    tile.bytes = vertices.size() * sizeof(float) + indices.size() * sizeof(unsigned int);
+    MemoryStats::add(MemoryCategory::FAR_TERRAIN, static_cast<long long>(tile.bytes));
+    tiles[tileCoord] = tile;
+}
+
+void FarTerrain::destroyTile(Tile& tile) {
+    if (tile.mesh) device.deleteMesh(tile.mesh);
+    MemoryStats::add(MemoryCategory::FAR_TERRAIN, -static_cast<long long>(tile.bytes));
+    tile = Tile();
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <vector>
+#include "chunk_coord.h"
+#include "terrain_generator.h"
+#include "render_device.h"
+
+/**
+ * FarTerrain draws a cheap heightfield horizon beyond the voxel load distance.
+ * It only evaluates the 2D height/biome part of terrain generation at a coarse
+ * spacing (no caves, ores or block arrays) and meshes it in large tiles.
+ */
+class FarTerrain {
+public:
+    static const int TILE_CHUNKS = 8;                 // Chunks covered by one tile along each axis
+    static const int SAMPLE_SPACING = 4;              // Blocks between height samples
+    static const int FAR_DISTANCE = 64;               // Horizon radius in chunks
+    static const int MAX_TILE_BUILDS_PER_FRAME = 2;   // Spread tile generation across frames
+
+    // innerDistance: radius in chunks already covered by voxel chunks
+    FarTerrain(const TerrainGenerator& generator, int innerDistance, RenderDevice& device);
+    ~FarTerrain();
+
+    // Queue/evict tiles around the player and build a few pending ones
+    void update(const glm::vec3& playerPosition);
+
+    // Draw all built tiles with the terrain shader, which must be in use
+    void render(UniformLocation modelLocation);
+
+    // Change the radius covered by voxel chunks; missing tiles are queued on the next update
+    void setInnerDistance(int distance);
+
+    int getTileCount() const { return static_cast<int>(tiles.size()); }
+
+    // Release every tile; call before the graphics context goes away
+    void clear();
+
+private:
+    struct Tile {
+        MeshHandle mesh = 0;
+        size_t indexCount = 0;
+        size_t bytes = 0;
+    };
+
+    void buildTile(const ChunkCoord& tileCoord);
+    void destroyTile(Tile& tile);
+    bool tileInRing(const ChunkCoord& tileCoord, const ChunkCoord& playerChunk, int outerDistance) const;
+    float tileDistanceSquared(const ChunkCoord& tileCoord, const ChunkCoord& playerChunk) const;
+
+    const TerrainGenerator& generator;
+    RenderDevice& device;
+    int innerDistance;
+    std::unordered_map<ChunkCoord, Tile, ChunkCoordHash> tiles;
+    std::vector<ChunkCoord> pendingTiles;   // Sorted farthest first so the nearest pops off the back
+    ChunkCoord lastPlayerChunk;
+    bool hasPlayerChunk;
+};
@@ -0,0 +1,280 @@
+#include "gl_render_device.h"
+#include "shader.h"
+#include <algorithm>
+#include <cstring>
+#include <glm/gtc/type_ptr.hpp>
+
+namespace {
+
+GLenum toGL(PrimitiveType primitive) {
+    switch (primitive) {
+        case PrimitiveType::TRIANGLE_FAN: return GL_TRIANGLE_FAN;
+        case PrimitiveType::LINES:        return GL_LINES;
+        default:                          return GL_TRIANGLES;
+    }
+}
+
+GLenum toGL(BufferUsage usage) {
+    return usage == BufferUsage::DYNAMIC ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW;
+}
+
+// Block names in UniformBlock order
+const char* const UNIFORM_BLOCK_NAMES[] = { "Camera" };
+static_assert(sizeof(UNIFORM_BLOCK_NAMES) / sizeof(UNIFORM_BLOCK_NAMES[0]) == static_cast<size_t>(UniformBlock::COUNT),
+              "every uniform block needs a name");
+
+}
+
+MeshHandle GLRenderDevice::createMesh(const VertexLayout& layout) {
+    GLuint VAO = 0;
+    Mesh mesh;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &mesh.VBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+
+    int stride = 0;
+    for (int i = 0; i < layout.attributeCount; i++) {
+        stride += layout.attributeSizes[i];
+    }
+    int offset = 0;
+    for (int i = 0; i < layout.attributeCount; i++) {
+        glVertexAttribPointer(i, layout.attributeSizes[i], GL_FLOAT, GL_FALSE, stride * sizeof(float),
+                              (void*)(offset * sizeof(float)));
+        glEnableVertexAttribArray(i);
+        offset += layout.attributeSizes[i];
+    }
+    glBindVertexArray(0);
+
+    meshes[VAO] = mesh;
+    return VAO;
+}
+
+void GLRenderDevice::updateMesh(MeshHandle handle, const float* vertices, size_t floatCount,
+                                const unsigned int* indices, size_t indexCount, BufferUsage usage) {
+    auto it = meshes.find(handle);
+    if (it == meshes.end()) return;
+    Mesh& mesh = it->second;
+
+    glBindVertexArray(handle);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+    glBufferData(GL_ARRAY_BUFFER, floatCount * sizeof(float), vertices, toGL(usage));
+
+    if (indices) {
+        // The element buffer binding is VAO state, so bind it while the VAO is
+        if (!mesh.EBO) glGenBuffers(1, &mesh.EBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(unsigned int), indices, toGL(usage));
+    }
+    glBindVertexArray(0);
+}
+
+void GLRenderDevice::updateIndices(MeshHandle handle, const unsigned int* indices, size_t indexCount) {
+    auto it = meshes.find(handle);
+    if (it == meshes.end() || !it->second.EBO) return;
+
+    glBindVertexArray(handle);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, it->second.EBO);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indexCount * sizeof(unsigned int), indices);
+    glBindVertexArray(0);
+}
+
+void GLRenderDevice::deleteMesh(MeshHandle handle) {
+    auto it = meshes.find(handle);
+    if (it == meshes.end()) return;
+    GLuint VAO = handle;
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &it->second.VBO);
+    if (it->second.EBO) glDeleteBuffers(1, &it->second.EBO);
+    meshes.erase(it);
+}
+
+void GLRenderDevice::drawMesh(MeshHandle handle, PrimitiveType primitive, size_t count, size_t first) {
+    auto it = meshes.find(handle);
+    if (it == meshes.end()) return;
+
+    glBindVertexArray(handle);
+    if (it->second.EBO) {
+        glDrawElements(toGL(primitive), static_cast<GLsizei>(count), GL_UNSIGNED_INT,
+                       (void*)(first * sizeof(unsigned int)));
+    } else {
+        glDrawArrays(toGL(primitive), static_cast<GLint>(first), static_cast<GLsizei>(count));
+    }
+    glBindVertexArray(0);
+}
+
+void GLRenderDevice::drawMeshRanges(MeshHandle handle, PrimitiveType primitive, const size_t* firsts,
+                                    const size_t* counts, int rangeCount) {
+    auto it = meshes.find(handle);
+    if (it == meshes.end() || !it->second.EBO) return;
+
+    // glMultiDrawElements takes GL-typed arrays; callers pass a handful of ranges
+    const int BATCH = 8;
+    GLsizei glCounts[BATCH];
+    const void* offsets[BATCH];
+    glBindVertexArray(handle);
+    for (int start = 0; start < rangeCount; start += BATCH) {
+        int batch = std::min(BATCH, rangeCount - start);
+        for (int i = 0; i < batch; i++) {
+            glCounts[i] = static_cast<GLsizei>(counts[start + i]);
+            offsets[i] = (const void*)(firsts[start + i] * sizeof(unsigned int));
+        }
+        glMultiDrawElements(toGL(primitive), glCounts, GL_UNSIGNED_INT, offsets, batch);
+    }
+    glBindVertexArray(0);
+}
+
+unsigned int GLRenderDevice::createProgram(const char* vertexSource, const char* fragmentSource) {
+    GLuint program = createShader(vertexSource, fragmentSource);
+    if (program) reflectProgram(program);
+    return program;
+}
+
+void GLRenderDevice::reflectProgram(GLuint program) {
+    std::vector<Uniform>& uniforms = programUniforms[program];
+    uniforms.clear();
+
+    GLint count = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+    for (GLint i = 0; i < count; i++) {
+        char name[128];
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(program, static_cast<GLuint>(i), sizeof(name), &length, &size, &type, name);
+        // Block members have no location; arrays are listed as "name[0]"
+        GLint location = glGetUniformLocation(program, name);
+        if (location < 0) continue;
+        char* bracket = std::strchr(name, '[');
+        if (bracket) *bracket = '\0';
+        uniforms.push_back({ name, location });
+    }
+
+    for (int block = 0; block < static_cast<int>(UniformBlock::COUNT); block++) {
+        GLuint index = glGetUniformBlockIndex(program, UNIFORM_BLOCK_NAMES[block]);
+        if (index != GL_INVALID_INDEX) {
+            glUniformBlockBinding(program, index, static_cast<GLuint>(block));
+        }
+    }
+}
+
+void GLRenderDevice::deleteProgram(unsigned int program) {
+    programUniforms.erase(program);
+    glDeleteProgram(program);
+}
+
+void GLRenderDevice::useProgram(unsigned int program) {
+    glUseProgram(program);
+}
+
+UniformLocation GLRenderDevice::getUniformLocation(unsigned int program, const char* name) {
+    auto it = programUniforms.find(program);
+    if (it == programUniforms.end()) return -1;
+    // A handful of uniforms per program, so a scan beats hashing the name
+    for (const Uniform& uniform : it->second) {
+        if (uniform.name == name) return uniform.location;
+    }
+    return -1;
+}
+
+void GLRenderDevice::setUniform(UniformLocation location, const glm::mat4& value) {
+    glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void GLRenderDevice::setUniform(UniformLocation location, const glm::vec3& value) {
+    glUniform3f(location, value.x, value.y, value.z);
+}
+
+void GLRenderDevice::setUniform(UniformLocation location, float value) {
+    glUniform1f(location, value);
+}
+
+void GLRenderDevice::setUniform(UniformLocation location, int value) {
+    glUniform1i(location, value);
+}
+
+void GLRenderDevice::setUniform(unsigned int program, const char* name, const glm::mat4& value) {
+    setUniform(getUniformLocation(program, name), value);
+}
+
+void GLRenderDevice::setUniform(unsigned int program, const char* name, const glm::vec3& value) {
+    setUniform(getUniformLocation(program, name), value);
+}
+
+void GLRenderDevice::setUniform(unsigned int program, const char* name, float value) {
+    setUniform(getUniformLocation(program, name), value);
+}
+
+void GLRenderDevice::setUniform(unsigned int program, const char* name, int value) {
+    setUniform(getUniformLocation(program, name), value);
+}
+
+UniformBufferHandle GLRenderDevice::createUniformBuffer(UniformBlock block, size_t bytes) {
+    GLuint buffer = 0;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferData(GL_UNIFORM_BUFFER, bytes, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, static_cast<GLuint>(block), buffer);
+    return buffer;
+}
+
+void GLRenderDevice::updateUniformBuffer(UniformBufferHandle buffer, const void* data, size_t bytes) {
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, bytes, data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void GLRenderDevice::deleteUniformBuffer(UniformBufferHandle buffer) {
+    GLuint handle = buffer;
+    glDeleteBuffers(1, &handle);
+}
+
+unsigned int GLRenderDevice::createTexture(int width, int height, const unsigned char* rgba) {
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+void GLRenderDevice::deleteTexture(unsigned int texture) {
+    GLuint handle = texture;
+    glDeleteTextures(1, &handle);
+}
+
+void GLRenderDevice::bindTexture(int unit, unsigned int texture) {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+void GLRenderDevice::setDepthTest(bool enabled) {
+    if (enabled) glEnable(GL_DEPTH_TEST);
+    else glDisable(GL_DEPTH_TEST);
+}
+
+void GLRenderDevice::setDepthWrite(bool enabled) {
+    glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+}
+
+void GLRenderDevice::setBlending(bool enabled) {
+    if (enabled) {
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    } else {
+        glDisable(GL_BLEND);
+    }
+}
+
+void GLRenderDevice::setWireframe(bool enabled, float lineWidth) {
+    glPolygonMode(GL_FRONT_AND_BACK, enabled ? GL_LINE : GL_FILL);
+    glLineWidth(lineWidth);
+}
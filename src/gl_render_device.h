@@ -0,0 +1,63 @@
+#pragma once
+
+#include <glad/gl.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "render_device.h"
+
+/**
+ * GLRenderDevice implements RenderDevice on OpenGL 3.3. A mesh is a VAO with
+ * its vertex buffer and (created on first indexed upload) element buffer.
+ * Each program keeps a table of its active uniforms, read once after linking.
+ * Needs a current context for every call except construction.
+ */
+class GLRenderDevice : public RenderDevice {
+public:
+    MeshHandle createMesh(const VertexLayout& layout) override;
+    void updateMesh(MeshHandle mesh, const float* vertices, size_t floatCount,
+                    const unsigned int* indices, size_t indexCount, BufferUsage usage) override;
+    void updateIndices(MeshHandle mesh, const unsigned int* indices, size_t indexCount) override;
+    void deleteMesh(MeshHandle mesh) override;
+    void drawMesh(MeshHandle mesh, PrimitiveType primitive, size_t count, size_t first) override;
+    void drawMeshRanges(MeshHandle mesh, PrimitiveType primitive, const size_t* firsts,
+                        const size_t* counts, int rangeCount) override;
+    unsigned int createProgram(const char* vertexSource, const char* fragmentSource) override;
+    void deleteProgram(unsigned int program) override;
+    void useProgram(unsigned int program) override;
+    UniformLocation getUniformLocation(unsigned int program, const char* name) override;
+    void setUniform(UniformLocation location, const glm::mat4& value) override;
+    void setUniform(UniformLocation location, const glm::vec3& value) override;
+    void setUniform(UniformLocation location, float value) override;
+    void setUniform(UniformLocation location, int value) override;
+    void setUniform(unsigned int program, const char* name, const glm::mat4& value) override;
+    void setUniform(unsigned int program, const char* name, const glm::vec3& value) override;
+    void setUniform(unsigned int program, const char* name, float value) override;
+    void setUniform(unsigned int program, const char* name, int value) override;
+    UniformBufferHandle createUniformBuffer(UniformBlock block, size_t bytes) override;
+    void updateUniformBuffer(UniformBufferHandle buffer, const void* data, size_t bytes) override;
+    void deleteUniformBuffer(UniformBufferHandle buffer) override;
+    unsigned int createTexture(int width, int height, const unsigned char* rgba) override;
+    void deleteTexture(unsigned int texture) override;
+    void bindTexture(int unit, unsigned int texture) override;
+    void setDepthTest(bool enabled) override;
+    void setDepthWrite(bool enabled) override;
+    void setBlending(bool enabled) override;
+    void setWireframe(bool enabled, float lineWidth) override;
+
+private:
+    struct Mesh {
+        GLuint VBO = 0, EBO = 0;
+    };
+
+    struct Uniform {
+        std::string name;
+        GLint location;
+    };
+
+    // Read the active uniforms and bind the shared uniform blocks of a new program
+    void reflectProgram(GLuint program);
+
+    std::unordered_map<MeshHandle, Mesh> meshes;   // Keyed by VAO
+    std::unordered_map<unsigned int, std::vector<Uniform>> programUniforms;
+};
@@ -0,0 +1,281 @@
+#include "log.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+long long nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Every site that has ever suppressed a message; sites are statics, so the
+// list only grows
+std::atomic<LogSite*> suppressingSites{nullptr};
+
+struct Slot {
+    std::atomic<size_t> sequence;   // Bounded MPMC queue turn counter (Vyukov)
+    LogLevel level;
+    size_t length;
+    char text[Log::MAX_MESSAGE];
+};
+
+/**
+ * The queue and its writer thread. Producers claim a slot with one CAS and
+ * publish it with a release store; the writer thread is the only consumer.
+ * Producers never take the mutex, they only poke the condition variable, and
+ * the writer also wakes on a short timeout in case a notify raced its wait.
+ */
+class Logger {
+public:
+    Logger() : enqueuePos(0), dequeuePos(0), queued(0), written(0), dropped(0),
+               pending(false), stopping(false) {
+        for (size_t i = 0; i < Log::QUEUE_SIZE; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        writer = std::thread(&Logger::run, this);
+    }
+
+    ~Logger() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        writer.join();
+    }
+
+    bool push(LogLevel messageLevel, const char* text, size_t length) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots[pos & (Log::QUEUE_SIZE - 1)];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            if (sequence == pos) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (sequence < pos) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->level = messageLevel;
+        slot->length = length < Log::MAX_MESSAGE ? length : Log::MAX_MESSAGE;
+        std::memcpy(slot->text, text, slot->length);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        queued.fetch_add(1, std::memory_order_release);
+
+        if (!pending.exchange(true, std::memory_order_acq_rel)) {
+            wake.notify_one();
+        }
+        return true;
+    }
+
+    void flush() {
+        size_t target = queued.load(std::memory_order_acquire);
+        std::unique_lock<std::mutex> lock(mutex);
+        pending.store(true, std::memory_order_release);
+        wake.notify_one();
+        flushed.wait(lock, [&] { return written.load(std::memory_order_acquire) >= target; });
+    }
+
+    size_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+    std::atomic<LogLevel> level{LogLevel::Info};
+
+private:
+    bool pop(LogLevel& messageLevel, char* text, size_t& length) {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        Slot& slot = slots[pos & (Log::QUEUE_SIZE - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != pos + 1) return false;
+
+        messageLevel = slot.level;
+        length = slot.length;
+        std::memcpy(text, slot.text, length);
+        slot.sequence.store(pos + Log::QUEUE_SIZE, std::memory_order_release);
+        dequeuePos.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void run() {
+        char text[Log::MAX_MESSAGE];
+        for (;;) {
+            pending.store(false, std::memory_order_release);
+
+            LogLevel messageLevel;
+            size_t length;
+            size_t count = 0;
+            while (pop(messageLevel, text, length)) {
+                std::ostream& out = messageLevel >= LogLevel::Warning ? std::cerr : std::cout;
+                switch (messageLevel) {
+                    case LogLevel::Debug: out << "debug: "; break;
+                    case LogLevel::Warning: out << "warning: "; break;
+                    case LogLevel::Error: out << "error: "; break;
+                    default: break;
+                }
+                out.write(text, length);
+                out << '\n';
+                count++;
+            }
+
+            count += reportSuppressed();
+
+            // One flush per batch instead of one per message
+            if (count > 0) {
+                std::cout.flush();
+                std::cerr.flush();
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            written.fetch_add(count, std::memory_order_release);
+            flushed.notify_all();
+            if (stopping && written.load(std::memory_order_relaxed) >= queued.load(std::memory_order_acquire)) {
+                return;
+            }
+            wake.wait_for(lock, std::chrono::milliseconds(20), [&] {
+                return stopping || pending.load(std::memory_order_acquire);
+            });
+        }
+    }
+
+    // Summary lines for sites whose rate limit second is over but whose
+    // suppressed messages no later message reported
+    size_t reportSuppressed() {
+        long long now = nowMs();
+        size_t reported = 0;
+        for (LogSite* site = suppressingSites.load(std::memory_order_acquire); site; site = site->nextListed) {
+            if (site->suppressed.load(std::memory_order_relaxed) == 0) continue;
+            if (now - site->windowStartMs.load(std::memory_order_relaxed) < 1000) continue;
+            int count = site->suppressed.exchange(0, std::memory_order_relaxed);
+            if (count == 0) continue;
+            std::ostream& out = site->level >= LogLevel::Warning ? std::cerr : std::cout;
+            out << count << " messages from " << site->file << ':' << site->line << " suppressed\n";
+            reported++;
+        }
+        return reported;
+    }
+
+    Slot slots[Log::QUEUE_SIZE];
+    std::atomic<size_t> enqueuePos;
+    std::atomic<size_t> dequeuePos;
+    std::atomic<size_t> queued;
+    std::atomic<size_t> written;
+    std::atomic<size_t> dropped;
+    std::atomic<bool> pending;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable flushed;
+    bool stopping;
+    std::thread writer;
+};
+
+Logger& logger() {
+    static Logger instance;
+    return instance;
+}
+
+}
+
+void Log::setLevel(LogLevel level) {
+    logger().level.store(level, std::memory_order_relaxed);
+}
+
+LogLevel Log::getLevel() {
+    return logger().level.load(std::memory_order_relaxed);
+}
+
+bool Log::isEnabled(LogLevel level) {
+    return level >= logger().level.load(std::memory_order_relaxed);
+}
+
+bool Log::push(LogLevel level, const char* text, size_t length) {
+    return logger().push(level, text, length);
+}
+
+void Log::flush() {
+    logger().flush();
+}
+
+size_t Log::getDroppedCount() {
+    return logger().getDropped();
+}
+
+bool LogSite::admit(int& suppressedSince) {
+    long long now = nowMs();
+    long long start = windowStartMs.load(std::memory_order_relaxed);
+    if (now - start >= 1000 && windowStartMs.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+        windowCount.store(0, std::memory_order_relaxed);
+    }
+    if (windowCount.fetch_add(1, std::memory_order_relaxed) >= Log::SITE_MESSAGES_PER_SECOND) {
+        suppressed.fetch_add(1, std::memory_order_relaxed);
+        if (!listed.exchange(true, std::memory_order_relaxed)) {
+            nextListed = suppressingSites.load(std::memory_order_relaxed);
+            while (!suppressingSites.compare_exchange_weak(nextListed, this, std::memory_order_release,
+                                                           std::memory_order_relaxed)) {}
+        }
+        return false;
+    }
+    suppressedSince = suppressed.exchange(0, std::memory_order_relaxed);
+    return true;
+}
+
+LogLine::~LogLine() {
+    if (suppressedSince > 0) {
+        *this << " (" << suppressedSince << " similar messages suppressed)";
+    }
+    Log::push(level, buffer, length);
+}
+
+void LogLine::append(const char* text, size_t count) {
+    size_t room = Log::MAX_MESSAGE - length;
+    if (count > room) count = room;
+    std::memcpy(buffer + length, text, count);
+    length += count;
+}
+
+LogLine& LogLine::operator<<(const char* text) {
+    if (!text) text = "(null)";
+    append(text, std::strlen(text));
+    return *this;
+}
+
+LogLine& LogLine::operator<<(char c) {
+    append(&c, 1);
+    return *this;
+}
+
+LogLine& LogLine::operator<<(double value) {
+    char text[32];
+    int count = std::snprintf(text, sizeof(text), "%g", value);
+    if (count > 0) append(text, static_cast<size_t>(count));
+    return *this;
+}
+
+LogLine& LogLine::operator<<(const void* pointer) {
+    char text[32];
+    int count = std::snprintf(text, sizeof(text), "%p", pointer);
+    if (count > 0) append(text, static_cast<size_t>(count));
+    return *this;
+}
+
+LogLine& LogLine::appendSigned(long long value) {
+    char text[24];
+    int count = std::snprintf(text, sizeof(text), "%lld", value);
+    if (count > 0) append(text, static_cast<size_t>(count));
+    return *this;
+}
+
+LogLine& LogLine::appendUnsigned(unsigned long long value) {
+    char text[24];
+    int count = std::snprintf(text, sizeof(text), "%llu", value);
+    if (count > 0) append(text, static_cast<size_t>(count));
+    return *this;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+enum class LogLevel { Debug, Info, Warning, Error };
+
+// Messages below this level compile to nothing: 0 debug, 1 info, 2 warning,
+// 3 error. Release builds drop debug messages unless it is set explicitly.
+#ifndef HACKVOXEL_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define HACKVOXEL_LOG_MIN_LEVEL 1
+#else
+#define HACKVOXEL_LOG_MIN_LEVEL 0
+#endif
+#endif
+
+/**
+ * Log is an asynchronous, leveled console logger. Logging formats the message
+ * into a fixed buffer and pushes it onto a bounded lock-free queue; a
+ * background thread writes the queue out, so the game loop never waits on
+ * console I/O. Debug and info go to stdout, warnings and errors to stderr.
+ *
+ * Each LOG_DEBUG and LOG_INFO call site is rate limited to a few messages per
+ * second; repeats past that are counted and reported with the next message
+ * that gets through, or on their own once the site's second is over.
+ * Warnings and errors are never rate limited. When the queue is full messages
+ * are dropped rather than blocking.
+ *
+ *   LOG_INFO("Loaded " << count << " chunks");
+ */
+class Log {
+public:
+    static const size_t MAX_MESSAGE = 256;    // Longer messages are truncated
+    static const size_t QUEUE_SIZE = 1024;    // Power of two
+    static const int SITE_MESSAGES_PER_SECOND = 5;
+
+    // Runtime threshold on top of HACKVOXEL_LOG_MIN_LEVEL; INFO by default
+    static void setLevel(LogLevel level);
+    static LogLevel getLevel();
+    static bool isEnabled(LogLevel level);
+
+    // Queue a finished message; false if the queue was full
+    static bool push(LogLevel level, const char* text, size_t length);
+
+    // Block until everything queued so far has been written
+    static void flush();
+
+    // Messages lost to a full queue since startup
+    static size_t getDroppedCount();
+};
+
+// Rate limit state of one LOG_DEBUG or LOG_INFO call site
+struct LogSite {
+    LogSite(LogLevel level, const char* file, int line) : level(level), file(file), line(line) {}
+
+    LogLevel level;
+    const char* file;
+    int line;
+    std::atomic<long long> windowStartMs{0};
+    std::atomic<int> windowCount{0};
+    std::atomic<int> suppressed{0};
+
+    // Sites that have suppressed a message, so the writer thread can report
+    // counts that no later message picked up
+    std::atomic<bool> listed{false};
+    LogSite* nextListed = nullptr;
+
+    // Whether a message from this site may be logged now; the count of
+    // messages suppressed since the last one goes to suppressedSince
+    bool admit(int& suppressedSince);
+};
+
+// Formats one message into a fixed buffer and queues it on destruction.
+// Never allocates, so it is safe to use on the frame path.
+class LogLine {
+public:
+    LogLine(LogLevel level, int suppressedSince) : level(level), length(0), suppressedSince(suppressedSince) {}
+    ~LogLine();
+
+    LogLine(const LogLine&) = delete;
+    LogLine& operator=(const LogLine&) = delete;
+
+    LogLine& operator<<(const char* text);
+    LogLine& operator<<(const std::string& text) { return *this << text.c_str(); }
+    LogLine& operator<<(char c);
+    LogLine& operator<<(bool value) { return *this << (value ? "true" : "false"); }
+    LogLine& operator<<(double value);
+    LogLine& operator<<(float value) { return *this << static_cast<double>(value); }
+    LogLine& operator<<(const void* pointer);
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value, LogLine&>::type operator<<(T value) {
+        if (std::is_signed<T>::value) return appendSigned(static_cast<long long>(value));
+        return appendUnsigned(static_cast<unsigned long long>(value));
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_enum<T>::value, LogLine&>::type operator<<(T value) {
+        return *this << static_cast<typename std::underlying_type<T>::type>(value);
+    }
+
+private:
+    LogLine& appendSigned(long long value);
+    LogLine& appendUnsigned(unsigned long long value);
+    void append(const char* text, size_t count);
+
+    LogLevel level;
+    size_t length;
+    int suppressedSince;
+    char buffer[Log::MAX_MESSAGE];
+};
+
+#define HACKVOXEL_LOG(level, minimum, message)                                  \
+    do {                                                                        \
+        if (HACKVOXEL_LOG_MIN_LEVEL <= (minimum) && Log::isEnabled(level)) {    \
+            if ((level) >= LogLevel::Warning) {                                 \
+                LogLine(level, 0) << message;                                   \
+            } else {                                                            \
+                static LogSite logSite(level, __FILE__, __LINE__);              \
+                int logSuppressed = 0;                                          \
+                if (logSite.admit(logSuppressed)) {                             \
+                    LogLine(level, logSuppressed) << message;                   \
+                }                                                               \
+            }                                                                   \
+        }                                                                       \
+    } while (0)
+
+#define LOG_DEBUG(message) HACKVOXEL_LOG(LogLevel::Debug, 0, message)
+#define LOG_INFO(message) HACKVOXEL_LOG(LogLevel::Info, 1, message)
+#define LOG_WARNING(message) HACKVOXEL_LOG(LogLevel::Warning, 2, message)
+#define LOG_ERROR(message) HACKVOXEL_LOG(LogLevel::Error, 3, message)
@@ -6,12 +6,13 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
-#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <string>
 
 // ============================================================================
 // PROJECT INCLUDES
 // ============================================================================
-#include "shader.h"
 #include "camera.h"
 #include "voxel_chunk.h"
 #include "player.h"
@@ -21,9 +22,15 @@
 #include "water_shader.h"
 #include "ui.h"
 #include "block_interaction.h"
+#include "gl_render_device.h"
+#include "log.h"
+#include "memory_stats.h"
+#include "profiler.h"
+#include "trace.h"
 
 // Global variables
-ChunkManager chunkManager;
+GLRenderDevice renderDevice;
+ChunkManager chunkManager(renderDevice);
 TextureAtlas* textureAtlas = nullptr;
 Skybox* skybox = nullptr;
 WaterShader* waterShader = nullptr;
@@ -31,6 +38,11 @@ UI* gameUI = nullptr;
 BlockInteraction* blockInteraction = nullptr;
 float timeOfDay = 0.5f; // 0.0 = midnight, 0.5 = noon, 1.0 = midnight
 
+// Timeline capture (F9 or --trace-frames N); handled between frames so no scope is split
+bool traceToggleRequested = false;
+int traceFramesLeft = 0;
+int traceCaptureCount = 0;
+
 // Mouse state tracking for click detection
 bool leftMousePressed = false;
 bool rightMousePressed = false;
@@ -79,13 +91,25 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
                 BlockType targetedBlock = chunkManager.getBlockType(hit.blockPosition);
                 if (targetedBlock != BlockType::AIR) {
                     gameUI->setSelectedBlockType(targetedBlock);
-                    std::cout << "Picked block: " << gameUI->getBlockName(targetedBlock) << std::endl;
+                    LOG_INFO("Picked block: " << gameUI->getBlockName(targetedBlock));
                 }
             }
         }
     }
 }
 
+// Movement keys held this frame, for the player and camera
+MovementInput readMovementInput(GLFWwindow* window) {
+    MovementInput input;
+    input.forward = glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS;
+    input.backward = glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS;
+    input.left = glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS;
+    input.right = glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS;
+    input.up = glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS;
+    input.sprint = glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS;
+    return input;
+}
+
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset) {
     if (gameUI && !gameUI->isInventoryOpen()) {
         // Only handle hotbar scrolling when inventory is closed
@@ -110,13 +134,28 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
             gameUI->toggleInventory();
         }
         
-        // F3 for debug info toggle (placeholder for future implementation)
+        // F3 toggles the profiler overlay
         if (key == GLFW_KEY_F3) {
-            std::cout << "Debug info toggled (not implemented yet)" << std::endl;
+            gameUI->toggleDebugOverlay();
+        }
+        
+        // F9 starts a timeline capture, pressed again writes it out
+        if (key == GLFW_KEY_F9) {
+            traceToggleRequested = true;
         }
     }
 }
 
+// Stop the running timeline capture and write it next to the executable
+void finishTraceCapture() {
+    Trace::stop();
+    std::string path = "hackvoxel_trace_" + std::to_string(++traceCaptureCount) + ".json";
+    if (Trace::write(path)) {
+        LOG_INFO("Wrote " << Trace::getEventCount() << " trace events to " << path << " ("
+                 << Trace::getDroppedCount() << " dropped)");
+    }
+}
+
 // Enhanced atmospheric color calculation for smooth transitions
 glm::vec3 calculateAtmosphericColor(float timeOfDay) {
     // Smooth interpolation between different times of day
@@ -172,13 +211,20 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoord;
 
-uniform mat4 model, view, projection;
+uniform mat4 model;
+
+layout(std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 cameraPosition;
+};
 
 out vec2 TexCoord;
 out vec3 Normal;
 
 void main() {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = viewProjection * model * vec4(aPos, 1.0);
     TexCoord = aTexCoord;
     Normal = aNormal;
 }
@@ -198,12 +244,8 @@ void main() {
     float diff = max(dot(norm, -lightDirection), 0.3); // basic lambert + ambient floor
     vec4 texColor = texture(ourTexture, TexCoord);
 
-    // Water transparency heuristic
-    if (texColor.r < 0.2 && texColor.g > 0.3 && texColor.g < 0.7 && texColor.b > 0.7) {
-        FragColor = vec4(texColor.rgb * diff, 0.6);
-    } else {
-        FragColor = vec4(texColor.rgb * diff, texColor.a);
-    }
+    // Opaque pass; water is drawn separately by the water shader
+    FragColor = vec4(texColor.rgb * diff, 1.0);
 }
 )";
 
@@ -222,14 +264,30 @@ void main() {
 // ============================================================================
 // MAIN FUNCTION - APPLICATION ENTRY POINT
 // ============================================================================
-int main()
+int main(int argc, char** argv)
 {
+    // --trace-frames N captures the first N frames to hackvoxel_trace_1.json,
+    // --verbose also prints debug messages (when they are compiled in),
+    // --memory-budget name=MB caps a memory category (repeatable)
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--trace-frames") == 0 && i + 1 < argc) {
+            traceFramesLeft = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--memory-budget") == 0 && i + 1 < argc) {
+            if (!MemoryStats::parseBudget(argv[++i])) {
+                LOG_ERROR("Bad memory budget " << argv[i] << ", expected name=MB (e.g. meshes=256)");
+            }
+        } else if (std::strcmp(argv[i], "--verbose") == 0) {
+            Log::setLevel(LogLevel::Debug);
+        }
+    }
+    Trace::setThreadName("main");
+    
     // Init GLFW first
     if (!glfwInit()) {
-        std::cerr << "Failed to initialize GLFW" << std::endl;
+        LOG_ERROR("Failed to initialize GLFW");
         return -1;
     }
-    std::cout << "GLFW initialized" << std::endl;
+    LOG_INFO("GLFW initialized");
     
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
@@ -237,11 +295,11 @@ int main()
     GLFWwindow *window = glfwCreateWindow(800, 600, "HackVoxel", nullptr, nullptr);
     if (!window)
     {
-        std::cerr << "Failed to create window" << std::endl;
+        LOG_ERROR("Failed to create window");
         glfwTerminate();
         return -1;
     }
-    std::cout << "Window created" << std::endl;
+    LOG_INFO("Window created");
     
     glfwMakeContextCurrent(window);
     glfwSetCursorPosCallback(window, mouse_callback);
@@ -251,75 +309,126 @@ int main()
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     
     if (!gladLoadGL((GLADloadfunc)glfwGetProcAddress)) {
-        std::cerr << "Failed to load OpenGL" << std::endl;
+        LOG_ERROR("Failed to load OpenGL");
         return -1;
     }
-    std::cout << "OpenGL loaded" << std::endl;    glEnable(GL_DEPTH_TEST);
-    
-    // Enable blending for transparency (water blocks)
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    LOG_INFO("OpenGL loaded");    renderDevice.setDepthTest(true);
     
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);// Create texture atlas
     textureAtlas = new TextureAtlas();
     if (!textureAtlas->initialize()) {
-        std::cerr << "Failed to initialize texture atlas!" << std::endl;
+        LOG_ERROR("Failed to initialize texture atlas!");
         return -1;
-    }    VoxelChunk::textureAtlas = textureAtlas; // Set static reference
-    std::cout << "Texture atlas created successfully" << std::endl;    // Initialize skybox
+    }
+    LOG_INFO("Texture atlas created successfully");    // Initialize skybox
     skybox = new Skybox();
-    if (!skybox->initialize()) {
-        std::cerr << "Failed to initialize skybox!" << std::endl;
+    if (!skybox->initialize(renderDevice)) {
+        LOG_ERROR("Failed to initialize skybox!");
         return -1;
     }
-    std::cout << "Skybox created successfully" << std::endl;
+    LOG_INFO("Skybox created successfully");
     
     // Initialize water shader
     waterShader = new WaterShader();
-    if (!waterShader->initialize()) {
-        std::cerr << "Failed to initialize water shader!" << std::endl;
+    if (!waterShader->initialize(renderDevice)) {
+        LOG_ERROR("Failed to initialize water shader!");
         return -1;
     }
-    std::cout << "Water shader created successfully" << std::endl;
+    waterShader->use();
+    waterShader->setWaterLevel(TerrainGenerator::WATER_LEVEL + 1.0f);
+    waterShader->setLightDirection(glm::normalize(glm::vec3(0.3f, -1.0f, 0.2f)));
+    LOG_INFO("Water shader created successfully");
     
     // Initialize UI system
     gameUI = new UI();
-    if (!gameUI->initialize()) {
-        std::cerr << "Failed to initialize UI system!" << std::endl;
+    if (!gameUI->initialize(renderDevice)) {
+        LOG_ERROR("Failed to initialize UI system!");
         return -1;
     }
-    std::cout << "UI system created successfully" << std::endl;
+    LOG_INFO("UI system created successfully");
     
     // Initialize block interaction system
     blockInteraction = new BlockInteraction();
-    if (!blockInteraction->initialize()) {
-        std::cerr << "Failed to initialize block interaction system!" << std::endl;
+    if (!blockInteraction->initialize(renderDevice)) {
+        LOG_ERROR("Failed to initialize block interaction system!");
         return -1;
     }
-    std::cout << "Block interaction system created successfully" << std::endl;
+    LOG_INFO("Block interaction system created successfully");
     
     // Initialize chunk manager (infinite world system)
-    std::cout << "Initializing chunk manager for infinite world..." << std::endl;
+    LOG_INFO("Initializing chunk manager for infinite world...");
+    // Pregenerated spawn area (written by hackvoxel-gen --output spawn.hvw), if present
+    chunkManager.openWorldCache("spawn.hvw");
     chunkManager.initialize(player.position);
     
+    // Drop the player onto the terrain surface at the spawn column
+    int spawnSurface = chunkManager.getSurfaceHeight(player.position.x, player.position.z);
+    if (spawnSurface >= 0) {
+        player.position.y = spawnSurface + 1.0f;
+    }
+    
     // Compile shaders
-    GLuint shaderProgram = createShader(vertexSrc, fragmentSrc);
+    unsigned int shaderProgram = renderDevice.createProgram(vertexSrc, fragmentSrc);
     if (shaderProgram == 0) {
-        std::cerr << "Failed to create shader program!" << std::endl;
+        LOG_ERROR("Failed to create shader program!");
         return -1;
     }
-    std::cout << "Shader program created successfully" << std::endl;    std::cout << "Starting render loop..." << std::endl;
+    // The atlas always sits in texture unit 0
+    renderDevice.useProgram(shaderProgram);
+    renderDevice.setUniform(shaderProgram, "ourTexture", 0);
+    LOG_INFO("Shader program created successfully");
+    
+    // Camera matrices for every world program, uploaded once per frame
+    CameraUniforms cameraUniforms;
+    UniformBufferHandle cameraBuffer = renderDevice.createUniformBuffer(UniformBlock::CAMERA, sizeof(CameraUniforms));
+    LOG_INFO("Starting render loop...");
+
+    DebugOverlayStats debugStats;
+    int maxChunks = (2 * ChunkManager::LOAD_DISTANCE + 1) * (2 * ChunkManager::LOAD_DISTANCE + 1);
+    int frameNumber = 0;
+    float lastDebugSummary = 0.0f;
+    std::string debugSummary;
+    debugSummary.reserve(512);
+    std::string memorySummary;
+    memorySummary.reserve(256);
+
+    if (traceFramesLeft > 0) {
+        Trace::start();
+    }
 
     while (!glfwWindowShouldClose(window))
-    {        // Frame timing
+    {
+        if (traceToggleRequested) {
+            traceToggleRequested = false;
+            traceFramesLeft = 0;
+            if (Trace::isCapturing()) {
+                finishTraceCapture();
+            } else {
+                LOG_INFO("Trace capture started (F9 to stop)");
+                Trace::start();
+            }
+        } else if (traceFramesLeft > 0 && --traceFramesLeft == 0) {
+            finishTraceCapture();
+        }
+        Profiler::get().beginFrame();
+        frameNumber++;
+        
+        // Frame timing
         float currentFrame = glfwGetTime();
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
           // Update chunk manager based on player position
         chunkManager.update(player.position);
+        Trace::counter("loaded chunks", chunkManager.getLoadedChunkCount());
+        Trace::counter("pending chunks", chunkManager.getPendingChunkCount());
         
         // Update player physics and input (this will also update camera position)
-        player.update(deltaTime, window, camera, chunkManager);
+        player.update(deltaTime, readMovementInput(window), camera, chunkManager);
+        
+        // Exit application (ESC key)
+        if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
+            glfwSetWindowShouldClose(window, true);
+        }
         
         // Handle block interaction
         if (blockInteraction && gameUI) {
@@ -352,7 +461,7 @@ int main()
                 if (selectedBlock != BlockType::AIR && gameUI->removeBlockFromInventory(selectedBlock)) {
                     blockInteraction->placeBlock(placePos, selectedBlock, chunkManager);
                 } else {
-                    std::cout << "No more blocks of this type in inventory!" << std::endl;
+                    LOG_INFO("No more blocks of this type in inventory!");
                 }
                 rightMouseJustPressed = false;
             }
@@ -376,17 +485,23 @@ int main()
         glClearColor(horizonColor.r, horizonColor.g, horizonColor.b, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);// Setup matrices
         glm::mat4 view = camera.getViewMatrix();
-        glm::mat4 projection = glm::perspective(glm::radians(camera.zoom), 800.0f / 600.0f, 0.1f, 1000.0f);
+        glm::mat4 projection = glm::perspective(glm::radians(camera.zoom), 800.0f / 600.0f, 0.1f, 1500.0f);
         
         // Render skybox first (before terrain)
-        skybox->render(view, projection, timeOfDay);
+        cameraUniforms.view = view;
+        cameraUniforms.projection = projection;
+        cameraUniforms.viewProjection = projection * view;
+        cameraUniforms.position = glm::vec4(camera.position, 1.0f);
+        renderDevice.updateUniformBuffer(cameraBuffer, &cameraUniforms, sizeof(cameraUniforms));
+        
+        skybox->render(timeOfDay);
         
-        // Use shader program for terrain
-        glUseProgram(shaderProgram);
+        // Use shader program for terrain; it is opaque, so no blending until the water
+        renderDevice.setBlending(false);
+        renderDevice.useProgram(shaderProgram);
         
         // Bind texture atlas
-        textureAtlas->bind(0);
-        glUniform1i(glGetUniformLocation(shaderProgram, "ourTexture"), 0);
+        renderDevice.bindTexture(0, textureAtlas->getTextureID());
 
         // Render chunks using ChunkManager
         chunkManager.render(shaderProgram, player.position, view, projection);
@@ -395,34 +510,80 @@ int main()
         if (blockInteraction) {
             RaycastHit hit = blockInteraction->raycastToBlock(camera, chunkManager);
             if (hit.hit) {
-                blockInteraction->renderBlockHighlight(hit, shaderProgram, view, projection);
+                blockInteraction->renderBlockHighlight(hit);
             }
         }
         
+        // Water last, blended over everything opaque; it is tested against the
+        // depth buffer but does not write it, so water behind water still shows
+        renderDevice.setBlending(true);
+        renderDevice.setDepthWrite(false);
+        waterShader->use();
+        waterShader->setTime(currentFrame);
+        chunkManager.renderWater(waterShader->getProgram(), camera.position);
+        Trace::counter("water sorts", chunkManager.getLastWaterSortCount());
+        renderDevice.setDepthWrite(true);
+        
         // Render UI
         if (gameUI) {
+            if (gameUI->isDebugOverlayVisible()) {
+                debugStats.loadedChunks = chunkManager.getLoadedChunkCount();
+                debugStats.renderedChunks = chunkManager.getRenderedChunkCount();
+                debugStats.pendingChunks = chunkManager.getPendingChunkCount();
+                debugStats.culledChunks = chunkManager.getCulledChunkCount() + chunkManager.getOccludedChunkCount();
+                debugStats.maxChunks = maxChunks;
+                // Reading process memory is a system call; twice a second is plenty
+                if (frameNumber % 30 == 0 || debugStats.memoryBytes == 0) {
+                    debugStats.memoryBytes = Profiler::getProcessMemoryBytes();
+                }
+                gameUI->setDebugStats(debugStats);
+                
+                // The same numbers go to the console once a second, for logs of the session
+                if (currentFrame - lastDebugSummary >= 1.0f) {
+                    lastDebugSummary = currentFrame;
+                    Profiler::get().formatSummary(60, debugSummary);
+                    LOG_INFO(debugSummary << " | chunks " << debugStats.loadedChunks
+                              << " loaded, " << debugStats.renderedChunks << " rendered, "
+                              << chunkManager.getCulledChunkCount() << " cave culled, "
+                              << chunkManager.getOccludedChunkCount() << " occluded, "
+                              << debugStats.pendingChunks << " pending | "
+                              << debugStats.memoryBytes / (1024 * 1024) << " MB");
+                    MemoryStats::formatSummary(memorySummary);
+                    LOG_INFO(memorySummary << " | load radius " << chunkManager.getLoadRadius());
+                }
+            }
             int windowWidth, windowHeight;
             glfwGetWindowSize(window, &windowWidth, &windowHeight);
             gameUI->render(windowWidth, windowHeight);
         }
 
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        {
+            PROFILE_SCOPE("present");
+            glfwSwapBuffers(window);
+        }
+        {
+            PROFILE_SCOPE("input");
+            glfwPollEvents();
+        }
         
-        // Check for OpenGL errors
-        GLenum error = glGetError();
-        if (error != GL_NO_ERROR) {
-            std::cerr << "OpenGL error: " << error << std::endl;
+        // glGetError can stall the driver, so only poll it every couple of seconds
+        if (frameNumber % 120 == 0) {
+            for (GLenum error = glGetError(); error != GL_NO_ERROR; error = glGetError()) {
+                LOG_ERROR("OpenGL error: " << error);
+            }
         }
     }
     
-    std::cout << "Exiting render loop..." << std::endl;    // Cleanup
+    LOG_INFO("Exiting render loop...");    // Cleanup
     delete textureAtlas;
     delete skybox;
     delete waterShader;
     delete gameUI;
+    blockInteraction->cleanup();
     delete blockInteraction;
-    glDeleteProgram(shaderProgram);
+    renderDevice.deleteUniformBuffer(cameraBuffer);
+    renderDevice.deleteProgram(shaderProgram);
+    chunkManager.shutdown();
     glfwDestroyWindow(window);
     glfwTerminate();
     return 0;
@@ -0,0 +1,146 @@
+#include "memory_stats.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+struct CategoryInfo {
+    const char* name;
+    bool gpu;
+};
+
+const CategoryInfo categoryInfo[MemoryStats::CATEGORY_COUNT] = {
+    { "blocks", false },
+    { "pool", false },
+    { "scratch", false },
+    { "cache", false },
+    { "meshes", true },
+    { "far", true },
+    { "textures", true },
+};
+
+std::atomic<long long> categoryBytes[MemoryStats::CATEGORY_COUNT];
+std::atomic<size_t> categoryBudgets[MemoryStats::CATEGORY_COUNT];
+
+int indexOf(MemoryCategory category) {
+    return static_cast<int>(category);
+}
+
+double toMegabytes(size_t bytes) {
+    return bytes / (1024.0 * 1024.0);
+}
+
+}
+
+const char* MemoryStats::getName(MemoryCategory category) {
+    return categoryInfo[indexOf(category)].name;
+}
+
+bool MemoryStats::isGpu(MemoryCategory category) {
+    return categoryInfo[indexOf(category)].gpu;
+}
+
+void MemoryStats::add(MemoryCategory category, long long bytes) {
+    categoryBytes[indexOf(category)].fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void MemoryStats::set(MemoryCategory category, size_t bytes) {
+    categoryBytes[indexOf(category)].store(static_cast<long long>(bytes), std::memory_order_relaxed);
+}
+
+size_t MemoryStats::getBytes(MemoryCategory category) {
+    long long bytes = categoryBytes[indexOf(category)].load(std::memory_order_relaxed);
+    return bytes > 0 ? static_cast<size_t>(bytes) : 0;
+}
+
+size_t MemoryStats::getCpuBytes() {
+    size_t total = 0;
+    for (int i = 0; i < CATEGORY_COUNT; i++) {
+        if (!categoryInfo[i].gpu) total += getBytes(static_cast<MemoryCategory>(i));
+    }
+    return total;
+}
+
+size_t MemoryStats::getGpuBytes() {
+    size_t total = 0;
+    for (int i = 0; i < CATEGORY_COUNT; i++) {
+        if (categoryInfo[i].gpu) total += getBytes(static_cast<MemoryCategory>(i));
+    }
+    return total;
+}
+
+void MemoryStats::setBudget(MemoryCategory category, size_t bytes) {
+    categoryBudgets[indexOf(category)].store(bytes, std::memory_order_relaxed);
+}
+
+size_t MemoryStats::getBudget(MemoryCategory category) {
+    return categoryBudgets[indexOf(category)].load(std::memory_order_relaxed);
+}
+
+float MemoryStats::getBudgetUse(MemoryCategory category) {
+    size_t budget = getBudget(category);
+    if (budget == 0) return 0.0f;
+    return static_cast<float>(static_cast<double>(getBytes(category)) / budget);
+}
+
+bool MemoryStats::parseBudget(const char* spec) {
+    const char* equals = std::strchr(spec, '=');
+    if (!equals) return false;
+    size_t nameLength = static_cast<size_t>(equals - spec);
+    char* end = nullptr;
+    double megabytes = std::strtod(equals + 1, &end);
+    if (end == equals + 1 || *end != '\0' || megabytes < 0.0) return false;
+
+    for (int i = 0; i < CATEGORY_COUNT; i++) {
+        if (std::strlen(categoryInfo[i].name) == nameLength && std::strncmp(categoryInfo[i].name, spec, nameLength) == 0) {
+            setBudget(static_cast<MemoryCategory>(i), static_cast<size_t>(megabytes * 1024.0 * 1024.0));
+            return true;
+        }
+    }
+    return false;
+}
+
+void MemoryStats::formatSummary(std::string& out) {
+    char text[64];
+    std::snprintf(text, sizeof(text), "memory: cpu %.1f MB (", toMegabytes(getCpuBytes()));
+    out = text;
+    for (int pass = 0; pass < 2; pass++) {
+        if (pass == 1) {
+            std::snprintf(text, sizeof(text), ") | gpu ~%.1f MB (", toMegabytes(getGpuBytes()));
+            out += text;
+        }
+        bool first = true;
+        for (int i = 0; i < CATEGORY_COUNT; i++) {
+            MemoryCategory category = static_cast<MemoryCategory>(i);
+            if (categoryInfo[i].gpu != (pass == 1) || getBytes(category) == 0) continue;
+            std::snprintf(text, sizeof(text), "%s%s %.1f", first ? "" : ", ", categoryInfo[i].name,
+                          toMegabytes(getBytes(category)));
+            out += text;
+            first = false;
+        }
+    }
+    out += ")";
+}
+
+void MemoryStats::formatReport(std::string& out) {
+    char text[96];
+    std::snprintf(text, sizeof(text), "%-10s %-4s %10s %10s\n", "category", "kind", "MB", "budget MB");
+    out = text;
+    for (int i = 0; i < CATEGORY_COUNT; i++) {
+        MemoryCategory category = static_cast<MemoryCategory>(i);
+        size_t budget = getBudget(category);
+        if (budget > 0) {
+            std::snprintf(text, sizeof(text), "%-10s %-4s %10.2f %10.2f\n", categoryInfo[i].name,
+                          categoryInfo[i].gpu ? "gpu" : "cpu", toMegabytes(getBytes(category)), toMegabytes(budget));
+        } else {
+            std::snprintf(text, sizeof(text), "%-10s %-4s %10.2f %10s\n", categoryInfo[i].name,
+                          categoryInfo[i].gpu ? "gpu" : "cpu", toMegabytes(getBytes(category)), "-");
+        }
+        out += text;
+    }
+    std::snprintf(text, sizeof(text), "%-10s %-4s %10.2f\n%-10s %-4s %10.2f\n", "total", "cpu",
+                  toMegabytes(getCpuBytes()), "total", "gpu", toMegabytes(getGpuBytes()));
+    out += text;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// What the accounted memory holds. CPU categories are measured; GPU ones are
+// estimates from the sizes of the data handed to the driver.
+enum class MemoryCategory {
+    CHUNK_BLOCKS,     // Block arrays of loaded chunks
+    CHUNK_POOL,       // Unloaded chunks kept for reuse
+    MESH_SCRATCH,     // CPU staging buffer for chunk mesh builds
+    WORLD_CACHE,      // Mapped world cache file
+    CHUNK_MESHES,     // Chunk vertex/index buffers (GPU)
+    FAR_TERRAIN,      // Horizon tile vertex/index buffers (GPU)
+    TEXTURES,         // Texture atlas with mipmaps (GPU)
+    COUNT
+};
+
+/**
+ * MemoryStats keeps a byte counter per category plus an optional budget.
+ * Owners report what they hold (add() for deltas, set() for recomputed
+ * totals); counters are atomic, so any thread may report. ChunkManager
+ * shrinks its load radius while the chunk categories are over budget.
+ */
+class MemoryStats {
+public:
+    static const int CATEGORY_COUNT = static_cast<int>(MemoryCategory::COUNT);
+
+    // Short name, also used for budgets on the command line ("meshes")
+    static const char* getName(MemoryCategory category);
+    static bool isGpu(MemoryCategory category);
+
+    static void add(MemoryCategory category, long long bytes);   // Negative to release
+    static void set(MemoryCategory category, size_t bytes);
+    static size_t getBytes(MemoryCategory category);
+    static size_t getCpuBytes();
+    static size_t getGpuBytes();
+
+    // Budget in bytes, 0 for none
+    static void setBudget(MemoryCategory category, size_t bytes);
+    static size_t getBudget(MemoryCategory category);
+
+    // Fraction of the budget in use (above 1 when over), 0 when unbudgeted
+    static float getBudgetUse(MemoryCategory category);
+
+    // Parse "name=megabytes" (e.g. "meshes=256") and set that budget
+    static bool parseBudget(const char* spec);
+
+    // One line with the CPU and GPU totals and every non-empty category
+    static void formatSummary(std::string& out);
+
+    // A table of all categories with their budgets, for reports
+    static void formatReport(std::string& out);
+};
@@ -0,0 +1,180 @@
+#include "noise_batch.h"
+#include "noise_batch_kernels.h"
+#include <atomic>
+#include <cmath>
+
+#if defined(HACKVOXEL_NOISE_SIMD) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+BatchNoise::Backend detectBestBackend() {
+#if defined(HACKVOXEL_NOISE_SIMD)
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    __cpuid(info, 1);
+    bool hasSSE41 = (info[2] & (1 << 19)) != 0;
+    bool osSavesAVX = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 &&
+                      (_xgetbv(0) & 6) == 6;
+    bool hasAVX2 = false;
+    if (osSavesAVX && maxLeaf >= 7) {
+        __cpuidex(info, 7, 0);
+        hasAVX2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    bool hasSSE41 = __builtin_cpu_supports("sse4.1");
+    bool hasAVX2 = __builtin_cpu_supports("avx2");
+#endif
+    if (hasAVX2) return BatchNoise::Backend::AVX2;
+    if (hasSSE41) return BatchNoise::Backend::SSE41;
+#endif
+    return BatchNoise::Backend::SCALAR;
+}
+
+std::atomic<int> activeBackend{-1};
+
+int fractalTypeIndex(FastNoiseLite::FractalType type) {
+    switch (type) {
+        case FastNoiseLite::FractalType_FBm:    return 1;
+        case FastNoiseLite::FractalType_Ridged: return 2;
+        default:                                return 0;
+    }
+}
+
+NoiseKernelParams makeKernelParams(const NoiseSettings& settings, float fractalBounding) {
+    NoiseKernelParams params = { settings.seed, settings.frequency, fractalTypeIndex(settings.fractalType),
+                                 settings.octaves, settings.lacunarity, settings.gain, fractalBounding };
+    return params;
+}
+
+}
+
+BatchNoise::BatchNoise(const NoiseSettings& settings)
+    : settings(settings)
+{
+    noise.SetSeed(settings.seed);
+    noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+    noise.SetFrequency(settings.frequency);
+    noise.SetFractalType(settings.fractalType);
+    noise.SetFractalOctaves(settings.octaves);
+    noise.SetFractalLacunarity(settings.lacunarity);
+    noise.SetFractalGain(settings.gain);
+
+    // Same amplitude normalisation FastNoiseLite computes internally
+    float gain = std::fabs(settings.gain);
+    float amp = gain;
+    float ampFractal = 1.0f;
+    for (int i = 1; i < settings.octaves; i++) {
+        ampFractal += amp;
+        amp *= gain;
+    }
+    fractalBounding = 1 / ampFractal;
+}
+
+void BatchNoise::fillGrid2D(const NoiseGrid& grid, float* out) const {
+    NoiseKernelParams params = makeKernelParams(settings, fractalBounding);
+    switch (getBackend()) {
+#if defined(HACKVOXEL_NOISE_SIMD)
+        case Backend::AVX2:
+            fillNoiseGrid2D_AVX2(params, grid, out);
+            return;
+        case Backend::SSE41:
+            fillNoiseGrid2D_SSE41(params, grid, out);
+            return;
+#endif
+        default:
+            break;
+    }
+
+    for (int z = 0; z < grid.countZ; z++) {
+        float worldZ = grid.originZ + (float)z * grid.stepZ;
+        for (int x = 0; x < grid.countX; x++) {
+            float worldX = grid.originX + (float)x * grid.stepX;
+            out[z * grid.countX + x] = noise.GetNoise(worldX, worldZ);
+        }
+    }
+}
+
+void BatchNoise::fillGrid3D(const NoiseGrid& grid, float* out) const {
+    NoiseKernelParams params = makeKernelParams(settings, fractalBounding);
+    switch (getBackend()) {
+#if defined(HACKVOXEL_NOISE_SIMD)
+        case Backend::AVX2:
+            fillNoiseGrid3D_AVX2(params, grid, out);
+            return;
+        case Backend::SSE41:
+            fillNoiseGrid3D_SSE41(params, grid, out);
+            return;
+#endif
+        default:
+            break;
+    }
+
+    for (int y = 0; y < grid.countY; y++) {
+        float worldY = grid.originY + (float)y * grid.stepY;
+        for (int z = 0; z < grid.countZ; z++) {
+            float worldZ = grid.originZ + (float)z * grid.stepZ;
+            for (int x = 0; x < grid.countX; x++) {
+                float worldX = grid.originX + (float)x * grid.stepX;
+                out[(y * grid.countZ + z) * grid.countX + x] = noise.GetNoise(worldX, worldY, worldZ);
+            }
+        }
+    }
+}
+
+void BatchNoise::fillPoints3D(const float* xs, const float* ys, const float* zs, int count, float* out) const {
+    NoiseKernelParams params = makeKernelParams(settings, fractalBounding);
+    switch (getBackend()) {
+#if defined(HACKVOXEL_NOISE_SIMD)
+        case Backend::AVX2:
+            fillNoisePoints3D_AVX2(params, xs, ys, zs, count, out);
+            return;
+        case Backend::SSE41:
+            fillNoisePoints3D_SSE41(params, xs, ys, zs, count, out);
+            return;
+#endif
+        default:
+            break;
+    }
+
+    for (int i = 0; i < count; i++) {
+        out[i] = noise.GetNoise(xs[i], ys[i], zs[i]);
+    }
+}
+
+void BatchNoise::setBackend(Backend backend) {
+    if (!isBackendSupported(backend)) {
+        backend = getBestBackend();
+    }
+    activeBackend.store(static_cast<int>(backend));
+}
+
+BatchNoise::Backend BatchNoise::getBackend() {
+    int backend = activeBackend.load(std::memory_order_relaxed);
+    if (backend < 0) {
+        backend = static_cast<int>(getBestBackend());
+        activeBackend.store(backend);
+    }
+    return static_cast<Backend>(backend);
+}
+
+BatchNoise::Backend BatchNoise::getBestBackend() {
+    static const Backend best = detectBestBackend();
+    return best;
+}
+
+bool BatchNoise::isBackendSupported(Backend backend) {
+    return static_cast<int>(backend) <= static_cast<int>(getBestBackend());
+}
+
+const char* BatchNoise::getBackendName(Backend backend) {
+    switch (backend) {
+        case Backend::AVX2:  return "AVX2";
+        case Backend::SSE41: return "SSE4.1";
+        default:             return "scalar";
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "FastNoiseLite.h"
+#include "noise_grid.h"
+
+// Subset of FastNoiseLite settings the batched kernels reproduce (OpenSimplex2 only)
+struct NoiseSettings {
+    int seed = 1337;
+    float frequency = 0.01f;
+    FastNoiseLite::FractalType fractalType = FastNoiseLite::FractalType_None;
+    int octaves = 3;
+    float lacunarity = 2.0f;
+    float gain = 0.5f;
+};
+
+/**
+ * BatchNoise evaluates an OpenSimplex2 noise field over whole grids at once.
+ * The SSE4.1 and AVX2 kernels run over x and follow FastNoiseLite operation for
+ * operation, so they return the same floats as the scalar GetNoise calls they
+ * replace. The kernel is picked at runtime from what the CPU supports.
+ */
+class BatchNoise {
+public:
+    enum class Backend { SCALAR, SSE41, AVX2 };
+
+    explicit BatchNoise(const NoiseSettings& settings = NoiseSettings());
+
+    // Single samples through FastNoiseLite (same results as the grid versions)
+    float getNoise(float x, float y) const { return noise.GetNoise(x, y); }
+    float getNoise(float x, float y, float z) const { return noise.GetNoise(x, y, z); }
+
+    // Fill countX * countZ samples of 2D noise at (x, z)
+    void fillGrid2D(const NoiseGrid& grid, float* out) const;
+
+    // Fill countX * countY * countZ samples of 3D noise
+    void fillGrid3D(const NoiseGrid& grid, float* out) const;
+
+    // 3D noise at count scattered points (structure-of-arrays coordinates)
+    void fillPoints3D(const float* xs, const float* ys, const float* zs, int count, float* out) const;
+
+    const NoiseSettings& getSettings() const { return settings; }
+
+    // Backend used by all grid fills; requests for unsupported backends fall back
+    static void setBackend(Backend backend);
+    static Backend getBackend();
+    static Backend getBestBackend();
+    static bool isBackendSupported(Backend backend);
+    static const char* getBackendName(Backend backend);
+
+private:
+    NoiseSettings settings;
+    FastNoiseLite noise;
+    float fractalBounding;
+};
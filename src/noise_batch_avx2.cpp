@@ -0,0 +1,70 @@
+#include "noise_batch_kernels.h"
+#include <immintrin.h>
+
+// Built with AVX2 enabled (see CMakeLists.txt); eight lanes per call
+namespace {
+
+struct Simd {
+    typedef __m256 F;
+    typedef __m256i I;
+    static constexpr int WIDTH = 8;
+
+    static inline F setf(float v) { return _mm256_set1_ps(v); }
+    static inline I seti(int v) { return _mm256_set1_epi32(v); }
+    static inline I laneIndices() { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+    static inline F load(const float* in) { return _mm256_loadu_ps(in); }
+    static inline void store(float* out, F v) { _mm256_storeu_ps(out, v); }
+
+    static inline F add(F a, F b) { return _mm256_add_ps(a, b); }
+    static inline F sub(F a, F b) { return _mm256_sub_ps(a, b); }
+    static inline F mul(F a, F b) { return _mm256_mul_ps(a, b); }
+    static inline F negate(F a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+    static inline F abs(F a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+
+    static inline F cmpgt(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static inline F cmpge(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    static inline F cmplt(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static inline F cmple(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static inline F andf(F a, F b) { return _mm256_and_ps(a, b); }
+    static inline F orf(F a, F b) { return _mm256_or_ps(a, b); }
+    static inline F andnotf(F a, F b) { return _mm256_andnot_ps(a, b); }
+    static inline F allOnes() { return _mm256_castsi256_ps(_mm256_set1_epi32(-1)); }
+    static inline I maskToInt(F mask) { return _mm256_castps_si256(mask); }
+
+    // mask ? a : b
+    static inline F select(F mask, F a, F b) { return _mm256_blendv_ps(b, a, mask); }
+    static inline I selecti(F mask, I a, I b) {
+        return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(b), _mm256_castsi256_ps(a), mask));
+    }
+
+    static inline I addi(I a, I b) { return _mm256_add_epi32(a, b); }
+    static inline I subi(I a, I b) { return _mm256_sub_epi32(a, b); }
+    static inline I mullo(I a, I b) { return _mm256_mullo_epi32(a, b); }
+    static inline I xori(I a, I b) { return _mm256_xor_si256(a, b); }
+    static inline I andi(I a, I b) { return _mm256_and_si256(a, b); }
+    static inline I ori(I a, I b) { return _mm256_or_si256(a, b); }
+    static inline I srai1(I a) { return _mm256_srai_epi32(a, 1); }
+    static inline I srai15(I a) { return _mm256_srai_epi32(a, 15); }
+
+    static inline I truncate(F a) { return _mm256_cvttps_epi32(a); }
+    static inline F toFloat(I a) { return _mm256_cvtepi32_ps(a); }
+
+    static inline F gather(const float* table, I index) { return _mm256_i32gather_ps(table, index, 4); }
+};
+
+#include "noise_batch_kernel.inl"
+
+}
+
+void fillNoiseGrid2D_AVX2(const NoiseKernelParams& params, const NoiseGrid& grid, float* out) {
+    fillGrid2D(params, grid, out);
+}
+
+void fillNoiseGrid3D_AVX2(const NoiseKernelParams& params, const NoiseGrid& grid, float* out) {
+    fillGrid3D(params, grid, out);
+}
+
+void fillNoisePoints3D_AVX2(const NoiseKernelParams& params, const float* xs, const float* ys, const float* zs,
+                          int count, float* out) {
+    fillPoints3D(params, xs, ys, zs, count, out);
+}
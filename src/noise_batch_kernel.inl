@@ -0,0 +1,363 @@
+// Shared body of the SIMD noise kernels. Included by noise_batch_sse41.cpp and
+// noise_batch_avx2.cpp inside an anonymous namespace, after each defines a
+// `Simd` wrapper for its vector width. Every function here mirrors the scalar
+// code in FastNoiseLite (OpenSimplex2 2D/3D, FBm and ridged fractals) one
+// operation at a time and in the same order, so results match bit for bit.
+//
+// Gradient tables copied from FastNoiseLite, MIT License,
+// Copyright(c) 2023 Jordan Peck (jordan.me2@gmail.com) and contributors.
+
+typedef Simd::F F;
+typedef Simd::I I;
+
+const int PRIME_X = 501125321;
+const int PRIME_Y = 1136930381;
+const int PRIME_Z = 1720413743;
+const int HASH_MULTIPLIER = 0x27d4eb2d;
+
+alignas(32) const float GRADIENTS_2D[256] =
+{
+    0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+    0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+    0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+    -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+    -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+    -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+    0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+    0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+    0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+    -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+    -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+    -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+    0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+    0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+    0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+    -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+    -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+    -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+    0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+    0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+    0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+    -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+    -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+    -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+    0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+    0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+    0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+    -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+    -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+    -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+    0.38268343236509f, 0.923879532511287f, 0.923879532511287f, 0.38268343236509f, 0.923879532511287f, -0.38268343236509f, 0.38268343236509f, -0.923879532511287f,
+    -0.38268343236509f, -0.923879532511287f, -0.923879532511287f, -0.38268343236509f, -0.923879532511287f, 0.38268343236509f, -0.38268343236509f, 0.923879532511287f,
+};
+
+alignas(32) const float GRADIENTS_3D[256] =
+{
+    0, 1, 1, 0,  0,-1, 1, 0,  0, 1,-1, 0,  0,-1,-1, 0,
+    1, 0, 1, 0, -1, 0, 1, 0,  1, 0,-1, 0, -1, 0,-1, 0,
+    1, 1, 0, 0, -1, 1, 0, 0,  1,-1, 0, 0, -1,-1, 0, 0,
+    0, 1, 1, 0,  0,-1, 1, 0,  0, 1,-1, 0,  0,-1,-1, 0,
+    1, 0, 1, 0, -1, 0, 1, 0,  1, 0,-1, 0, -1, 0,-1, 0,
+    1, 1, 0, 0, -1, 1, 0, 0,  1,-1, 0, 0, -1,-1, 0, 0,
+    0, 1, 1, 0,  0,-1, 1, 0,  0, 1,-1, 0,  0,-1,-1, 0,
+    1, 0, 1, 0, -1, 0, 1, 0,  1, 0,-1, 0, -1, 0,-1, 0,
+    1, 1, 0, 0, -1, 1, 0, 0,  1,-1, 0, 0, -1,-1, 0, 0,
+    0, 1, 1, 0,  0,-1, 1, 0,  0, 1,-1, 0,  0,-1,-1, 0,
+    1, 0, 1, 0, -1, 0, 1, 0,  1, 0,-1, 0, -1, 0,-1, 0,
+    1, 1, 0, 0, -1, 1, 0, 0,  1,-1, 0, 0, -1,-1, 0, 0,
+    0, 1, 1, 0,  0,-1, 1, 0,  0, 1,-1, 0,  0,-1,-1, 0,
+    1, 0, 1, 0, -1, 0, 1, 0,  1, 0,-1, 0, -1, 0,-1, 0,
+    1, 1, 0, 0, -1, 1, 0, 0,  1,-1, 0, 0, -1,-1, 0, 0,
+    1, 1, 0, 0,  0,-1, 1, 0, -1, 1, 0, 0,  0,-1,-1, 0
+};
+
+// FastNoiseLite::FastFloor, including its quirk of mapping negative integers one lower
+inline I fastFloor(F f) {
+    I truncated = Simd::truncate(f);
+    return Simd::addi(truncated, Simd::maskToInt(Simd::cmplt(f, Simd::setf(0.0f))));
+}
+
+inline I fastRound(F f) {
+    F half = Simd::select(Simd::cmpge(f, Simd::setf(0.0f)), Simd::setf(0.5f), Simd::setf(-0.5f));
+    return Simd::truncate(Simd::add(f, half));
+}
+
+inline I hashGradient(int seed, I hash, int mask) {
+    hash = Simd::xori(Simd::seti(seed), hash);
+    hash = Simd::mullo(hash, Simd::seti(HASH_MULTIPLIER));
+    hash = Simd::xori(hash, Simd::srai15(hash));
+    return Simd::andi(hash, Simd::seti(mask));
+}
+
+inline F gradCoord(int seed, I xPrimed, I yPrimed, F xd, F yd) {
+    I hash = hashGradient(seed, Simd::xori(xPrimed, yPrimed), 127 << 1);
+    F xg = Simd::gather(GRADIENTS_2D, hash);
+    F yg = Simd::gather(GRADIENTS_2D, Simd::ori(hash, Simd::seti(1)));
+    return Simd::add(Simd::mul(xd, xg), Simd::mul(yd, yg));
+}
+
+inline F gradCoord(int seed, I xPrimed, I yPrimed, I zPrimed, F xd, F yd, F zd) {
+    I hash = hashGradient(seed, Simd::xori(Simd::xori(xPrimed, yPrimed), zPrimed), 63 << 2);
+    F xg = Simd::gather(GRADIENTS_3D, hash);
+    F yg = Simd::gather(GRADIENTS_3D, Simd::ori(hash, Simd::seti(1)));
+    F zg = Simd::gather(GRADIENTS_3D, Simd::ori(hash, Simd::seti(2)));
+    return Simd::add(Simd::add(Simd::mul(xd, xg), Simd::mul(yd, yg)), Simd::mul(zd, zg));
+}
+
+// (t^2)^2 * gradient, or exactly zero where t <= 0
+inline F attenuate(F t, F gradient) {
+    F t2 = Simd::mul(t, t);
+    F contribution = Simd::mul(Simd::mul(t2, t2), gradient);
+    return Simd::select(Simd::cmple(t, Simd::setf(0.0f)), Simd::setf(0.0f), contribution);
+}
+
+// FastNoiseLite::SingleSimplex on already skewed coordinates
+inline F singleSimplex(int seed, F x, F y) {
+    const float SQRT3 = 1.7320508075688772935274463415059f;
+    const float G2 = (3 - SQRT3) / 6;
+    const float C_T = (float)(2 * (1 - 2 * G2) * (1 / G2 - 2));
+    const float C_A = (float)(-2 * (1 - 2 * G2) * (1 - 2 * G2));
+
+    I i = fastFloor(x);
+    I j = fastFloor(y);
+    F xi = Simd::sub(x, Simd::toFloat(i));
+    F yi = Simd::sub(y, Simd::toFloat(j));
+
+    F t = Simd::mul(Simd::add(xi, yi), Simd::setf(G2));
+    F x0 = Simd::sub(xi, t);
+    F y0 = Simd::sub(yi, t);
+
+    i = Simd::mullo(i, Simd::seti(PRIME_X));
+    j = Simd::mullo(j, Simd::seti(PRIME_Y));
+
+    F a = Simd::sub(Simd::sub(Simd::setf(0.5f), Simd::mul(x0, x0)), Simd::mul(y0, y0));
+    F n0 = attenuate(a, gradCoord(seed, i, j, x0, y0));
+
+    F c = Simd::add(Simd::mul(Simd::setf(C_T), t), Simd::add(Simd::setf(C_A), a));
+    F x2 = Simd::add(x0, Simd::setf(2 * (float)G2 - 1));
+    F y2 = Simd::add(y0, Simd::setf(2 * (float)G2 - 1));
+    F n2 = attenuate(c, gradCoord(seed, Simd::addi(i, Simd::seti(PRIME_X)), Simd::addi(j, Simd::seti(PRIME_Y)), x2, y2));
+
+    // Middle vertex depends on which triangle of the cell the point is in
+    F upper = Simd::cmpgt(y0, x0);
+    F x1 = Simd::select(upper, Simd::add(x0, Simd::setf((float)G2)), Simd::add(x0, Simd::setf((float)G2 - 1)));
+    F y1 = Simd::select(upper, Simd::add(y0, Simd::setf((float)G2 - 1)), Simd::add(y0, Simd::setf((float)G2)));
+    I i1 = Simd::selecti(upper, i, Simd::addi(i, Simd::seti(PRIME_X)));
+    I j1 = Simd::selecti(upper, Simd::addi(j, Simd::seti(PRIME_Y)), j);
+    F b = Simd::sub(Simd::sub(Simd::setf(0.5f), Simd::mul(x1, x1)), Simd::mul(y1, y1));
+    F n1 = attenuate(b, gradCoord(seed, i1, j1, x1, y1));
+
+    return Simd::mul(Simd::add(Simd::add(n0, n1), n2), Simd::setf(99.83685446303647f));
+}
+
+// FastNoiseLite::SingleOpenSimplex2 (3D) on already rotated coordinates
+inline F singleOpenSimplex2(int seed, F x, F y, F z) {
+    const F zero = Simd::setf(0.0f);
+
+    I i = fastRound(x);
+    I j = fastRound(y);
+    I k = fastRound(z);
+    F x0 = Simd::sub(x, Simd::toFloat(i));
+    F y0 = Simd::sub(y, Simd::toFloat(j));
+    F z0 = Simd::sub(z, Simd::toFloat(k));
+
+    I xNSign = Simd::ori(Simd::truncate(Simd::sub(Simd::setf(-1.0f), x0)), Simd::seti(1));
+    I yNSign = Simd::ori(Simd::truncate(Simd::sub(Simd::setf(-1.0f), y0)), Simd::seti(1));
+    I zNSign = Simd::ori(Simd::truncate(Simd::sub(Simd::setf(-1.0f), z0)), Simd::seti(1));
+
+    F ax0 = Simd::mul(Simd::toFloat(xNSign), Simd::negate(x0));
+    F ay0 = Simd::mul(Simd::toFloat(yNSign), Simd::negate(y0));
+    F az0 = Simd::mul(Simd::toFloat(zNSign), Simd::negate(z0));
+
+    const I primeX = Simd::seti(PRIME_X);
+    const I primeY = Simd::seti(PRIME_Y);
+    const I primeZ = Simd::seti(PRIME_Z);
+    i = Simd::mullo(i, primeX);
+    j = Simd::mullo(j, primeY);
+    k = Simd::mullo(k, primeZ);
+
+    F value = zero;
+    F a = Simd::sub(Simd::sub(Simd::setf(0.6f), Simd::mul(x0, x0)),
+                    Simd::add(Simd::mul(y0, y0), Simd::mul(z0, z0)));
+
+    for (int l = 0; ; l++) {
+        F gradient = gradCoord(seed, i, j, k, x0, y0, z0);
+        F a2 = Simd::mul(a, a);
+        value = Simd::select(Simd::cmpgt(a, zero), Simd::add(value, Simd::mul(Simd::mul(a2, a2), gradient)), value);
+
+        // Step along the axis the point is furthest along to find the second vertex
+        F alongX = Simd::andf(Simd::cmpge(ax0, ay0), Simd::cmpge(ax0, az0));
+        F alongY = Simd::andnotf(alongX, Simd::andf(Simd::cmpgt(ay0, ax0), Simd::cmpge(ay0, az0)));
+        F alongZ = Simd::andnotf(Simd::orf(alongX, alongY), Simd::allOnes());
+
+        F b = Simd::add(a, Simd::setf(1.0f));
+        F x1Moved = Simd::add(x0, Simd::toFloat(xNSign));
+        F y1Moved = Simd::add(y0, Simd::toFloat(yNSign));
+        F z1Moved = Simd::add(z0, Simd::toFloat(zNSign));
+        F bX = Simd::sub(b, Simd::mul(Simd::toFloat(Simd::addi(xNSign, xNSign)), x1Moved));
+        F bY = Simd::sub(b, Simd::mul(Simd::toFloat(Simd::addi(yNSign, yNSign)), y1Moved));
+        F bZ = Simd::sub(b, Simd::mul(Simd::toFloat(Simd::addi(zNSign, zNSign)), z1Moved));
+
+        F x1 = Simd::select(alongX, x1Moved, x0);
+        F y1 = Simd::select(alongY, y1Moved, y0);
+        F z1 = Simd::select(alongZ, z1Moved, z0);
+        b = Simd::select(alongX, bX, Simd::select(alongY, bY, bZ));
+        I i1 = Simd::selecti(alongX, Simd::subi(i, Simd::mullo(xNSign, primeX)), i);
+        I j1 = Simd::selecti(alongY, Simd::subi(j, Simd::mullo(yNSign, primeY)), j);
+        I k1 = Simd::selecti(alongZ, Simd::subi(k, Simd::mullo(zNSign, primeZ)), k);
+
+        gradient = gradCoord(seed, i1, j1, k1, x1, y1, z1);
+        F b2 = Simd::mul(b, b);
+        value = Simd::select(Simd::cmpgt(b, zero), Simd::add(value, Simd::mul(Simd::mul(b2, b2), gradient)), value);
+
+        if (l == 1) break;
+
+        // Move to the second, offset lattice
+        ax0 = Simd::sub(Simd::setf(0.5f), ax0);
+        ay0 = Simd::sub(Simd::setf(0.5f), ay0);
+        az0 = Simd::sub(Simd::setf(0.5f), az0);
+
+        x0 = Simd::mul(Simd::toFloat(xNSign), ax0);
+        y0 = Simd::mul(Simd::toFloat(yNSign), ay0);
+        z0 = Simd::mul(Simd::toFloat(zNSign), az0);
+
+        a = Simd::add(a, Simd::sub(Simd::sub(Simd::setf(0.75f), ax0), Simd::add(ay0, az0)));
+
+        i = Simd::addi(i, Simd::andi(Simd::srai1(xNSign), primeX));
+        j = Simd::addi(j, Simd::andi(Simd::srai1(yNSign), primeY));
+        k = Simd::addi(k, Simd::andi(Simd::srai1(zNSign), primeZ));
+
+        xNSign = Simd::subi(Simd::seti(0), xNSign);
+        yNSign = Simd::subi(Simd::seti(0), yNSign);
+        zNSign = Simd::subi(Simd::seti(0), zNSign);
+
+        seed = ~seed;
+    }
+
+    return Simd::mul(value, Simd::setf(32.69428253173828125f));
+}
+
+inline F fractalNoise2D(const NoiseKernelParams& params, F x, F y) {
+    // FastNoiseLite::TransformNoiseCoordinate (2D OpenSimplex2 skew)
+    x = Simd::mul(x, Simd::setf(params.frequency));
+    y = Simd::mul(y, Simd::setf(params.frequency));
+    const float SQRT3 = (float)1.7320508075688772935274463415059;
+    const float F2 = 0.5f * (SQRT3 - 1);
+    F t = Simd::mul(Simd::add(x, y), Simd::setf(F2));
+    x = Simd::add(x, t);
+    y = Simd::add(y, t);
+
+    if (params.fractalType == 0) {
+        return singleSimplex(params.seed, x, y);
+    }
+
+    int seed = params.seed;
+    F sum = Simd::setf(0.0f);
+    float amp = params.fractalBounding;
+    for (int i = 0; i < params.octaves; i++) {
+        F noise = singleSimplex(seed++, x, y);
+        if (params.fractalType == 2) {
+            noise = Simd::abs(noise);
+            sum = Simd::add(sum, Simd::mul(Simd::add(Simd::mul(noise, Simd::setf(-2.0f)), Simd::setf(1.0f)), Simd::setf(amp)));
+        } else {
+            sum = Simd::add(sum, Simd::mul(noise, Simd::setf(amp)));
+        }
+        x = Simd::mul(x, Simd::setf(params.lacunarity));
+        y = Simd::mul(y, Simd::setf(params.lacunarity));
+        amp *= params.gain;
+    }
+    return sum;
+}
+
+inline F fractalNoise3D(const NoiseKernelParams& params, F x, F y, F z) {
+    // FastNoiseLite::TransformNoiseCoordinate (default OpenSimplex2 rotation)
+    x = Simd::mul(x, Simd::setf(params.frequency));
+    y = Simd::mul(y, Simd::setf(params.frequency));
+    z = Simd::mul(z, Simd::setf(params.frequency));
+    const float R3 = (float)(2.0 / 3.0);
+    F r = Simd::mul(Simd::add(Simd::add(x, y), z), Simd::setf(R3));
+    x = Simd::sub(r, x);
+    y = Simd::sub(r, y);
+    z = Simd::sub(r, z);
+
+    if (params.fractalType == 0) {
+        return singleOpenSimplex2(params.seed, x, y, z);
+    }
+
+    int seed = params.seed;
+    F sum = Simd::setf(0.0f);
+    float amp = params.fractalBounding;
+    for (int i = 0; i < params.octaves; i++) {
+        F noise = singleOpenSimplex2(seed++, x, y, z);
+        if (params.fractalType == 2) {
+            noise = Simd::abs(noise);
+            sum = Simd::add(sum, Simd::mul(Simd::add(Simd::mul(noise, Simd::setf(-2.0f)), Simd::setf(1.0f)), Simd::setf(amp)));
+        } else {
+            sum = Simd::add(sum, Simd::mul(noise, Simd::setf(amp)));
+        }
+        x = Simd::mul(x, Simd::setf(params.lacunarity));
+        y = Simd::mul(y, Simd::setf(params.lacunarity));
+        z = Simd::mul(z, Simd::setf(params.lacunarity));
+        amp *= params.gain;
+    }
+    return sum;
+}
+
+// x coordinates of the lanes starting at column x: origin + index * step
+inline F laneCoordinates(const NoiseGrid& grid, int x) {
+    F index = Simd::toFloat(Simd::addi(Simd::seti(x), Simd::laneIndices()));
+    return Simd::add(Simd::setf(grid.originX), Simd::mul(index, Simd::setf(grid.stepX)));
+}
+
+inline void storeRow(float* out, int x, int countX, F value) {
+    if (x + Simd::WIDTH <= countX) {
+        Simd::store(out + x, value);
+        return;
+    }
+    float lanes[Simd::WIDTH];
+    Simd::store(lanes, value);
+    for (int lane = 0; x + lane < countX; lane++) {
+        out[x + lane] = lanes[lane];
+    }
+}
+
+void fillGrid2D(const NoiseKernelParams& params, const NoiseGrid& grid, float* out) {
+    for (int z = 0; z < grid.countZ; z++) {
+        F zCoord = Simd::setf(grid.originZ + (float)z * grid.stepZ);
+        float* row = out + z * grid.countX;
+        for (int x = 0; x < grid.countX; x += Simd::WIDTH) {
+            storeRow(row, x, grid.countX, fractalNoise2D(params, laneCoordinates(grid, x), zCoord));
+        }
+    }
+}
+
+void fillGrid3D(const NoiseKernelParams& params, const NoiseGrid& grid, float* out) {
+    for (int y = 0; y < grid.countY; y++) {
+        F yCoord = Simd::setf(grid.originY + (float)y * grid.stepY);
+        for (int z = 0; z < grid.countZ; z++) {
+            F zCoord = Simd::setf(grid.originZ + (float)z * grid.stepZ);
+            float* row = out + (y * grid.countZ + z) * grid.countX;
+            for (int x = 0; x < grid.countX; x += Simd::WIDTH) {
+                storeRow(row, x, grid.countX, fractalNoise3D(params, laneCoordinates(grid, x), yCoord, zCoord));
+            }
+        }
+    }
+}
+
+void fillPoints3D(const NoiseKernelParams& params, const float* xs, const float* ys, const float* zs, int count, float* out) {
+    for (int i = 0; i < count; i += Simd::WIDTH) {
+        if (i + Simd::WIDTH <= count) {
+            Simd::store(out + i, fractalNoise3D(params, Simd::load(xs + i), Simd::load(ys + i), Simd::load(zs + i)));
+            continue;
+        }
+        // Pad the last partial vector by repeating the final point
+        float lanes[3][Simd::WIDTH];
+        for (int lane = 0; lane < Simd::WIDTH; lane++) {
+            int point = i + lane < count ? i + lane : count - 1;
+            lanes[0][lane] = xs[point];
+            lanes[1][lane] = ys[point];
+            lanes[2][lane] = zs[point];
+        }
+        storeRow(out, i, count, fractalNoise3D(params, Simd::load(lanes[0]), Simd::load(lanes[1]), Simd::load(lanes[2])));
+    }
+}
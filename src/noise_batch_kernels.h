@@ -0,0 +1,27 @@
+#pragma once
+
+#include "noise_grid.h"
+
+// Internal entry points of the per-instruction-set kernels. Each lives in its
+// own translation unit compiled with the matching target flags, and is only
+// called after BatchNoise has checked that the CPU supports it. Only plain
+// structs cross this boundary so no inline library code is compiled twice
+// with different instruction sets.
+struct NoiseKernelParams {
+    int seed;
+    float frequency;
+    int fractalType;        // 0 = none, 1 = FBm, 2 = ridged
+    int octaves;
+    float lacunarity;
+    float gain;
+    float fractalBounding;
+};
+
+void fillNoiseGrid2D_SSE41(const NoiseKernelParams& params, const NoiseGrid& grid, float* out);
+void fillNoiseGrid3D_SSE41(const NoiseKernelParams& params, const NoiseGrid& grid, float* out);
+void fillNoiseGrid2D_AVX2(const NoiseKernelParams& params, const NoiseGrid& grid, float* out);
+void fillNoiseGrid3D_AVX2(const NoiseKernelParams& params, const NoiseGrid& grid, float* out);
+void fillNoisePoints3D_SSE41(const NoiseKernelParams& params, const float* xs, const float* ys, const float* zs,
+                             int count, float* out);
+void fillNoisePoints3D_AVX2(const NoiseKernelParams& params, const float* xs, const float* ys, const float* zs,
+                            int count, float* out);
@@ -0,0 +1,74 @@
+#include "noise_batch_kernels.h"
+#include <smmintrin.h>
+
+// Built with SSE4.1 enabled (see CMakeLists.txt); four lanes per call
+namespace {
+
+struct Simd {
+    typedef __m128 F;
+    typedef __m128i I;
+    static constexpr int WIDTH = 4;
+
+    static inline F setf(float v) { return _mm_set1_ps(v); }
+    static inline I seti(int v) { return _mm_set1_epi32(v); }
+    static inline I laneIndices() { return _mm_setr_epi32(0, 1, 2, 3); }
+    static inline F load(const float* in) { return _mm_loadu_ps(in); }
+    static inline void store(float* out, F v) { _mm_storeu_ps(out, v); }
+
+    static inline F add(F a, F b) { return _mm_add_ps(a, b); }
+    static inline F sub(F a, F b) { return _mm_sub_ps(a, b); }
+    static inline F mul(F a, F b) { return _mm_mul_ps(a, b); }
+    static inline F negate(F a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+    static inline F abs(F a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+
+    static inline F cmpgt(F a, F b) { return _mm_cmpgt_ps(a, b); }
+    static inline F cmpge(F a, F b) { return _mm_cmpge_ps(a, b); }
+    static inline F cmplt(F a, F b) { return _mm_cmplt_ps(a, b); }
+    static inline F cmple(F a, F b) { return _mm_cmple_ps(a, b); }
+    static inline F andf(F a, F b) { return _mm_and_ps(a, b); }
+    static inline F orf(F a, F b) { return _mm_or_ps(a, b); }
+    static inline F andnotf(F a, F b) { return _mm_andnot_ps(a, b); }
+    static inline F allOnes() { return _mm_castsi128_ps(_mm_set1_epi32(-1)); }
+    static inline I maskToInt(F mask) { return _mm_castps_si128(mask); }
+
+    // mask ? a : b
+    static inline F select(F mask, F a, F b) { return _mm_blendv_ps(b, a, mask); }
+    static inline I selecti(F mask, I a, I b) {
+        return _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(b), _mm_castsi128_ps(a), mask));
+    }
+
+    static inline I addi(I a, I b) { return _mm_add_epi32(a, b); }
+    static inline I subi(I a, I b) { return _mm_sub_epi32(a, b); }
+    static inline I mullo(I a, I b) { return _mm_mullo_epi32(a, b); }
+    static inline I xori(I a, I b) { return _mm_xor_si128(a, b); }
+    static inline I andi(I a, I b) { return _mm_and_si128(a, b); }
+    static inline I ori(I a, I b) { return _mm_or_si128(a, b); }
+    static inline I srai1(I a) { return _mm_srai_epi32(a, 1); }
+    static inline I srai15(I a) { return _mm_srai_epi32(a, 15); }
+
+    static inline I truncate(F a) { return _mm_cvttps_epi32(a); }
+    static inline F toFloat(I a) { return _mm_cvtepi32_ps(a); }
+
+    static inline F gather(const float* table, I index) {
+        alignas(16) int lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), index);
+        return _mm_setr_ps(table[lanes[0]], table[lanes[1]], table[lanes[2]], table[lanes[3]]);
+    }
+};
+
+#include "noise_batch_kernel.inl"
+
+}
+
+void fillNoiseGrid2D_SSE41(const NoiseKernelParams& params, const NoiseGrid& grid, float* out) {
+    fillGrid2D(params, grid, out);
+}
+
+void fillNoiseGrid3D_SSE41(const NoiseKernelParams& params, const NoiseGrid& grid, float* out) {
+    fillGrid3D(params, grid, out);
+}
+
+void fillNoisePoints3D_SSE41(const NoiseKernelParams& params, const float* xs, const float* ys, const float* zs,
+                          int count, float* out) {
+    fillPoints3D(params, xs, ys, zs, count, out);
+}
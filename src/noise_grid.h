@@ -0,0 +1,10 @@
+#pragma once
+
+// Regular sample lattice: sample (i, j, k) is at origin + index * step, evaluated in float.
+// Results are written x fastest, then z, then y: out[(y * countZ + z) * countX + x].
+// 2D grids use the x/z axes and ignore y.
+struct NoiseGrid {
+    float originX = 0.0f, originY = 0.0f, originZ = 0.0f;
+    float stepX = 1.0f, stepY = 1.0f, stepZ = 1.0f;
+    int countX = 1, countY = 1, countZ = 1;
+};
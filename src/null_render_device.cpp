@@ -0,0 +1,151 @@
+#include "null_render_device.h"
+
+MeshHandle NullRenderDevice::createMesh(const VertexLayout& layout) {
+    stats.calls++;
+    liveMeshes++;
+    return nextHandle++;
+}
+
+void NullRenderDevice::updateMesh(MeshHandle mesh, const float* vertices, size_t floatCount,
+                                  const unsigned int* indices, size_t indexCount, BufferUsage usage) {
+    stats.calls++;
+    stats.meshUploads++;
+    stats.bytesUploaded += floatCount * sizeof(float);
+    if (indices) stats.bytesUploaded += indexCount * sizeof(unsigned int);
+}
+
+void NullRenderDevice::updateIndices(MeshHandle mesh, const unsigned int* indices, size_t indexCount) {
+    stats.calls++;
+    stats.meshUploads++;
+    stats.bytesUploaded += indexCount * sizeof(unsigned int);
+}
+
+void NullRenderDevice::deleteMesh(MeshHandle mesh) {
+    stats.calls++;
+    if (liveMeshes > 0) liveMeshes--;
+}
+
+void NullRenderDevice::drawMesh(MeshHandle mesh, PrimitiveType primitive, size_t count, size_t first) {
+    stats.calls++;
+    stats.drawCalls++;
+    stats.elementsDrawn += count;
+}
+
+void NullRenderDevice::drawMeshRanges(MeshHandle mesh, PrimitiveType primitive, const size_t* firsts,
+                                      const size_t* counts, int rangeCount) {
+    stats.calls++;
+    stats.drawCalls++;
+    for (int i = 0; i < rangeCount; i++) {
+        stats.elementsDrawn += counts[i];
+    }
+}
+
+unsigned int NullRenderDevice::createProgram(const char* vertexSource, const char* fragmentSource) {
+    stats.calls++;
+    livePrograms++;
+    return nextHandle++;
+}
+
+void NullRenderDevice::deleteProgram(unsigned int program) {
+    stats.calls++;
+    if (livePrograms > 0) livePrograms--;
+}
+
+void NullRenderDevice::useProgram(unsigned int program) {
+    stats.calls++;
+    stats.programBinds++;
+}
+
+// Programs have no source to reflect, so every name resolves to location 0
+UniformLocation NullRenderDevice::getUniformLocation(unsigned int program, const char* name) {
+    stats.calls++;
+    return 0;
+}
+
+void NullRenderDevice::setUniform(UniformLocation location, const glm::mat4& value) {
+    stats.calls++;
+    stats.uniformUpdates++;
+}
+
+void NullRenderDevice::setUniform(UniformLocation location, const glm::vec3& value) {
+    stats.calls++;
+    stats.uniformUpdates++;
+}
+
+void NullRenderDevice::setUniform(UniformLocation location, float value) {
+    stats.calls++;
+    stats.uniformUpdates++;
+}
+
+void NullRenderDevice::setUniform(UniformLocation location, int value) {
+    stats.calls++;
+    stats.uniformUpdates++;
+}
+
+void NullRenderDevice::setUniform(unsigned int program, const char* name, const glm::mat4& value) {
+    stats.calls++;
+    stats.uniformUpdates++;
+}
+
+void NullRenderDevice::setUniform(unsigned int program, const char* name, const glm::vec3& value) {
+    stats.calls++;
+    stats.uniformUpdates++;
+}
+
+void NullRenderDevice::setUniform(unsigned int program, const char* name, float value) {
+    stats.calls++;
+    stats.uniformUpdates++;
+}
+
+void NullRenderDevice::setUniform(unsigned int program, const char* name, int value) {
+    stats.calls++;
+    stats.uniformUpdates++;
+}
+
+UniformBufferHandle NullRenderDevice::createUniformBuffer(UniformBlock block, size_t bytes) {
+    stats.calls++;
+    return nextHandle++;
+}
+
+void NullRenderDevice::updateUniformBuffer(UniformBufferHandle buffer, const void* data, size_t bytes) {
+    stats.calls++;
+    stats.uniformBufferUpdates++;
+}
+
+void NullRenderDevice::deleteUniformBuffer(UniformBufferHandle buffer) {
+    stats.calls++;
+}
+
+unsigned int NullRenderDevice::createTexture(int width, int height, const unsigned char* rgba) {
+    stats.calls++;
+    return nextHandle++;
+}
+
+void NullRenderDevice::deleteTexture(unsigned int texture) {
+    stats.calls++;
+}
+
+void NullRenderDevice::bindTexture(int unit, unsigned int texture) {
+    stats.calls++;
+    stats.textureBinds++;
+}
+
+void NullRenderDevice::setDepthTest(bool enabled) {
+    stats.calls++;
+    stats.stateChanges++;
+}
+
+void NullRenderDevice::setDepthWrite(bool enabled) {
+    stats.calls++;
+    stats.stateChanges++;
+}
+
+void NullRenderDevice::setBlending(bool enabled) {
+    stats.calls++;
+    stats.stateChanges++;
+}
+
+void NullRenderDevice::setWireframe(bool enabled, float lineWidth) {
+    stats.calls++;
+    stats.stateChanges++;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "render_device.h"
+
+// Traffic counted by NullRenderDevice since the last resetStats()
+struct RenderDeviceStats {
+    size_t calls = 0;              // Every device call
+    size_t drawCalls = 0;
+    size_t elementsDrawn = 0;      // Indices or vertices submitted by draws
+    size_t meshUploads = 0;        // updateMesh and updateIndices calls
+    size_t bytesUploaded = 0;      // Vertex plus index bytes
+    size_t uniformUpdates = 0;
+    size_t uniformBufferUpdates = 0;
+    size_t programBinds = 0;
+    size_t textureBinds = 0;
+    size_t stateChanges = 0;       // Depth, blending and wireframe toggles
+};
+
+/**
+ * NullRenderDevice accepts every call and draws nothing, but counts what a real
+ * device would have been asked to do. Handles are unique so callers behave
+ * exactly as with a real device; used for headless runs and for checking
+ * per-frame GPU traffic.
+ */
+class NullRenderDevice : public RenderDevice {
+public:
+    NullRenderDevice() : nextHandle(1), liveMeshes(0), livePrograms(0) {}
+
+    MeshHandle createMesh(const VertexLayout& layout) override;
+    void updateMesh(MeshHandle mesh, const float* vertices, size_t floatCount,
+                    const unsigned int* indices, size_t indexCount, BufferUsage usage) override;
+    void updateIndices(MeshHandle mesh, const unsigned int* indices, size_t indexCount) override;
+    void deleteMesh(MeshHandle mesh) override;
+    void drawMesh(MeshHandle mesh, PrimitiveType primitive, size_t count, size_t first) override;
+    void drawMeshRanges(MeshHandle mesh, PrimitiveType primitive, const size_t* firsts,
+                        const size_t* counts, int rangeCount) override;
+    unsigned int createProgram(const char* vertexSource, const char* fragmentSource) override;
+    void deleteProgram(unsigned int program) override;
+    void useProgram(unsigned int program) override;
+    UniformLocation getUniformLocation(unsigned int program, const char* name) override;
+    void setUniform(UniformLocation location, const glm::mat4& value) override;
+    void setUniform(UniformLocation location, const glm::vec3& value) override;
+    void setUniform(UniformLocation location, float value) override;
+    void setUniform(UniformLocation location, int value) override;
+    void setUniform(unsigned int program, const char* name, const glm::mat4& value) override;
+    void setUniform(unsigned int program, const char* name, const glm::vec3& value) override;
+    void setUniform(unsigned int program, const char* name, float value) override;
+    void setUniform(unsigned int program, const char* name, int value) override;
+    UniformBufferHandle createUniformBuffer(UniformBlock block, size_t bytes) override;
+    void updateUniformBuffer(UniformBufferHandle buffer, const void* data, size_t bytes) override;
+    void deleteUniformBuffer(UniformBufferHandle buffer) override;
+    unsigned int createTexture(int width, int height, const unsigned char* rgba) override;
+    void deleteTexture(unsigned int texture) override;
+    void bindTexture(int unit, unsigned int texture) override;
+    void setDepthTest(bool enabled) override;
+    void setDepthWrite(bool enabled) override;
+    void setBlending(bool enabled) override;
+    void setWireframe(bool enabled, float lineWidth) override;
+
+    const RenderDeviceStats& getStats() const { return stats; }
+    void resetStats() { stats = RenderDeviceStats(); }
+
+    // Objects created and not yet deleted (not affected by resetStats)
+    size_t getLiveMeshCount() const { return liveMeshes; }
+    size_t getLiveProgramCount() const { return livePrograms; }
+
+private:
+    unsigned int nextHandle;       // Shared by every kind of object
+    size_t liveMeshes;
+    size_t livePrograms;
+    RenderDeviceStats stats;
+};
@@ -0,0 +1,191 @@
+#include "occlusion_buffer.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HACKVOXEL_OCCLUSION_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// Corners closer than this (clip w, in blocks) are treated as crossing the near plane
+const float NEAR_W = 0.1f;
+
+// Tested boxes are moved this much nearer (relative 1/w), so an occluder lying
+// on a box's own face never hides it through rounding
+const float DEPTH_BIAS = 1.001f;
+
+// Box faces as corner quads, counter-clockwise seen from outside
+const int BOX_FACES[6][4] = {
+    { 0, 4, 6, 2 },   // -X
+    { 1, 3, 7, 5 },   // +X
+    { 0, 1, 5, 4 },   // -Y
+    { 2, 6, 7, 3 },   // +Y
+    { 0, 2, 3, 1 },   // -Z
+    { 4, 5, 7, 6 }    // +Z
+};
+
+}
+
+OcclusionBuffer::OcclusionBuffer()
+    : viewProjection(1.0f)
+    , depth(WIDTH * HEIGHT, 0.0f)
+    , tileDepth(TILES_X * TILES_Y, 0.0f)
+    , occluderCount(0)
+    , triangleCount(0)
+{
+}
+
+void OcclusionBuffer::begin(const glm::mat4& matrix) {
+    viewProjection = matrix;
+    std::fill(depth.begin(), depth.end(), 0.0f);
+    occluderCount = 0;
+    triangleCount = 0;
+}
+
+bool OcclusionBuffer::projectBox(const glm::vec3& min, const glm::vec3& max, ScreenVertex* corners) const {
+    for (int i = 0; i < 8; i++) {
+        glm::vec4 corner((i & 1) ? max.x : min.x, (i & 2) ? max.y : min.y, (i & 4) ? max.z : min.z, 1.0f);
+        glm::vec4 clip = viewProjection * corner;
+        if (clip.w < NEAR_W) return false;
+        float invW = 1.0f / clip.w;
+        corners[i].x = (clip.x * invW * 0.5f + 0.5f) * WIDTH;
+        corners[i].y = (clip.y * invW * 0.5f + 0.5f) * HEIGHT;
+        corners[i].invW = invW;
+    }
+    return true;
+}
+
+void OcclusionBuffer::addOccluder(const glm::vec3& min, const glm::vec3& max) {
+    ScreenVertex corners[8];
+    if (!projectBox(min, max, corners)) return;
+    occluderCount++;
+    for (const auto& face : BOX_FACES) {
+        rasterizeTriangle(corners[face[0]], corners[face[1]], corners[face[2]]);
+        rasterizeTriangle(corners[face[0]], corners[face[2]], corners[face[3]]);
+    }
+}
+
+void OcclusionBuffer::rasterizeTriangle(const ScreenVertex& a, const ScreenVertex& b, const ScreenVertex& c) {
+    // Back faces (clockwise on screen) are hidden by the front ones
+    float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    if (area <= 0.0f) return;
+
+    int minX = std::max(0, static_cast<int>(std::floor(std::min({ a.x, b.x, c.x }))));
+    int maxX = std::min(WIDTH - 1, static_cast<int>(std::ceil(std::max({ a.x, b.x, c.x }))));
+    int minY = std::max(0, static_cast<int>(std::floor(std::min({ a.y, b.y, c.y }))));
+    int maxY = std::min(HEIGHT - 1, static_cast<int>(std::ceil(std::max({ a.y, b.y, c.y }))));
+    if (minX > maxX || minY > maxY) return;
+    triangleCount++;
+
+    // Edge functions e = ex * x + ey * y + e0, non-negative inside. 1/w is
+    // affine in screen space, so it interpolates the same way.
+    float e1x = -(c.y - b.y), e1y = c.x - b.x, e10 = -(e1x * b.x + e1y * b.y);
+    float e2x = -(a.y - c.y), e2y = a.x - c.x, e20 = -(e2x * c.x + e2y * c.y);
+    float e3x = -(b.y - a.y), e3y = b.x - a.x, e30 = -(e3x * a.x + e3y * a.y);
+    float inverseArea = 1.0f / area;
+    float zx = (e1x * a.invW + e2x * b.invW + e3x * c.invW) * inverseArea;
+    float zy = (e1y * a.invW + e2y * b.invW + e3y * c.invW) * inverseArea;
+    float z0 = (e10 * a.invW + e20 * b.invW + e30 * c.invW) * inverseArea;
+
+#ifdef HACKVOXEL_OCCLUSION_SSE2
+    // Whole groups of four pixels; rows are a multiple of four wide
+    int startX = minX & ~3;
+    const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    const __m128 zero = _mm_setzero_ps();
+    for (int y = minY; y <= maxY; y++) {
+        float py = y + 0.5f;
+        __m128 row1 = _mm_set1_ps(e1y * py + e10);
+        __m128 row2 = _mm_set1_ps(e2y * py + e20);
+        __m128 row3 = _mm_set1_ps(e3y * py + e30);
+        __m128 rowZ = _mm_set1_ps(zy * py + z0);
+        float* line = &depth[y * WIDTH];
+        for (int x = startX; x <= maxX; x += 4) {
+            __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+            __m128 edge1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(e1x), px), row1);
+            __m128 edge2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(e2x), px), row2);
+            __m128 edge3 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(e3x), px), row3);
+            __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(edge1, zero), _mm_cmpge_ps(edge2, zero)),
+                                       _mm_cmpge_ps(edge3, zero));
+            if (_mm_movemask_ps(inside) == 0) continue;
+            __m128 z = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(zx), px), rowZ);
+            __m128 current = _mm_loadu_ps(line + x);
+            __m128 nearer = _mm_max_ps(current, z);
+            _mm_storeu_ps(line + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, current)));
+        }
+    }
+#else
+    for (int y = minY; y <= maxY; y++) {
+        float py = y + 0.5f;
+        float* line = &depth[y * WIDTH];
+        for (int x = minX; x <= maxX; x++) {
+            float px = x + 0.5f;
+            if (e1x * px + e1y * py + e10 < 0.0f || e2x * px + e2y * py + e20 < 0.0f ||
+                e3x * px + e3y * py + e30 < 0.0f) {
+                continue;
+            }
+            float z = zx * px + zy * py + z0;
+            if (z > line[x]) line[x] = z;
+        }
+    }
+#endif
+}
+
+void OcclusionBuffer::finish() {
+    for (int ty = 0; ty < TILES_Y; ty++) {
+        for (int tx = 0; tx < TILES_X; tx++) {
+            float farthest = depth[(ty * TILE_SIZE) * WIDTH + tx * TILE_SIZE];
+            for (int y = 0; y < TILE_SIZE; y++) {
+                const float* line = &depth[(ty * TILE_SIZE + y) * WIDTH + tx * TILE_SIZE];
+                for (int x = 0; x < TILE_SIZE; x++) {
+                    farthest = std::min(farthest, line[x]);
+                }
+            }
+            tileDepth[ty * TILES_X + tx] = farthest;
+        }
+    }
+}
+
+bool OcclusionBuffer::isOccluded(const glm::vec3& min, const glm::vec3& max) const {
+    if (occluderCount == 0) return false;
+
+    ScreenVertex corners[8];
+    if (!projectBox(min, max, corners)) return false;
+
+    // Depth is affine in world space, so the nearest point of the box is a corner
+    float minX = corners[0].x, maxX = corners[0].x, minY = corners[0].y, maxY = corners[0].y;
+    float nearest = corners[0].invW;
+    for (int i = 1; i < 8; i++) {
+        minX = std::min(minX, corners[i].x);
+        maxX = std::max(maxX, corners[i].x);
+        minY = std::min(minY, corners[i].y);
+        maxY = std::max(maxY, corners[i].y);
+        nearest = std::max(nearest, corners[i].invW);
+    }
+    nearest *= DEPTH_BIAS;
+
+    // Grown by a pixel, since occluders cover pixels whose centers they cover
+    int left = std::max(0, static_cast<int>(std::floor(minX)) - 1);
+    int right = std::min(WIDTH - 1, static_cast<int>(std::ceil(maxX)) + 1);
+    int bottom = std::max(0, static_cast<int>(std::floor(minY)) - 1);
+    int top = std::min(HEIGHT - 1, static_cast<int>(std::ceil(maxY)) + 1);
+    if (left > right || bottom > top) return false;
+
+    for (int ty = bottom / TILE_SIZE; ty <= top / TILE_SIZE; ty++) {
+        for (int tx = left / TILE_SIZE; tx <= right / TILE_SIZE; tx++) {
+            // The whole tile is nearer than the box
+            if (tileDepth[ty * TILES_X + tx] > nearest) continue;
+
+            int x0 = std::max(left, tx * TILE_SIZE), x1 = std::min(right, tx * TILE_SIZE + TILE_SIZE - 1);
+            int y0 = std::max(bottom, ty * TILE_SIZE), y1 = std::min(top, ty * TILE_SIZE + TILE_SIZE - 1);
+            for (int y = y0; y <= y1; y++) {
+                const float* line = &depth[y * WIDTH];
+                for (int x = x0; x <= x1; x++) {
+                    if (line[x] <= nearest) return false;
+                }
+            }
+        }
+    }
+    return true;
+}
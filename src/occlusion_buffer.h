@@ -0,0 +1,61 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+/**
+ * OcclusionBuffer is a small software depth buffer for occlusion culling.
+ * Solid boxes known to block the view (occluders) are rasterized into it on
+ * the CPU each frame, four pixels at a time with SSE2 where available. Then
+ * bounding boxes are tested against a hierarchical copy first, which holds the
+ * farthest depth of each 8x8 tile, and only against pixels where that is not
+ * enough. Depth is stored as 1/w, so larger is nearer and clearing to 0 means
+ * nothing blocks the view.
+ *
+ * Tests are conservative: a box counts as occluded only if every pixel of its
+ * screen rectangle, grown by one pixel, is covered by nearer occluders. Boxes
+ * crossing the near plane and boxes entirely off screen always count as visible.
+ */
+class OcclusionBuffer {
+public:
+    static const int WIDTH = 128;
+    static const int HEIGHT = 64;
+    static const int TILE_SIZE = 8;
+    static const int TILES_X = WIDTH / TILE_SIZE;
+    static const int TILES_Y = HEIGHT / TILE_SIZE;
+
+    OcclusionBuffer();
+
+    // Clear the buffer and set the camera for this frame's occluders and tests
+    void begin(const glm::mat4& viewProjection);
+
+    // Rasterize the front faces of a solid world-space box. Boxes reaching
+    // behind the near plane are skipped.
+    void addOccluder(const glm::vec3& min, const glm::vec3& max);
+
+    // Build the tile level; call after the last occluder and before testing
+    void finish();
+
+    // Whether a world-space box is hidden behind the occluders
+    bool isOccluded(const glm::vec3& min, const glm::vec3& max) const;
+
+    int getOccluderCount() const { return occluderCount; }
+    int getTriangleCount() const { return triangleCount; }
+
+private:
+    struct ScreenVertex {
+        float x, y;     // Pixels, y up
+        float invW;
+    };
+
+    // Project the 8 corners (index bit 0 x, bit 1 y, bit 2 z); false if any is
+    // too close to or behind the camera
+    bool projectBox(const glm::vec3& min, const glm::vec3& max, ScreenVertex* corners) const;
+    void rasterizeTriangle(const ScreenVertex& a, const ScreenVertex& b, const ScreenVertex& c);
+
+    glm::mat4 viewProjection;
+    std::vector<float> depth;       // WIDTH * HEIGHT, row 0 at the bottom
+    std::vector<float> tileDepth;   // Farthest (smallest) depth per tile
+    int occluderCount;
+    int triangleCount;
+};
@@ -1,6 +1,7 @@
 #include "player.h"
 #include "chunk_manager.h"
-#include <iostream>
+#include "log.h"
+#include "profiler.h"
 #include <algorithm>
 #include <cmath>
 
@@ -20,16 +21,17 @@ Player::Player(glm::vec3 startPosition)
     , isOnGround(false)
     , canJump(true)
 {
-    std::cout << "Player created at position: " << position.x << ", " << position.y << ", " << position.z << std::endl;
+    LOG_INFO("Player created at position: " << position.x << ", " << position.y << ", " << position.z);
 }
 
 // ============================================================================
 // MAIN UPDATE LOOP - PROCESS PHYSICS AND INPUT
 // ============================================================================
-void Player::update(float deltaTime, GLFWwindow* window, Camera& camera, 
+void Player::update(float deltaTime, const MovementInput& input, Camera& camera, 
                    ChunkManager& chunkManager) {
+    PROFILE_SCOPE("Player::update");
     // Process player input
-    processInput(window, camera, deltaTime);
+    processInput(input, camera, deltaTime);
     
     // Apply physics
     applyGravity(deltaTime);
@@ -51,7 +53,7 @@ void Player::update(float deltaTime, GLFWwindow* window, Camera& camera,
 // ============================================================================
 // PROCESS INPUT FOR MOVEMENT AND JUMPING
 // ============================================================================
-void Player::processInput(GLFWwindow* window, Camera& camera, float deltaTime) {
+void Player::processInput(const MovementInput& input, Camera& camera, float deltaTime) {
     // Get movement input
     glm::vec3 moveInput(0.0f);
     
@@ -60,16 +62,16 @@ void Player::processInput(GLFWwindow* window, Camera& camera, float deltaTime) {
     glm::vec3 right = glm::normalize(glm::cross(forward, glm::vec3(0.0f, 1.0f, 0.0f)));
     
     // WASD movement
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) {
+    if (input.forward) {
         moveInput += forward;
     }
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
+    if (input.backward) {
         moveInput -= forward;
     }
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) {
+    if (input.left) {
         moveInput -= right;
     }
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) {
+    if (input.right) {
         moveInput += right;
     }
     
@@ -78,7 +80,7 @@ void Player::processInput(GLFWwindow* window, Camera& camera, float deltaTime) {
         moveInput = glm::normalize(moveInput);
         
         // Apply speed (check for sprint)
-        float currentSpeed = (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS) ? 
+        float currentSpeed = input.sprint ? 
                            sprintSpeed : walkSpeed;
         
         // Apply movement to horizontal velocity
@@ -93,21 +95,16 @@ void Player::processInput(GLFWwindow* window, Camera& camera, float deltaTime) {
     }
     
     // Jumping
-    if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS && isOnGround && canJump) {
+    if (input.up && isOnGround && canJump) {
         velocity.y = jumpStrength;
         isOnGround = false;
         canJump = false;  // Prevent bunny hopping
     }
     
     // Reset jump flag when space is released
-    if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_RELEASE) {
+    if (!input.up) {
         canJump = true;
     }
-    
-    // Exit application (ESC key)
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
-        glfwSetWindowShouldClose(window, true);
-    }
 }
 
 // ============================================================================
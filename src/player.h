@@ -1,8 +1,6 @@
 #pragma once
 
-#include <glad/gl.h>  // Include glad first
 #include <glm/glm.hpp>
-#include <GLFW/glfw3.h>
 #include "camera.h"
 #include "voxel_chunk.h"
 #include <vector>
@@ -45,7 +43,7 @@ public:
     
     // ============================================================================    // UPDATE METHODS
     // ============================================================================
-    void update(float deltaTime, GLFWwindow* window, Camera& camera, 
+    void update(float deltaTime, const MovementInput& input, Camera& camera, 
                 ChunkManager& chunkManager);
     
     // ============================================================================
@@ -59,7 +57,7 @@ public:
     // ============================================================================
     // INPUT PROCESSING
     // ============================================================================
-    void processInput(GLFWwindow* window, Camera& camera, float deltaTime);
+    void processInput(const MovementInput& input, Camera& camera, float deltaTime);
     
 private:
     // ============================================================================    // INTERNAL PHYSICS HELPERS
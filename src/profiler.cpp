@@ -0,0 +1,179 @@
+#include "profiler.h"
+#include <cstdio>
+#include <cstring>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#else
+#include <unistd.h>
+#endif
+
+Profiler& Profiler::get() {
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Profiler()
+    : enabled(true), history(HISTORY_FRAMES), currentFrame(-1), completedFrames(0),
+      openDepth(0), skippedDepth(0) {
+}
+
+void Profiler::beginFrame() {
+    Clock::time_point now = Clock::now();
+    AllocationTracker::Counts allocations = AllocationTracker::getThreadCounts();
+    if (currentFrame >= 0 && std::this_thread::get_id() == owner) {
+        Frame& frame = history[currentFrame];
+        frame.durationMs = std::chrono::duration<float, std::milli>(now - frameStart).count();
+        frame.allocations = static_cast<int>(allocations.allocations - frameStartAllocations.allocations);
+        frame.allocatedBytes = static_cast<size_t>(allocations.bytes - frameStartAllocations.bytes);
+        completedFrames++;
+        Trace::counter("frame ms", frame.durationMs);
+    }
+    Trace::instant("frame");
+
+    owner = std::this_thread::get_id();
+    currentFrame = (currentFrame + 1) % HISTORY_FRAMES;
+    Frame& frame = history[currentFrame];
+    frame.durationMs = 0.0f;
+    frame.allocations = 0;
+    frame.allocatedBytes = 0;
+    frame.scopeCount = 0;
+    frame.droppedScopes = 0;
+    frameStart = now;
+    frameStartAllocations = allocations;
+    openDepth = 0;
+    skippedDepth = 0;
+}
+
+void Profiler::setEnabled(bool enable) {
+    // Only between frames, so no scope is left open across the switch
+    enabled = enable;
+    openDepth = 0;
+    skippedDepth = 0;
+}
+
+void Profiler::beginScope(const char* name) {
+    if (!recordsOnThisThread() || currentFrame < 0) return;
+
+    Frame& frame = history[currentFrame];
+    if (skippedDepth > 0 || openDepth == MAX_DEPTH || frame.scopeCount == MAX_SCOPES_PER_FRAME) {
+        skippedDepth++;
+        frame.droppedScopes++;
+        return;
+    }
+
+    int index = frame.scopeCount++;
+    Scope& scope = frame.scopes[index];
+    scope.name = name;
+    scope.parent = openDepth > 0 ? openScopes[openDepth - 1] : -1;
+    scope.depth = openDepth;
+    scope.startMs = millisecondsSince(frameStart);
+    scope.durationMs = 0.0f;
+    scope.allocations = 0;
+    scope.allocatedBytes = 0;
+    openAllocations[openDepth] = AllocationTracker::getThreadCounts();
+    openScopes[openDepth++] = index;
+}
+
+void Profiler::endScope() {
+    if (!recordsOnThisThread() || currentFrame < 0) return;
+
+    if (skippedDepth > 0) {
+        skippedDepth--;
+        return;
+    }
+    if (openDepth == 0) return;
+
+    Scope& scope = history[currentFrame].scopes[openScopes[--openDepth]];
+    scope.durationMs = millisecondsSince(frameStart) - scope.startMs;
+    AllocationTracker::Counts allocations = AllocationTracker::getThreadCounts();
+    scope.allocations = static_cast<int>(allocations.allocations - openAllocations[openDepth].allocations);
+    scope.allocatedBytes = static_cast<size_t>(allocations.bytes - openAllocations[openDepth].bytes);
+}
+
+const Profiler::Frame& Profiler::getFrame(int framesAgo) const {
+    int slot = ((currentFrame - 1 - framesAgo) % HISTORY_FRAMES + HISTORY_FRAMES) % HISTORY_FRAMES;
+    return history[slot];
+}
+
+float Profiler::getAverageMs(const char* name, int frameCount) const {
+    int frames = frameCount < getFrameCount() ? frameCount : getFrameCount();
+    if (frames == 0) return 0.0f;
+
+    float total = 0.0f;
+    for (int i = 0; i < frames; i++) {
+        const Frame& frame = getFrame(i);
+        for (int s = 0; s < frame.scopeCount; s++) {
+            const Scope& scope = frame.scopes[s];
+            // Names are literals, but the same name may be spelled in more than one place
+            if (scope.name == name || std::strcmp(scope.name, name) == 0) {
+                total += scope.durationMs;
+            }
+        }
+    }
+    return total / frames;
+}
+
+void Profiler::formatSummary(int frameCount, std::string& out) const {
+    int frames = frameCount < getFrameCount() ? frameCount : getFrameCount();
+    if (frames == 0) {
+        out = "no frames profiled";
+        return;
+    }
+
+    float totalMs = 0.0f, maxMs = 0.0f;
+    for (int i = 0; i < frames; i++) {
+        totalMs += getFrame(i).durationMs;
+        if (getFrame(i).durationMs > maxMs) maxMs = getFrame(i).durationMs;
+    }
+
+    char text[128];
+    std::snprintf(text, sizeof(text), "frame %.2f ms avg, %.2f ms max", totalMs / frames, maxMs);
+    out = text;
+    const Frame& latest = getFrame(0);
+    if (AllocationTracker::isEnabled()) {
+        std::snprintf(text, sizeof(text), ", %d allocs", latest.allocations);
+        out += text;
+    }
+    for (int s = 0; s < latest.scopeCount; s++) {
+        if (latest.scopes[s].depth != 0) continue;
+        std::snprintf(text, sizeof(text), " | %s %.2f", latest.scopes[s].name, getAverageMs(latest.scopes[s].name, frames));
+        out += text;
+    }
+}
+
+float Profiler::millisecondsSince(Clock::time_point start) const {
+    return std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+}
+
+size_t Profiler::getProcessMemoryBytes() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.WorkingSetSize;
+    }
+    return 0;
+#elif defined(__APPLE__)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) == KERN_SUCCESS) {
+        return info.resident_size;
+    }
+    return 0;
+#else
+    // Second field of statm: resident pages
+    FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (!statm) return 0;
+    unsigned long totalPages = 0, residentPages = 0;
+    int fields = std::fscanf(statm, "%lu %lu", &totalPages, &residentPages);
+    std::fclose(statm);
+    if (fields != 2) return 0;
+    return static_cast<size_t>(residentPages) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+#include "allocation_tracker.h"
+#include "trace.h"
+
+/**
+ * Profiler is a hierarchical CPU frame profiler. PROFILE_SCOPE("name") times
+ * the enclosing block; scopes opened inside it become its children. Samples go
+ * into a fixed ring of recent frames, so recording never allocates and costs
+ * two clock reads per scope, cheap enough to leave compiled in.
+ *
+ * Only the thread that calls beginFrame() (the game loop) records; scopes on
+ * other threads, such as hackvoxel-gen's workers, only reach trace captures.
+ * Where AllocationTracker is enabled, frames and scopes also count the heap
+ * allocations made inside them (including those of child scopes).
+ */
+class Profiler {
+public:
+    static const int MAX_SCOPES_PER_FRAME = 128;
+    static const int MAX_DEPTH = 16;
+    static const int HISTORY_FRAMES = 240;
+
+    struct Scope {
+        const char* name;     // String literal passed to PROFILE_SCOPE
+        int parent;           // Index of the enclosing scope in the frame, -1 at the top level
+        int depth;
+        float startMs;        // Relative to the start of the frame
+        float durationMs;
+        int allocations;
+        size_t allocatedBytes;
+    };
+
+    struct Frame {
+        float durationMs;
+        int allocations;
+        size_t allocatedBytes;
+        int scopeCount;
+        int droppedScopes;    // Scopes past MAX_SCOPES_PER_FRAME or MAX_DEPTH
+        Scope scopes[MAX_SCOPES_PER_FRAME];
+    };
+
+    // The process-wide profiler used by PROFILE_SCOPE
+    static Profiler& get();
+
+    // Close the current frame (if any) and start the next one on the calling thread
+    void beginFrame();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled; }
+
+    void beginScope(const char* name);
+    void endScope();
+
+    // Completed frames: 0 is the most recent. Valid for framesAgo < getFrameCount();
+    // one ring slot always holds the frame being recorded.
+    int getFrameCount() const { return completedFrames < HISTORY_FRAMES - 1 ? completedFrames : HISTORY_FRAMES - 1; }
+    const Frame& getFrame(int framesAgo) const;
+
+    // Mean time per frame spent in scopes named name over the last frameCount frames
+    float getAverageMs(const char* name, int frameCount) const;
+
+    // One line with mean/max frame time, allocations of the latest frame and
+    // the mean of each top-level scope over the last frameCount frames, for the
+    // console. Written into out so a reused string does not allocate.
+    void formatSummary(int frameCount, std::string& out) const;
+
+    // Resident memory of the process in bytes, 0 where unsupported. Not cheap:
+    // callers should sample it every few frames.
+    static size_t getProcessMemoryBytes();
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    Profiler();
+
+    bool recordsOnThisThread() const { return enabled && std::this_thread::get_id() == owner; }
+    float millisecondsSince(Clock::time_point start) const;
+
+    bool enabled;
+    std::thread::id owner;
+    std::vector<Frame> history;   // Ring of HISTORY_FRAMES
+    int currentFrame;             // Ring slot being recorded, -1 before the first beginFrame()
+    int completedFrames;
+    Clock::time_point frameStart;
+    AllocationTracker::Counts frameStartAllocations;
+    int openScopes[MAX_DEPTH];    // Indices into the current frame's scopes
+    AllocationTracker::Counts openAllocations[MAX_DEPTH];
+    int openDepth;
+    int skippedDepth;             // Open scopes that were not recorded
+};
+
+// Times the enclosing block under the given name (a string literal), and
+// marks it on the timeline while a trace capture is running
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : traced(Trace::begin(name)) { Profiler::get().beginScope(name); }
+    ~ProfileScope() {
+        Profiler::get().endScope();
+        Trace::end(traced);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    bool traced;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
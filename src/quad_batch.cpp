@@ -0,0 +1,151 @@
+#include "quad_batch.h"
+#include "log.h"
+#include <algorithm>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+
+const char* quadVertexShader = R"(
+#version 330 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in vec4 aColor;
+
+uniform mat4 projection;
+
+out vec2 TexCoord;
+out vec4 Color;
+
+void main() {
+    gl_Position = projection * vec4(aPos, 0.0, 1.0);
+    TexCoord = aTexCoord;
+    Color = aColor;
+}
+)";
+
+const char* quadFragmentShader = R"(
+#version 330 core
+in vec2 TexCoord;
+in vec4 Color;
+out vec4 FragColor;
+
+uniform sampler2D quadTexture;
+uniform int textured;
+
+void main() {
+    FragColor = textured != 0 ? Color * texture(quadTexture, TexCoord) : Color;
+}
+)";
+
+}
+
+QuadBatch::QuadBatch()
+    : device(nullptr), program(0), projectionLocation(-1), texturedLocation(-1), mesh(0),
+      projection(1.0f), texture(0), drawCount(0), quadCount(0) {
+}
+
+QuadBatch::~QuadBatch() {
+    if (!device) return;
+    if (mesh) device->deleteMesh(mesh);
+    if (program) device->deleteProgram(program);
+}
+
+bool QuadBatch::initialize(RenderDevice& renderDevice) {
+    device = &renderDevice;
+    program = device->createProgram(quadVertexShader, quadFragmentShader);
+    if (program == 0) {
+        LOG_ERROR("Failed to create quad batch shader program");
+        return false;
+    }
+    projectionLocation = device->getUniformLocation(program, "projection");
+    texturedLocation = device->getUniformLocation(program, "textured");
+    device->useProgram(program);
+    device->setUniform(program, "quadTexture", 0);
+
+    // Every quad uses the same two triangles, so the index buffer is uploaded
+    // once and each flush only streams vertices
+    std::vector<unsigned int> indices(MAX_QUADS * 6);
+    for (int quad = 0; quad < MAX_QUADS; quad++) {
+        unsigned int first = quad * 4;
+        const unsigned int pattern[] = { first, first + 1, first + 2, first + 2, first + 3, first };
+        std::copy(pattern, pattern + 6, indices.begin() + quad * 6);
+    }
+    VertexLayout layout = { { 2, 2, 4, 0 }, 3 };
+    mesh = device->createMesh(layout);
+    device->updateMesh(mesh, nullptr, 0, indices.data(), indices.size(), BufferUsage::STATIC);
+
+    vertices.reserve(MAX_QUADS * FLOATS_PER_QUAD);
+    return true;
+}
+
+void QuadBatch::begin(int windowWidth, int windowHeight) {
+    projection = glm::ortho(0.0f, (float)windowWidth, 0.0f, (float)windowHeight);
+    vertices.clear();
+    texture = 0;
+    drawCount = 0;
+    quadCount = 0;
+}
+
+void QuadBatch::setTexture(unsigned int newTexture) {
+    if (newTexture == texture) return;
+    flush();
+    texture = newTexture;
+}
+
+void QuadBatch::addQuad(float x, float y, float width, float height, const glm::vec4& color) {
+    addQuad(x, y, width, height, color, 0.0f, 0.0f, 1.0f, 1.0f);
+}
+
+void QuadBatch::addQuad(float x, float y, float width, float height, const glm::vec4& color,
+                        float u0, float v0, float u1, float v1) {
+    if (vertices.size() == MAX_QUADS * FLOATS_PER_QUAD) flush();
+    size_t start = vertices.size();
+    vertices.resize(start + FLOATS_PER_QUAD);
+    writeQuad(&vertices[start], x, y, width, height, color, u0, v0, u1, v1);
+    quadCount++;
+}
+
+void QuadBatch::addQuads(const float* quadVertices, int count, float x, float y) {
+    for (int quad = 0; quad < count; quad++) {
+        if (vertices.size() == MAX_QUADS * FLOATS_PER_QUAD) flush();
+        size_t start = vertices.size();
+        vertices.insert(vertices.end(), quadVertices, quadVertices + FLOATS_PER_QUAD);
+        for (int v = 0; v < 4; v++) {
+            vertices[start + v * FLOATS_PER_VERTEX] += x;
+            vertices[start + v * FLOATS_PER_VERTEX + 1] += y;
+        }
+        quadVertices += FLOATS_PER_QUAD;
+    }
+    quadCount += count;
+}
+
+void QuadBatch::writeQuad(float* out, float x, float y, float width, float height, const glm::vec4& color,
+                          float u0, float v0, float u1, float v1) {
+    // Counter-clockwise from the bottom left
+    const float quad[FLOATS_PER_QUAD] = {
+        x,         y,          u0, v0, color.r, color.g, color.b, color.a,
+        x + width, y,          u1, v0, color.r, color.g, color.b, color.a,
+        x + width, y + height, u1, v1, color.r, color.g, color.b, color.a,
+        x,         y + height, u0, v1, color.r, color.g, color.b, color.a
+    };
+    std::copy(quad, quad + FLOATS_PER_QUAD, out);
+}
+
+void QuadBatch::flush() {
+    if (vertices.empty()) return;
+
+    device->useProgram(program);
+    device->setUniform(projectionLocation, projection);
+    device->setUniform(texturedLocation, texture != 0 ? 1 : 0);
+    if (texture) device->bindTexture(0, texture);
+
+    size_t quads = vertices.size() / FLOATS_PER_QUAD;
+    device->updateMesh(mesh, vertices.data(), vertices.size(), nullptr, 0, BufferUsage::DYNAMIC);
+    device->drawMesh(mesh, PrimitiveType::TRIANGLES, quads * 6);
+    vertices.clear();
+    drawCount++;
+}
+
+void QuadBatch::end() {
+    flush();
+}
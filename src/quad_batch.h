@@ -0,0 +1,69 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include "render_device.h"
+
+/**
+ * QuadBatch draws immediate-mode 2D rectangles in pixel coordinates (origin
+ * bottom-left). Quads are appended to a CPU vertex array with their colour
+ * and texture coordinates, and the array is streamed to one dynamic mesh and
+ * drawn in a single call when the texture changes, the array is full, or the
+ * frame ends. Quads draw in the order they were added.
+ */
+class QuadBatch {
+public:
+    static const int MAX_QUADS = 4096;   // Per flush; more quads just flush early
+    static const int FLOATS_PER_VERTEX = 8;   // Position, texture coordinate, RGBA
+    static const int FLOATS_PER_QUAD = 4 * FLOATS_PER_VERTEX;
+
+    // Write one quad's vertices in the batch format, for callers caching quads
+    static void writeQuad(float* out, float x, float y, float width, float height, const glm::vec4& color,
+                          float u0, float v0, float u1, float v1);
+
+    QuadBatch();
+    ~QuadBatch();
+
+    QuadBatch(const QuadBatch&) = delete;
+    QuadBatch& operator=(const QuadBatch&) = delete;
+
+    // Create the program and buffers (call after the graphics context is ready)
+    bool initialize(RenderDevice& device);
+
+    // Start a frame on a window of the given size; clears the draw counters
+    void begin(int windowWidth, int windowHeight);
+
+    // Texture multiplied into following quads; 0 draws plain colour. Flushes
+    // the quads so far if it changes.
+    void setTexture(unsigned int texture);
+
+    // Append a rectangle, with texture coordinates for textured quads
+    void addQuad(float x, float y, float width, float height, const glm::vec4& color);
+    void addQuad(float x, float y, float width, float height, const glm::vec4& color,
+                 float u0, float v0, float u1, float v1);
+
+    // Append quads written by writeQuad, moved by (x, y)
+    void addQuads(const float* quadVertices, int count, float x, float y);
+
+    // Draw everything appended since the last flush
+    void flush();
+
+    // Flush and finish the frame
+    void end();
+
+    // Draws and quads of the current (or last finished) frame
+    int getDrawCount() const { return drawCount; }
+    int getQuadCount() const { return quadCount; }
+
+private:
+    RenderDevice* device;          // Set by initialize()
+    unsigned int program;
+    UniformLocation projectionLocation;
+    UniformLocation texturedLocation;
+    MeshHandle mesh;
+    std::vector<float> vertices;   // Quads not yet drawn, four vertices each
+    glm::mat4 projection;
+    unsigned int texture;
+    int drawCount;
+    int quadCount;
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <glm/glm.hpp>
+
+// Opaque GPU object handle; 0 is never a valid object
+typedef unsigned int MeshHandle;
+typedef unsigned int UniformBufferHandle;
+
+// Location of a uniform in a program, -1 if the program has none by that name
+typedef int UniformLocation;
+
+// Uniform blocks programs may declare by name. Each block is bound to the
+// binding point of its value at link time, so one buffer serves every program.
+enum class UniformBlock { CAMERA, COUNT };
+
+// std140 contents of the "Camera" block, written once per frame:
+//     layout(std140) uniform Camera {
+//         mat4 view; mat4 projection; mat4 viewProjection; vec4 cameraPosition;
+//     };
+struct CameraUniforms {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 viewProjection;
+    glm::vec4 position;   // World-space eye position, w unused
+};
+
+// Interleaved float vertex attributes, bound to locations 0..attributeCount-1
+struct VertexLayout {
+    static const int MAX_ATTRIBUTES = 4;
+    int attributeSizes[MAX_ATTRIBUTES];   // Floats per attribute
+    int attributeCount;
+};
+
+enum class PrimitiveType { TRIANGLES, TRIANGLE_FAN, LINES };
+enum class BufferUsage { STATIC, DYNAMIC };
+
+/**
+ * RenderDevice is the thin layer between the renderer and the graphics API:
+ * meshes (vertex buffer plus optional index buffer), shader programs and
+ * uniforms, texture binding, draws and the few pipeline states the renderer
+ * toggles. GLRenderDevice forwards to OpenGL; NullRenderDevice only counts the
+ * calls, so the full frame loop can run headless.
+ */
+class RenderDevice {
+public:
+    virtual ~RenderDevice() {}
+
+    // Mesh lifetime and contents; indices may be null for non-indexed meshes, or
+    // to keep the indices of an earlier update
+    virtual MeshHandle createMesh(const VertexLayout& layout) = 0;
+    virtual void updateMesh(MeshHandle mesh, const float* vertices, size_t floatCount,
+                            const unsigned int* indices, size_t indexCount, BufferUsage usage) = 0;
+    // Overwrite the start of a mesh's indices in place, keeping its vertices; no
+    // more indices than the last updateMesh uploaded
+    virtual void updateIndices(MeshHandle mesh, const unsigned int* indices, size_t indexCount) = 0;
+    virtual void deleteMesh(MeshHandle mesh) = 0;
+
+    // Draw count indices (or vertices, for non-indexed meshes) starting at first
+    virtual void drawMesh(MeshHandle mesh, PrimitiveType primitive, size_t count, size_t first = 0) = 0;
+    // Draw several index ranges of an indexed mesh in one call
+    virtual void drawMeshRanges(MeshHandle mesh, PrimitiveType primitive, const size_t* firsts,
+                                const size_t* counts, int rangeCount) = 0;
+
+    // Programs and uniforms; createProgram returns 0 if the shaders fail to build.
+    // A program's uniforms are reflected once when it links, so looking up a
+    // location never reaches the driver. Per-frame callers keep the locations
+    // and set them on the program in use; setting by name is for one-off setup.
+    virtual unsigned int createProgram(const char* vertexSource, const char* fragmentSource) = 0;
+    virtual void deleteProgram(unsigned int program) = 0;
+    virtual void useProgram(unsigned int program) = 0;
+    virtual UniformLocation getUniformLocation(unsigned int program, const char* name) = 0;
+    virtual void setUniform(UniformLocation location, const glm::mat4& value) = 0;
+    virtual void setUniform(UniformLocation location, const glm::vec3& value) = 0;
+    virtual void setUniform(UniformLocation location, float value) = 0;
+    virtual void setUniform(UniformLocation location, int value) = 0;
+    virtual void setUniform(unsigned int program, const char* name, const glm::mat4& value) = 0;
+    virtual void setUniform(unsigned int program, const char* name, const glm::vec3& value) = 0;
+    virtual void setUniform(unsigned int program, const char* name, float value) = 0;
+    virtual void setUniform(unsigned int program, const char* name, int value) = 0;
+
+    // Uniform buffers, bound to their block's binding point for every program
+    virtual UniformBufferHandle createUniformBuffer(UniformBlock block, size_t bytes) = 0;
+    virtual void updateUniformBuffer(UniformBufferHandle buffer, const void* data, size_t bytes) = 0;
+    virtual void deleteUniformBuffer(UniformBufferHandle buffer) = 0;
+
+    // RGBA8 2D texture with nearest filtering and no mipmaps, for UI art such as
+    // font atlases; rows run bottom to top. Returns 0 on failure.
+    virtual unsigned int createTexture(int width, int height, const unsigned char* rgba) = 0;
+    virtual void deleteTexture(unsigned int texture) = 0;
+
+    // Bind a 2D texture to a texture unit
+    virtual void bindTexture(int unit, unsigned int texture) = 0;
+
+    // Pipeline state; blending is always standard alpha blending
+    virtual void setDepthTest(bool enabled) = 0;
+    virtual void setDepthWrite(bool enabled) = 0;
+    virtual void setBlending(bool enabled) = 0;
+    virtual void setWireframe(bool enabled, float lineWidth = 1.0f) = 0;
+
+    // Position, normal, texture coordinate: the layout of chunk and horizon meshes
+    static VertexLayout terrainLayout() {
+        VertexLayout layout = { { 3, 3, 2, 0 }, 3 };
+        return layout;
+    }
+};
@@ -1,14 +1,35 @@
 #include "shader.h"
-#include <iostream>
+#include "log.h"
 
-GLuint createShader(const char* vertexSrc, const char* fragmentSrc) {
-    GLuint vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vertexSrc, nullptr);
-    glCompileShader(vertex);
+namespace {
+
+GLuint compileStage(GLenum stage, const char* source, const char* stageName) {
+    GLuint shader = glCreateShader(stage);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+
+    int success;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        char infoLog[512];
+        glGetShaderInfoLog(shader, 512, nullptr, infoLog);
+        LOG_ERROR(stageName << " shader compilation failed: " << infoLog);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
 
-    GLuint fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fragmentSrc, nullptr);
-    glCompileShader(fragment);
+}
+
+GLuint createShader(const char* vertexSrc, const char* fragmentSrc) {
+    GLuint vertex = compileStage(GL_VERTEX_SHADER, vertexSrc, "Vertex");
+    GLuint fragment = compileStage(GL_FRAGMENT_SHADER, fragmentSrc, "Fragment");
+    if (!vertex || !fragment) {
+        if (vertex) glDeleteShader(vertex);
+        if (fragment) glDeleteShader(fragment);
+        return 0;
+    }
 
     GLuint program = glCreateProgram();
     glAttachShader(program, vertex);
@@ -17,5 +38,15 @@ GLuint createShader(const char* vertexSrc, const char* fragmentSrc) {
 
     glDeleteShader(vertex);
     glDeleteShader(fragment);
+
+    int success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        char infoLog[512];
+        glGetProgramInfoLog(program, 512, nullptr, infoLog);
+        LOG_ERROR("Shader program linking failed: " << infoLog);
+        glDeleteProgram(program);
+        return 0;
+    }
     return program;
-}
\ No newline at end of file
+}
@@ -2,4 +2,5 @@
 #include <string>
 #include <glad/gl.h>
 
-GLuint createShader(const char* vertexSrc, const char* fragmentSrc);
\ No newline at end of file
+// Compile and link a vertex/fragment program; logs the error and returns 0 on failure
+GLuint createShader(const char* vertexSrc, const char* fragmentSrc);
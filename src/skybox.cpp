@@ -1,47 +1,45 @@
 #include "skybox.h"
-#include <iostream>
+#include "log.h"
+#include "profiler.h"
 #include <cmath>
 #include <glm/gtc/type_ptr.hpp>
 
-Skybox::Skybox() : VAO(0), VBO(0), shaderProgram(0), currentTime(0.0f) {
+Skybox::Skybox() : device(nullptr), mesh(0), shaderProgram(0), timeOfDayLocation(-1), currentTimeLocation(-1),
+                   currentTime(0.0f) {
 }
 
 Skybox::~Skybox() {
-    if (VAO) glDeleteVertexArrays(1, &VAO);
-    if (VBO) glDeleteBuffers(1, &VBO);
-    if (shaderProgram) glDeleteProgram(shaderProgram);
+    if (!device) return;
+    if (mesh) device->deleteMesh(mesh);
+    if (shaderProgram) device->deleteProgram(shaderProgram);
 }
 
-bool Skybox::initialize() {
+bool Skybox::initialize(RenderDevice& renderDevice) {
+    device = &renderDevice;
     createSkyboxMesh();
-    createSkyboxShaders();
+    if (!createSkyboxShaders()) {
+        LOG_ERROR("Failed to create skybox shader program");
+        return false;
+    }
     
-    std::cout << "Skybox initialized successfully" << std::endl;
+    LOG_INFO("Skybox initialized successfully");
     return true;
 }
 
-void Skybox::render(const glm::mat4& view, const glm::mat4& projection, float timeOfDay) {
+void Skybox::render(float timeOfDay) {
+    PROFILE_SCOPE("Skybox::render");
     // Disable depth writing for skybox
-    glDepthMask(GL_FALSE);
-    
-    glUseProgram(shaderProgram);
-    
-    // Remove translation from view matrix (keep only rotation)
-    glm::mat4 skyboxView = glm::mat4(glm::mat3(view));
+    device->setDepthWrite(false);
     
-    // Set uniforms
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, glm::value_ptr(skyboxView));
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-    glUniform1f(glGetUniformLocation(shaderProgram, "timeOfDay"), timeOfDay);
-    glUniform1f(glGetUniformLocation(shaderProgram, "currentTime"), currentTime);
+    device->useProgram(shaderProgram);
+    device->setUniform(timeOfDayLocation, timeOfDay);
+    device->setUniform(currentTimeLocation, currentTime);
     
     // Render skybox cube
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLES, 0, 36);
-    glBindVertexArray(0);
+    device->drawMesh(mesh, PrimitiveType::TRIANGLES, 36);
     
     // Re-enable depth writing
-    glDepthMask(GL_TRUE);
+    device->setDepthWrite(true);
 }
 
 void Skybox::update(float deltaTime) {
@@ -100,32 +98,29 @@ void Skybox::createSkyboxMesh() {
         -1.0f,  1.0f, -1.0f
     };
     
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-    
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    
-    glBindVertexArray(0);
+    VertexLayout layout = { { 3, 0, 0, 0 }, 1 };
+    mesh = device->createMesh(layout);
+    device->updateMesh(mesh, vertices.data(), vertices.size(), nullptr, 0, BufferUsage::STATIC);
 }
 
-void Skybox::createSkyboxShaders() {
+bool Skybox::createSkyboxShaders() {
     const char* vertexShaderSource = R"(
         #version 330 core
         layout (location = 0) in vec3 aPos;
         
         out vec3 WorldPos;
         
-        uniform mat4 projection;
-        uniform mat4 view;
+        layout(std140) uniform Camera {
+            mat4 view;
+            mat4 projection;
+            mat4 viewProjection;
+            vec4 cameraPosition;
+        };
         
         void main() {
             WorldPos = aPos;
-            vec4 pos = projection * view * vec4(aPos, 1.0);
+            // Rotation only, so the sky stays centered on the camera
+            vec4 pos = projection * mat4(mat3(view)) * vec4(aPos, 1.0);
             gl_Position = pos.xyww; // Ensure skybox is always at far plane
         }
     )";
@@ -226,53 +221,11 @@ void Skybox::createSkyboxShaders() {
         }
     )";
     
-    shaderProgram = createShader(vertexShaderSource, fragmentShaderSource);
-}
-
-unsigned int Skybox::createShader(const char* vertexSource, const char* fragmentSource) {
-    // Vertex shader
-    unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexSource, nullptr);
-    glCompileShader(vertexShader);
-    
-    // Check vertex shader compilation
-    int success;
-    char infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(vertexShader, 512, nullptr, infoLog);
-        std::cerr << "Vertex shader compilation failed: " << infoLog << std::endl;
-    }
-    
-    // Fragment shader
-    unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentSource, nullptr);
-    glCompileShader(fragmentShader);
-    
-    // Check fragment shader compilation
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(fragmentShader, 512, nullptr, infoLog);
-        std::cerr << "Fragment shader compilation failed: " << infoLog << std::endl;
-    }
-    
-    // Link shaders
-    unsigned int program = glCreateProgram();
-    glAttachShader(program, vertexShader);
-    glAttachShader(program, fragmentShader);
-    glLinkProgram(program);
-    
-    // Check linking
-    glGetProgramiv(program, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(program, 512, nullptr, infoLog);
-        std::cerr << "Shader program linking failed: " << infoLog << std::endl;
-    }
-    
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-    
-    return program;
+    shaderProgram = device->createProgram(vertexShaderSource, fragmentShaderSource);
+    if (shaderProgram == 0) return false;
+    timeOfDayLocation = device->getUniformLocation(shaderProgram, "timeOfDay");
+    currentTimeLocation = device->getUniformLocation(shaderProgram, "currentTime");
+    return true;
 }
 
 glm::vec3 Skybox::getSkyColor(float timeOfDay, float height) const {
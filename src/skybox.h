@@ -1,10 +1,10 @@
 #pragma once
 
-#include <glad/gl.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <vector>
+#include "render_device.h"
 
 /**
  * Skybox renders a beautiful procedural sky around the player
@@ -14,19 +14,18 @@ public:
     Skybox();
     ~Skybox();
     
-    // Initialize the skybox (call after OpenGL context is ready)
-    bool initialize();
+    // Initialize the skybox (call after the graphics context is ready)
+    bool initialize(RenderDevice& device);
     
-    // Render the skybox
-    void render(const glm::mat4& view, const glm::mat4& projection, float timeOfDay = 0.5f);
+    // Render the skybox around the camera in the camera uniform buffer
+    void render(float timeOfDay = 0.5f);
     
     // Update time-based effects
     void update(float deltaTime);
     
 private:
     void createSkyboxMesh();
-    void createSkyboxShaders();
-    unsigned int createShader(const char* vertexSource, const char* fragmentSource);
+    bool createSkyboxShaders();
     
     // Generate procedural sky colors based on time
     glm::vec3 getSkyColor(float timeOfDay, float height) const;
@@ -34,8 +33,11 @@ private:
     glm::vec3 getSunColor(float timeOfDay) const;
     
 private:
-    GLuint VAO, VBO;
-    GLuint shaderProgram;
+    RenderDevice* device;          // Set by initialize()
+    MeshHandle mesh;
+    unsigned int shaderProgram;
+    UniformLocation timeOfDayLocation;
+    UniformLocation currentTimeLocation;
     float currentTime;
     
     // Vertex data for a cube
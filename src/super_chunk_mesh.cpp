@@ -0,0 +1,155 @@
+#include "super_chunk_mesh.h"
+#include "chunk_mesh_buffers.h"
+#include "memory_stats.h"
+#include "profiler.h"
+#include <algorithm>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+
+const int FLOATS_PER_VERTEX = 8;
+
+}
+
+SuperChunkMesh::SuperChunkMesh(RenderDevice& device)
+    : device(device)
+    , region(0, 0)
+    , memberMask(0)
+    , mesh(0)
+    , rangeStart()
+    , waterMask(0)
+    , bytes(0)
+    , topHeight(0)
+    , built(false)
+    , members()
+    , revisions()
+{
+}
+
+SuperChunkMesh::~SuperChunkMesh()
+{
+    if (mesh) device.deleteMesh(mesh);
+    MemoryStats::add(MemoryCategory::CHUNK_MESHES, -static_cast<long long>(bytes));
+}
+
+void SuperChunkMesh::setRegion(const ChunkCoord& newRegion, unsigned int newMemberMask)
+{
+    if (region == newRegion && memberMask == newMemberMask) return;
+    region = newRegion;
+    memberMask = newMemberMask;
+    built = false;
+}
+
+ChunkCoord SuperChunkMesh::getMemberCoord(int member) const
+{
+    return ChunkCoord(region.x * SIZE + member / SIZE, region.z * SIZE + member % SIZE);
+}
+
+int SuperChunkMesh::getMemberIndex(const ChunkCoord& coord) const
+{
+    int x = coord.x - region.x * SIZE;
+    int z = coord.z - region.z * SIZE;
+    if (x < 0 || x >= SIZE || z < 0 || z >= SIZE) return -1;
+    return x * SIZE + z;
+}
+
+int SuperChunkMesh::getMemberCount() const
+{
+    int count = 0;
+    for (int member = 0; member < MEMBER_COUNT; member++) {
+        if (isMember(member)) count++;
+    }
+    return count;
+}
+
+glm::vec3 SuperChunkMesh::getOrigin() const
+{
+    return glm::vec3(region.x * SIZE * VoxelChunk::CHUNK_SIZE, 0.0f, region.z * SIZE * VoxelChunk::CHUNK_SIZE);
+}
+
+glm::vec3 SuperChunkMesh::getBoundsMin() const
+{
+    return getOrigin();
+}
+
+glm::vec3 SuperChunkMesh::getBoundsMax() const
+{
+    return getOrigin() + glm::vec3(SIZE * VoxelChunk::CHUNK_SIZE, topHeight, SIZE * VoxelChunk::CHUNK_SIZE);
+}
+
+bool SuperChunkMesh::isCurrent() const
+{
+    if (!built) return false;
+    for (int member = 0; member < MEMBER_COUNT; member++) {
+        if (isMember(member) && members[member]->getMeshRevision() != revisions[member]) return false;
+    }
+    return true;
+}
+
+void SuperChunkMesh::append(const ChunkMesh& memberMesh, const glm::vec3& offset, ChunkMesh& merged)
+{
+    for (size_t quad = 0; quad < memberMesh.quadRanges.size(); quad++) {
+        uint8_t range = memberMesh.quadRanges[quad];
+        if (ChunkMesh::isSkirtRange(range)) continue;
+        size_t start = merged.vertices.size();
+        auto first = memberMesh.vertices.begin() + quad * 4 * FLOATS_PER_VERTEX;
+        merged.vertices.insert(merged.vertices.end(), first, first + 4 * FLOATS_PER_VERTEX);
+        for (size_t v = start; v < merged.vertices.size(); v += FLOATS_PER_VERTEX) {
+            merged.vertices[v] += offset.x;
+            merged.vertices[v + 1] += offset.y;
+            merged.vertices[v + 2] += offset.z;
+        }
+        merged.quadRanges.push_back(range);
+    }
+}
+
+void SuperChunkMesh::build(VoxelChunk* const* newMembers, ChunkMesh& scratch, ChunkMesh& waterScratch,
+                           ChunkMesh& merged)
+{
+    PROFILE_SCOPE("SuperChunkMesh::build");
+    merged.clear();
+    waterMask = 0;
+    topHeight = 0;
+    for (int member = 0; member < MEMBER_COUNT; member++) {
+        members[member] = isMember(member) ? newMembers[member] : nullptr;
+    }
+    for (int member = 0; member < MEMBER_COUNT; member++) {
+        VoxelChunk* chunk = members[member];
+        if (!chunk) continue;
+        revisions[member] = chunk->getMeshRevision();
+        topHeight = std::max(topHeight, chunk->getTopHeight());
+
+        // Faces between two members are hidden, those toward other chunks kept
+        const int x = member / SIZE, z = member % SIZE;
+        ChunkNeighbors neighbors;
+        neighbors.chunks[0] = z + 1 < SIZE ? members[member + 1] : nullptr;
+        neighbors.chunks[1] = z > 0 ? members[member - 1] : nullptr;
+        neighbors.chunks[2] = x + 1 < SIZE ? members[member + SIZE] : nullptr;
+        neighbors.chunks[3] = x > 0 ? members[member - SIZE] : nullptr;
+        chunk->generateMesh(scratch, LOD, &waterScratch, &neighbors);
+        glm::vec3 offset(x * VoxelChunk::CHUNK_SIZE, 0.0f, z * VoxelChunk::CHUNK_SIZE);
+        append(scratch, offset, merged);
+        if (!waterScratch.vertices.empty()) waterMask |= 1u << member;
+    }
+    VoxelChunk::buildIndices(merged);
+
+    PROFILE_SCOPE("SuperChunkMesh::upload");
+    if (!mesh) {
+        mesh = device.createMesh(RenderDevice::terrainLayout());
+    }
+    device.updateMesh(mesh, merged.vertices.data(), merged.vertices.size(),
+                      merged.indices.data(), merged.indices.size(), BufferUsage::STATIC);
+    std::copy(merged.rangeStart, merged.rangeStart + ChunkMesh::RANGE_COUNT + 1, rangeStart);
+
+    size_t newBytes = merged.vertices.size() * sizeof(float) + merged.indices.size() * sizeof(unsigned int);
+    MemoryStats::add(MemoryCategory::CHUNK_MESHES, static_cast<long long>(newBytes) - static_cast<long long>(bytes));
+    bytes = newBytes;
+    built = true;
+}
+
+void SuperChunkMesh::render(UniformLocation modelLocation, unsigned int faceMask)
+{
+    if (!built || rangeStart[ChunkMesh::RANGE_COUNT] == 0) return;
+    device.setUniform(modelLocation, glm::translate(glm::mat4(1.0f), getOrigin()));
+    ChunkMeshBuffers::drawFaceRanges(device, mesh, rangeStart, faceMask, 0);
+}
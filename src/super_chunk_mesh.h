@@ -0,0 +1,91 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include "chunk_coord.h"
+#include "render_device.h"
+#include "voxel_chunk.h"
+
+/**
+ * SuperChunkMesh merges the coarsest level-of-detail meshes of the chunks of
+ * a SIZE x SIZE region into one opaque mesh, so a distant region costs one
+ * draw (and one model matrix) instead of one per chunk. Water is left out: it
+ * has to be drawn back to front with the nearer chunks' water, so members with
+ * water keep drawing their own water mesh. Only the
+ * chunks in the member mask take part, so regions cut by the edges of the
+ * level-of-detail band can merge the part inside it. Vertices are relative to
+ * the region's corner, which keeps them small.
+ *
+ * The merged meshes remember the mesh revision of every member. Once any
+ * member changes, isCurrent() turns false and the owner draws the members one
+ * by one until it gets around to calling build() again.
+ */
+class SuperChunkMesh {
+public:
+    static const int SIZE = 4;                          // Chunks per side
+    static const int MEMBER_COUNT = SIZE * SIZE;
+    static const int LOD = VoxelChunk::LOD_LEVELS - 1;  // Level of detail of the merged meshes
+
+    explicit SuperChunkMesh(RenderDevice& device);
+    ~SuperChunkMesh();
+
+    SuperChunkMesh(const SuperChunkMesh&) = delete;
+    SuperChunkMesh& operator=(const SuperChunkMesh&) = delete;
+
+    // Region (in units of SIZE chunks) this mesh serves and the chunks of it
+    // that are merged, a bit per chunk in getMemberCoord order. Changing
+    // either invalidates the mesh.
+    const ChunkCoord& getRegion() const { return region; }
+    unsigned int getMemberMask() const { return memberMask; }
+    void setRegion(const ChunkCoord& newRegion, unsigned int newMemberMask);
+    bool isMember(int member) const { return (memberMask >> member) & 1u; }
+    int getMemberCount() const;
+
+    // Chunk coordinate of a region slot, x-major from the region's corner, and
+    // the slot of a chunk coordinate (-1 outside the region)
+    ChunkCoord getMemberCoord(int member) const;
+    int getMemberIndex(const ChunkCoord& coord) const;
+
+    // Merge the members (MEMBER_COUNT slots in getMemberCoord order, loaded
+    // for every member; the others are ignored). The scratch meshes are reused
+    // between builds so they don't allocate.
+    void build(VoxelChunk* const* members, ChunkMesh& scratch, ChunkMesh& waterScratch, ChunkMesh& merged);
+
+    // Whether the merged meshes match the members' current meshes
+    bool isCurrent() const;
+
+    // Forget the merged meshes, e.g. when a member unloads; the GPU buffers are
+    // kept and refilled by the next build
+    void invalidate() { built = false; }
+
+    // World-space bounds of the merged geometry (the whole region across)
+    glm::vec3 getBoundsMin() const;
+    glm::vec3 getBoundsMax() const;
+
+    VoxelChunk* getMember(int member) const { return members[member]; }
+
+    // Whether a member had water at the last build, which it has to draw itself
+    bool hasMemberWater(int member) const { return (waterMask >> member) & 1u; }
+
+    // Draw the mesh (face directions in faceMask) with the terrain program
+    void render(UniformLocation modelLocation, unsigned int faceMask);
+
+private:
+    // Append a member's mesh, moved by offset, to a merged mesh. Skirts are
+    // left out: members only get neighbours that are members too, which are
+    // always drawn at the same level.
+    static void append(const ChunkMesh& mesh, const glm::vec3& offset, ChunkMesh& merged);
+
+    glm::vec3 getOrigin() const;
+
+    RenderDevice& device;
+    ChunkCoord region;
+    unsigned int memberMask;
+    MeshHandle mesh;
+    size_t rangeStart[ChunkMesh::RANGE_COUNT + 1];
+    unsigned int waterMask;          // Members with water, a bit per member
+    size_t bytes;                    // Uploaded vertex and index data
+    int topHeight;                   // Highest member top
+    bool built;
+    VoxelChunk* members[MEMBER_COUNT];
+    unsigned int revisions[MEMBER_COUNT];
+};
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "voxel_chunk.h"
+#include "noise_batch.h"
+
+// Climate and elevation driven biomes
+enum class BiomeType {
+    ARCTIC_TUNDRA, BOREAL_FOREST, TEMPERATE_GRASSLANDS,
+    TEMPERATE_FOREST, MEDITERRANEAN, DESERT,
+    TROPICAL_GRASSLANDS, TROPICAL_RAINFOREST, ALPINE,
+    COASTAL_PLAINS, RIVER_VALLEY, MOUNTAIN_PEAKS
+};
+
+// The 2D (height and biome) part of terrain generation for one world column
+struct TerrainColumn {
+    BiomeType biome;
+    int surfaceHeight;
+    bool isRiver;
+    float ridgeValue;
+    float erosionValue;
+    float vegetationValue;
+};
+
+/**
+ * TerrainGenerator owns the world noise fields and fills chunks with blocks.
+ * Column sampling is exposed on its own so distant terrain can be approximated
+ * without generating full voxel chunks. All queries are const and thread-safe.
+ *
+ * Chunk generation evaluates each noise field over the whole chunk in one
+ * batched (SIMD) call; the pointwise path is kept as the reference and gives
+ * identical blocks.
+ */
+class TerrainGenerator {
+public:
+    static const int WATER_LEVEL = 6; // Sea level
+    static const int ORE_LAYERS = 8;  // Ores only generate below this height
+    static const int GENERATOR_VERSION = 1;  // Bump whenever generated blocks change (invalidates world caches)
+
+    // Lattice spacing in blocks for sparse cave/ore noise
+    static const int CAVE_LATTICE_XZ = 2;
+    static const int CAVE_LATTICE_Y = 1;
+    static const int ORE_LATTICE = 2;
+
+    TerrainGenerator();
+
+    // Evaluate height, biome and surface parameters for a single column
+    TerrainColumn sampleColumn(float worldX, float worldZ) const;
+
+    // Block at height y of a column, ignoring caves and ores
+    BlockType getLayerBlock(const TerrainColumn& column, int y) const;
+
+    // Fill all blocks of a chunk at the given chunk coordinates
+    void generateChunk(VoxelChunk& chunk, int chunkX, int chunkZ) const;
+
+    // Switch chunk generation between batched grids and per-block noise calls
+    void setBatchedNoise(bool enabled) { batchedNoise = enabled; }
+    bool isBatchedNoise() const { return batchedNoise; }
+
+    // Sample cave and ore noise on a coarse lattice (batched path only). Cave
+    // noise is trilinearly interpolated between lattice points; ore noise is
+    // only evaluated exactly in cells whose corners get near an ore value.
+    // Lattice cells that cannot cross the threshold are skipped entirely.
+    // Close to, but not identical to, exact sampling.
+    void setInterpolatedCaves(bool enabled) { interpolatedCaves = enabled; }
+    bool isInterpolatedCaves() const { return interpolatedCaves; }
+
+private:
+    // Raw 2D noise values a column is built from
+    struct ColumnNoise {
+        float baseHeight;
+        float temperature;
+        float humidity;
+        float ridge;
+        float erosion;
+        float vegetation;
+    };
+
+    TerrainColumn buildColumn(float worldX, float worldZ, const ColumnNoise& noise) const;
+    BlockType getOreBlock(int y, float oreNoise) const;   // AIR when no ore
+    void generateChunkPointwise(VoxelChunk& chunk, int chunkX, int chunkZ) const;
+    void generateChunkBatched(VoxelChunk& chunk, int chunkX, int chunkZ) const;
+
+    // How a 3D field is sampled on a coarse lattice by fillSparseVolume
+    struct SparseVolume {
+        float scaleXZ, scaleY;     // Noise position is (scaleXZ * x, scaleY * y, scaleXZ * z)
+        int spacingXZ, spacingY;   // Lattice spacing in blocks
+        float threshold;           // Only values above this matter
+        float margin;              // How far the field may rise above a cell's corners
+        bool interpolate;          // Blend corners, or sample exactly, in cells that may cross
+    };
+
+    // Noise over chunk layers 1..layerCount, laid out like the exact volumes
+    // ([(y - 1)][z][x]). Cells that stay below the threshold hold their largest corner.
+    void fillSparseVolume(const BatchNoise& noise, const SparseVolume& volume,
+                          int chunkX, int chunkZ, int layerCount, float* out) const;
+
+    static constexpr float CAVE_THRESHOLD = 0.45f;   // Cave noise above this is carved out
+    static constexpr float ORE_THRESHOLD = 0.88f;    // Lowest ore noise that places any ore
+
+    // Lattice buffer size for spacings of 2 blocks (1 vertically) or more
+    static const int MAX_SPARSE_LATTICE = (VoxelChunk::CHUNK_SIZE / 2 + 1) * (VoxelChunk::CHUNK_SIZE / 2 + 1) *
+                                          (VoxelChunk::CHUNK_SIZE + 1);
+
+    // Enhanced terrain generation with realistic noise systems
+    BatchNoise heightNoise;
+    BatchNoise caveNoise;
+    BatchNoise biomeNoise;
+    BatchNoise temperatureNoise;
+    BatchNoise humidityNoise;
+    BatchNoise ridgeNoise;       // For mountain ridges
+    BatchNoise erosionNoise;     // For erosion patterns
+    BatchNoise vegetationNoise;  // For vegetation density
+    bool batchedNoise;
+    bool interpolatedCaves;
+};
@@ -1,19 +1,22 @@
 #include "texture_atlas.h"
-#include <iostream>
+#include "log.h"
+#include "memory_stats.h"
+#include <glad/gl.h>
 #include <cmath>
 #include <random>
 
 TextureAtlas::TextureAtlas() 
     : textureID(0)
-    , atlasSize(512)
-    , textureSize(16)
-    , texturesPerRow(atlasSize / textureSize)
+    , atlasSize(ATLAS_SIZE)
+    , textureSize(TEXTURE_SIZE)
+    , texturesPerRow(TEXTURES_PER_ROW)
 {
 }
 
 TextureAtlas::~TextureAtlas() {
     if (textureID != 0) {
         glDeleteTextures(1, &textureID);
+        MemoryStats::add(MemoryCategory::TEXTURES, -static_cast<long long>(getGpuBytes()));
     }
 }
 
@@ -115,6 +118,7 @@ bool TextureAtlas::initialize() {
     // Upload texture to GPU
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, atlasSize, atlasSize, 0, GL_RGB, GL_UNSIGNED_BYTE, atlasData.data());
     glGenerateMipmap(GL_TEXTURE_2D);
+    MemoryStats::add(MemoryCategory::TEXTURES, static_cast<long long>(getGpuBytes()));
 
     // Set texture parameters
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -124,29 +128,12 @@ bool TextureAtlas::initialize() {
 
     glBindTexture(GL_TEXTURE_2D, 0);
 
-    std::cout << "Texture atlas created: " << atlasSize << "x" << atlasSize 
-              << " with " << blockCount << " textures" << std::endl;
+    LOG_INFO("Texture atlas created: " << atlasSize << "x" << atlasSize 
+              << " with " << blockCount << " textures");
 
     return true;
 }
 
-TextureAtlas::TextureUV TextureAtlas::getUV(BlockType blockType) const {
-    int blockIndex = static_cast<int>(blockType);
-    int x = blockIndex % texturesPerRow;
-    int y = blockIndex / texturesPerRow;
-    
-    float texelSize = 1.0f / texturesPerRow;
-    float padding = 0.001f; // Small padding to prevent bleeding
-    
-    TextureUV uv;
-    uv.u1 = x * texelSize + padding;
-    uv.v1 = y * texelSize + padding;
-    uv.u2 = (x + 1) * texelSize - padding;
-    uv.v2 = (y + 1) * texelSize - padding;
-    
-    return uv;
-}
-
 void TextureAtlas::bind(int textureUnit) const {
     glActiveTexture(GL_TEXTURE0 + textureUnit);
     glBindTexture(GL_TEXTURE_2D, textureID);
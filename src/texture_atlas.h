@@ -1,6 +1,5 @@
 #pragma once
 
-#include <glad/gl.h>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -52,17 +51,39 @@ public:    // Block texture types
     // Initialize the texture atlas with procedural textures
     bool initialize();
 
+    // Fixed atlas layout, shared by the texture upload and the (GL-free) mesh UVs
+    static const int ATLAS_SIZE = 512;
+    static const int TEXTURE_SIZE = 16;
+    static const int TEXTURES_PER_ROW = ATLAS_SIZE / TEXTURE_SIZE;
+
     // Get UV coordinates for a specific block type
-    TextureUV getUV(BlockType blockType) const;
+    static TextureUV getUV(BlockType blockType) {
+        int blockIndex = static_cast<int>(blockType);
+        int x = blockIndex % TEXTURES_PER_ROW;
+        int y = blockIndex / TEXTURES_PER_ROW;
+
+        float texelSize = 1.0f / TEXTURES_PER_ROW;
+        float padding = 0.001f; // Small padding to prevent bleeding
+
+        TextureUV uv;
+        uv.u1 = x * texelSize + padding;
+        uv.v1 = y * texelSize + padding;
+        uv.u2 = (x + 1) * texelSize - padding;
+        uv.v2 = (y + 1) * texelSize - padding;
+        return uv;
+    }
 
     // Bind the texture atlas for rendering
     void bind(int textureUnit = 0) const;
 
     // Get the OpenGL texture ID
-    GLuint getTextureID() const { return textureID; }
+    unsigned int getTextureID() const { return textureID; }
+
+    // Estimated video memory: drivers store RGB as RGBA, and the mip chain adds a third
+    size_t getGpuBytes() const { return static_cast<size_t>(atlasSize) * atlasSize * 4 * 4 / 3; }
 
 private:
-    GLuint textureID;
+    unsigned int textureID;
     int atlasSize;          // Size of the atlas (e.g., 512x512)
     int textureSize;        // Size of each individual texture (e.g., 16x16)
     int texturesPerRow;     // Number of textures per row in atlas
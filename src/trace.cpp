@@ -0,0 +1,217 @@
+#include "trace.h"
+#include "log.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// Spare room kept for end events so every recorded begin can be closed
+const size_t END_RESERVE = 64;
+
+struct Event {
+    const char* name;     // String literal; null for end events
+    double value;         // Counter value
+    long long timeNs;     // Since the capture started
+    char phase;           // Chrome trace phase: B, E, C or i
+};
+
+/**
+ * One thread's events. Only the owning thread writes events and count; the
+ * writer thread reads count with acquire ordering, which makes every event
+ * below it visible. A buffer belongs to the capture in session, and its owner
+ * resets it on its first event of a newer capture.
+ */
+struct ThreadBuffer {
+    int threadId = 0;
+    std::string name;                       // Guarded by registryMutex, read when writing a capture
+    std::vector<Event> events;              // Sized once, on the first captured event
+    std::atomic<size_t> count{0};
+    std::atomic<unsigned> session{0};
+    std::atomic<size_t> dropped{0};
+};
+
+std::atomic<bool> capturing{false};
+std::atomic<unsigned> currentSession{0};
+std::atomic<long long> captureStartNs{0};   // Clock time of start(), read by every thread
+
+long long nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+// Buffers live until exit so events of finished threads can still be written
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> registry;
+
+ThreadBuffer& threadBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.push_back(std::make_unique<ThreadBuffer>());
+        buffer = registry.back().get();
+        buffer->threadId = static_cast<int>(registry.size());
+    }
+    return *buffer;
+}
+
+// Buffer ready for this capture's events, or null if it is full
+ThreadBuffer* captureBuffer() {
+    ThreadBuffer& buffer = threadBuffer();
+    unsigned session = currentSession.load(std::memory_order_acquire);
+    if (buffer.session.load(std::memory_order_relaxed) != session) {
+        if (buffer.events.empty()) buffer.events.resize(Trace::EVENTS_PER_THREAD);
+        buffer.count.store(0, std::memory_order_relaxed);
+        buffer.dropped.store(0, std::memory_order_relaxed);
+        buffer.session.store(session, std::memory_order_release);
+    }
+    if (buffer.count.load(std::memory_order_relaxed) >= Trace::EVENTS_PER_THREAD - END_RESERVE) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    return &buffer;
+}
+
+void record(ThreadBuffer& buffer, char phase, const char* name, double value) {
+    size_t index = buffer.count.load(std::memory_order_relaxed);
+    Event& event = buffer.events[index];
+    event.name = name;
+    event.value = value;
+    event.timeNs = nowNs() - captureStartNs.load(std::memory_order_relaxed);
+    event.phase = phase;
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+// Escape for a JSON string literal
+void writeJsonString(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* c = text; *c; c++) {
+        if (*c == '"' || *c == '\\') out << '\\';
+        if (static_cast<unsigned char>(*c) >= 0x20) out << *c;
+    }
+    out << '"';
+}
+
+}
+
+void Trace::start() {
+    captureStartNs.store(nowNs(), std::memory_order_relaxed);
+    currentSession.fetch_add(1, std::memory_order_acq_rel);
+    capturing.store(true, std::memory_order_release);
+}
+
+void Trace::stop() {
+    capturing.store(false, std::memory_order_release);
+}
+
+bool Trace::isCapturing() {
+    return capturing.load(std::memory_order_relaxed);
+}
+
+bool Trace::begin(const char* name) {
+    if (!capturing.load(std::memory_order_relaxed)) return false;
+    ThreadBuffer* buffer = captureBuffer();
+    if (!buffer) return false;
+    record(*buffer, 'B', name, 0.0);
+    return true;
+}
+
+void Trace::end(bool begun) {
+    // Recorded even if the capture stopped meanwhile, so the slice is closed
+    if (!begun) return;
+    ThreadBuffer& buffer = threadBuffer();
+    if (buffer.session.load(std::memory_order_relaxed) != currentSession.load(std::memory_order_relaxed)) return;
+    if (buffer.count.load(std::memory_order_relaxed) >= EVENTS_PER_THREAD) return;
+    record(buffer, 'E', nullptr, 0.0);
+}
+
+void Trace::counter(const char* name, double value) {
+    if (!capturing.load(std::memory_order_relaxed)) return;
+    if (ThreadBuffer* buffer = captureBuffer()) record(*buffer, 'C', name, value);
+}
+
+void Trace::instant(const char* name) {
+    if (!capturing.load(std::memory_order_relaxed)) return;
+    if (ThreadBuffer* buffer = captureBuffer()) record(*buffer, 'i', name, 0.0);
+}
+
+void Trace::setThreadName(const char* name) {
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    buffer.name = name;
+}
+
+size_t Trace::getEventCount() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    unsigned session = currentSession.load(std::memory_order_acquire);
+    size_t total = 0;
+    for (const auto& buffer : registry) {
+        if (buffer->session.load(std::memory_order_acquire) == session) {
+            total += buffer->count.load(std::memory_order_acquire);
+        }
+    }
+    return total;
+}
+
+size_t Trace::getDroppedCount() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    unsigned session = currentSession.load(std::memory_order_acquire);
+    size_t total = 0;
+    for (const auto& buffer : registry) {
+        if (buffer->session.load(std::memory_order_acquire) == session) {
+            total += buffer->dropped.load(std::memory_order_relaxed);
+        }
+    }
+    return total;
+}
+
+bool Trace::write(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        LOG_ERROR("Cannot write trace " << path);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    unsigned session = currentSession.load(std::memory_order_acquire);
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    out << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 0, \"args\": {\"name\": \"HackVoxel\"}}";
+
+    char timestamp[32];
+    for (const auto& buffer : registry) {
+        if (buffer->session.load(std::memory_order_acquire) != session) continue;
+        size_t count = buffer->count.load(std::memory_order_acquire);
+        if (count == 0) continue;
+
+        std::string name = buffer->name.empty() ? "thread " + std::to_string(buffer->threadId) : buffer->name;
+        out << ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << buffer->threadId
+            << ", \"args\": {\"name\": ";
+        writeJsonString(out, name.c_str());
+        out << "}}";
+
+        for (size_t i = 0; i < count; i++) {
+            const Event& event = buffer->events[i];
+            // Microseconds with nanosecond precision
+            std::snprintf(timestamp, sizeof(timestamp), "%lld.%03lld", event.timeNs / 1000, event.timeNs % 1000);
+            out << ",\n{\"ph\": \"" << event.phase << "\", \"pid\": 1, \"tid\": " << buffer->threadId
+                << ", \"ts\": " << timestamp;
+            if (event.name) {
+                out << ", \"name\": ";
+                writeJsonString(out, event.name);
+            }
+            if (event.phase == 'C') {
+                out << ", \"args\": {\"value\": " << event.value << "}";
+            } else if (event.phase == 'i') {
+                out << ", \"s\": \"t\"";
+            }
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
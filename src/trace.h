@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Trace records timeline events (scope begin/end, counters, instants) for
+ * Chrome trace / Perfetto captures. Every thread writes into its own buffer
+ * with no locks, so it is safe to trace from generation workers; when no
+ * capture is running each call is a single atomic load.
+ *
+ * PROFILE_SCOPE already emits begin/end events, so every profiled scope shows
+ * up in captures. Start a capture, stop it, then write() the events as
+ * Chrome trace JSON (open it in ui.perfetto.dev or chrome://tracing).
+ */
+class Trace {
+public:
+    // Events a thread can hold per capture; later events are dropped
+    static const size_t EVENTS_PER_THREAD = 1 << 16;
+
+    // Start a new capture, discarding the previous one
+    static void start();
+    static void stop();
+    static bool isCapturing();
+
+    // begin returns whether the event was recorded; pass that to end so that
+    // scopes opened before a capture starts do not leave unmatched ends
+    static bool begin(const char* name);
+    static void end(bool begun);
+
+    static void counter(const char* name, double value);
+    static void instant(const char* name);
+
+    // Name of the calling thread in the timeline (copied)
+    static void setThreadName(const char* name);
+
+    // Events recorded by the last (or current) capture, and those dropped
+    static size_t getEventCount();
+    static size_t getDroppedCount();
+
+    // Write the last capture as Chrome trace JSON; call after stop()
+    static bool write(const std::string& path);
+};
@@ -1,44 +1,21 @@
 #include "ui.h"
-#include <iostream>
-#include <glm/gtc/type_ptr.hpp>
 #include "block_database.h"
+#include "log.h"
+#include "memory_stats.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 
 // UI constants
 const float UI::CROSSHAIR_SIZE = 0.02f;
 const float UI::HOTBAR_SLOT_SIZE = 0.08f;
 const float UI::HOTBAR_HEIGHT = 0.12f;
 
-// UI Shaders
-const char* uiVertexShader = R"(
-#version 330 core
-layout (location = 0) in vec2 aPos;
-layout (location = 1) in vec2 aTexCoord;
-
-uniform mat4 projection;
-uniform mat4 model;
-
-out vec2 TexCoord;
-
-void main() {
-    gl_Position = projection * model * vec4(aPos, 0.0, 1.0);
-    TexCoord = aTexCoord;
-}
-)";
-
-const char* uiFragmentShader = R"(
-#version 330 core
-in vec2 TexCoord;
-out vec4 FragColor;
-
-uniform vec3 color;
-uniform float alpha;
-
-void main() {
-    FragColor = vec4(color, alpha);
-}
-)";
-
-UI::UI() : selectedSlot(0), inventoryOpen(false), hasTargetedBlock(false) {
+UI::UI()
+    : selectedSlot(0), inventoryOpen(false), debugOverlayVisible(false),
+      hasTargetedBlock(false),
+      device(nullptr), solidTexCoord(0.0f) {
     // Initialize hotbar with common building blocks
     hotbarBlocks[0] = BlockType::GRASS;
     hotbarBlocks[1] = BlockType::DIRT;
@@ -55,44 +32,48 @@ UI::UI() : selectedSlot(0), inventoryOpen(false), hasTargetedBlock(false) {
 }
 
 UI::~UI() {
-    if (crosshairVAO) glDeleteVertexArrays(1, &crosshairVAO);
-    if (crosshairVBO) glDeleteBuffers(1, &crosshairVBO);
-    if (hotbarVAO) glDeleteVertexArrays(1, &hotbarVAO);
-    if (hotbarVBO) glDeleteBuffers(1, &hotbarVBO);
-    if (hotbarEBO) glDeleteBuffers(1, &hotbarEBO);
-    if (hudVAO) glDeleteVertexArrays(1, &hudVAO);
-    if (hudVBO) glDeleteBuffers(1, &hudVBO);
-    if (inventoryVAO) glDeleteVertexArrays(1, &inventoryVAO);
-    if (inventoryVBO) glDeleteBuffers(1, &inventoryVBO);
-    if (inventoryEBO) glDeleteBuffers(1, &inventoryEBO);
-    if (uiShaderProgram) glDeleteProgram(uiShaderProgram);
 }
 
-bool UI::initialize() {
-    // Create UI shader program
-    uiShaderProgram = createUIShader();
-    if (uiShaderProgram == 0) {
-        std::cerr << "Failed to create UI shader program" << std::endl;
+bool UI::initialize(RenderDevice& renderDevice) {
+    device = &renderDevice;
+    
+    // Every UI element is drawn as quads through one batch
+    if (!quads.initialize(renderDevice) || !font.initialize(renderDevice)) {
         return false;
     }
+    solidTexCoord = font.getSolidTexCoord();
+    
+    // Text that never changes is laid out once
+    glm::vec4 white(1.0f, 1.0f, 1.0f, 1.0f);
+    for (int i = 0; i < BLOCK_TYPE_COUNT; i++) {
+        const char* name = getBlockName(static_cast<BlockType>(i));
+        // Double size where it fits the block info box
+        float scale = font.measure(name, 2.0f) <= 104.0f ? 2.0f : 1.0f;
+        font.layout(name, white, scale, blockNameLabels[i]);
+    }
+    font.layout("Inventory", white, 2.0f, inventoryLabel);
+    const char* gaugeNames[GAUGE_COUNT] = { "loaded", "rendered", "pending", "memory", "allocs" };
+    for (int i = 0; i < GAUGE_COUNT; i++) {
+        font.layout(gaugeNames[i], white, 1.0f, gaugeLabels[i]);
+    }
+    font.layout("cpu", white, 1.0f, memoryLabels[0]);
+    font.layout("gpu", white, 1.0f, memoryLabels[1]);
     
-    // Initialize UI elements
-    initializeCrosshair();
-    initializeHotbar();
-    initializeHUD();
-    initializeInventory();
-    
-    std::cout << "UI system initialized successfully" << std::endl;
+    LOG_INFO("UI system initialized successfully");
     return true;
 }
 
 void UI::render(int windowWidth, int windowHeight) {
+    PROFILE_SCOPE("UI::render");
     // Disable depth testing for UI
-    glDisable(GL_DEPTH_TEST);
+    device->setDepthTest(false);
     
     // Enable blending for UI transparency
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    device->setBlending(true);
+    
+    // Elements only append quads; they are drawn together at the end
+    quads.begin(windowWidth, windowHeight);
+    quads.setTexture(font.getTexture());
     
     // Render main UI elements
     renderCrosshair(windowWidth, windowHeight);
@@ -105,8 +86,14 @@ void UI::render(int windowWidth, int windowHeight) {
         renderInventory(windowWidth, windowHeight);
     }
     
+    if (debugOverlayVisible) {
+        renderDebugOverlay(windowWidth, windowHeight);
+    }
+    
+    quads.end();
+    
     // Re-enable depth testing
-    glEnable(GL_DEPTH_TEST);
+    device->setDepthTest(true);
 }
 
 void UI::selectSlot(int slot) {
@@ -139,38 +126,18 @@ void UI::handleNumberKey(int key) {
 }
 
 void UI::renderCrosshair(int windowWidth, int windowHeight) {
-    glUseProgram(uiShaderProgram);
-    
-    // Set up orthographic projection
-    glm::mat4 projection = glm::ortho(0.0f, (float)windowWidth, 0.0f, (float)windowHeight);
-    glUniformMatrix4fv(glGetUniformLocation(uiShaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-    
     // Center the crosshair
     float centerX = windowWidth * 0.5f;
     float centerY = windowHeight * 0.5f;
     float size = CROSSHAIR_SIZE * windowHeight;
     
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, glm::vec3(centerX - size*0.5f, centerY - size*0.5f, 0.0f));
-    model = glm::scale(model, glm::vec3(size, size, 1.0f));
-    glUniformMatrix4fv(glGetUniformLocation(uiShaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(model));
-    
-    // Set crosshair color (white)
-    glUniform3f(glGetUniformLocation(uiShaderProgram, "color"), 1.0f, 1.0f, 1.0f);
-    glUniform1f(glGetUniformLocation(uiShaderProgram, "alpha"), 0.8f);
-    
-    glBindVertexArray(crosshairVAO);
-    glDrawArrays(GL_LINES, 0, 4);
-    glBindVertexArray(0);
+    // Two one-pixel bars forming a +, white
+    glm::vec3 color(1.0f, 1.0f, 1.0f);
+    drawQuad(centerX - size * 0.5f, centerY - 0.5f, size, 1.0f, color, 0.8f);
+    drawQuad(centerX - 0.5f, centerY - size * 0.5f, 1.0f, size, color, 0.8f);
 }
 
 void UI::renderHotbar(int windowWidth, int windowHeight) {
-    glUseProgram(uiShaderProgram);
-    
-    // Set up orthographic projection
-    glm::mat4 projection = glm::ortho(0.0f, (float)windowWidth, 0.0f, (float)windowHeight);
-    glUniformMatrix4fv(glGetUniformLocation(uiShaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-    
     float slotSize = HOTBAR_SLOT_SIZE * windowHeight;
     float totalWidth = HOTBAR_SIZE * slotSize;
     float startX = (windowWidth - totalWidth) * 0.5f;
@@ -179,129 +146,17 @@ void UI::renderHotbar(int windowWidth, int windowHeight) {
     for (int i = 0; i < HOTBAR_SIZE; i++) {
         float x = startX + i * slotSize;
         
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, glm::vec3(x, y, 0.0f));
-        model = glm::scale(model, glm::vec3(slotSize, slotSize, 1.0f));
-        glUniformMatrix4fv(glGetUniformLocation(uiShaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(model));
-        
         // Set slot color (selected slot is brighter)
         if (i == selectedSlot) {
-            glUniform3f(glGetUniformLocation(uiShaderProgram, "color"), 1.0f, 1.0f, 1.0f);
-            glUniform1f(glGetUniformLocation(uiShaderProgram, "alpha"), 0.8f);
+            drawQuad(x, y, slotSize, slotSize, glm::vec3(1.0f, 1.0f, 1.0f), 0.8f);
         } else {
-            glUniform3f(glGetUniformLocation(uiShaderProgram, "color"), 0.3f, 0.3f, 0.3f);
-            glUniform1f(glGetUniformLocation(uiShaderProgram, "alpha"), 0.6f);
+            drawQuad(x, y, slotSize, slotSize, glm::vec3(0.3f, 0.3f, 0.3f), 0.6f);
         }
-        
-        glBindVertexArray(hotbarVAO);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
-    }
-}
-
-GLuint UI::createUIShader() {
-    // Compile vertex shader
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &uiVertexShader, NULL);
-    glCompileShader(vertexShader);
-    
-    // Check for compilation errors
-    int success;
-    char infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cerr << "UI Vertex shader compilation failed: " << infoLog << std::endl;
-        return 0;
-    }
-    
-    // Compile fragment shader
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &uiFragmentShader, NULL);
-    glCompileShader(fragmentShader);
-    
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cerr << "UI Fragment shader compilation failed: " << infoLog << std::endl;
-        return 0;
-    }
-    
-    // Create shader program
-    GLuint shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-    
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cerr << "UI Shader program linking failed: " << infoLog << std::endl;
-        return 0;
     }
     
-    // Clean up shaders
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-    
-    return shaderProgram;
-}
-
-void UI::initializeCrosshair() {
-    // Crosshair vertices (two lines forming a +)
-    float crosshairVertices[] = {
-        // Horizontal line
-        0.0f, 0.5f,
-        1.0f, 0.5f,
-        // Vertical line
-        0.5f, 0.0f,
-        0.5f, 1.0f
-    };
-    
-    glGenVertexArrays(1, &crosshairVAO);
-    glGenBuffers(1, &crosshairVBO);
-    
-    glBindVertexArray(crosshairVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, crosshairVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(crosshairVertices), crosshairVertices, GL_STATIC_DRAW);
-    
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    
-    glBindVertexArray(0);
-}
-
-void UI::initializeHotbar() {
-    // Hotbar slot vertices (rectangle)
-    float slotVertices[] = {
-        // positions
-        0.0f, 0.0f,  // bottom left
-        1.0f, 0.0f,  // bottom right
-        1.0f, 1.0f,  // top right
-        0.0f, 1.0f   // top left
-    };
-    
-    unsigned int slotIndices[] = {
-        0, 1, 2,  // first triangle
-        2, 3, 0   // second triangle
-    };
-    
-    glGenVertexArrays(1, &hotbarVAO);
-    glGenBuffers(1, &hotbarVBO);
-    glGenBuffers(1, &hotbarEBO);
-    
-    glBindVertexArray(hotbarVAO);
-    
-    glBindBuffer(GL_ARRAY_BUFFER, hotbarVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(slotVertices), slotVertices, GL_STATIC_DRAW);
-    
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, hotbarEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(slotIndices), slotIndices, GL_STATIC_DRAW);
-    
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    
-    glBindVertexArray(0);
+    // Name of the selected block, centered above the bar
+    const TextLayout& name = blockNameLabels[static_cast<int>(hotbarBlocks[selectedSlot])];
+    renderText(name, std::floor((windowWidth - name.width) * 0.5f), std::floor(y + slotSize + 8.0f));
 }
 
 void UI::setSelectedBlockType(BlockType blockType) {
@@ -324,12 +179,6 @@ void UI::clearTargetedBlock() {
 
 void UI::renderHUD(int windowWidth, int windowHeight) {
     // Render debug information and coordinates
-    glUseProgram(uiShaderProgram);
-    
-    // Set up orthographic projection
-    glm::mat4 projection = glm::ortho(0.0f, (float)windowWidth, 0.0f, (float)windowHeight);
-    glUniformMatrix4fv(glGetUniformLocation(uiShaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-    
     // Simple coordinate display (top-left corner)
     float x = 10.0f;
     float y = windowHeight - 30.0f;
@@ -337,19 +186,23 @@ void UI::renderHUD(int windowWidth, int windowHeight) {
     // Draw a simple background for debug info
     drawQuad(5.0f, y - 10.0f, 200.0f, 25.0f, glm::vec3(0.0f, 0.0f, 0.0f), 0.5f);
     
-    // Note: Text rendering would need a proper font system
-    // For now, we'll just show visual indicators
+    // Frame rate over the last second of frames
+    const Profiler& profiler = Profiler::get();
+    int frames = std::min(profiler.getFrameCount(), 60);
+    float totalMs = 0.0f;
+    for (int i = 0; i < frames; i++) {
+        totalMs += profiler.getFrame(i).durationMs;
+    }
+    if (frames > 0 && totalMs > 0.0f) {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.0f fps  %.1f ms", frames * 1000.0f / totalMs, totalMs / frames);
+        renderText(text, x, y - 5.0f, glm::vec3(1.0f, 1.0f, 1.0f), 2.0f);
+    }
 }
 
 void UI::renderInventory(int windowWidth, int windowHeight) {
     if (!inventoryOpen) return;
     
-    glUseProgram(uiShaderProgram);
-    
-    // Set up orthographic projection
-    glm::mat4 projection = glm::ortho(0.0f, (float)windowWidth, 0.0f, (float)windowHeight);
-    glUniformMatrix4fv(glGetUniformLocation(uiShaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-    
     // Center the inventory
     float invWidth = INVENTORY_COLS * 50.0f + 20.0f;
     float invHeight = INVENTORY_ROWS * 50.0f + 60.0f;
@@ -359,6 +212,7 @@ void UI::renderInventory(int windowWidth, int windowHeight) {
     // Draw inventory background
     drawQuad(centerX, centerY, invWidth, invHeight, glm::vec3(0.2f, 0.2f, 0.2f), 0.9f);
     drawBorder(centerX, centerY, invWidth, invHeight, glm::vec3(0.6f, 0.6f, 0.6f));
+    renderText(inventoryLabel, std::floor(centerX + 10.0f), std::floor(centerY + 18.0f));
     
     // Draw inventory slots
     for (int row = 0; row < INVENTORY_ROWS; row++) {
@@ -386,12 +240,6 @@ void UI::renderInventory(int windowWidth, int windowHeight) {
 void UI::renderBlockInfo(int windowWidth, int windowHeight) {
     if (!hasTargetedBlock) return;
     
-    glUseProgram(uiShaderProgram);
-    
-    // Set up orthographic projection
-    glm::mat4 projection = glm::ortho(0.0f, (float)windowWidth, 0.0f, (float)windowHeight);
-    glUniformMatrix4fv(glGetUniformLocation(uiShaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-    
     // Show block info in top-right corner
     float infoWidth = 150.0f;
     float infoHeight = 60.0f;
@@ -406,61 +254,146 @@ void UI::renderBlockInfo(int windowWidth, int windowHeight) {
     glm::vec3 blockColor = getBlockColor(targetedBlockType);
     drawQuad(x + 10.0f, y + 25.0f, 20.0f, 20.0f, blockColor, 1.0f);
     
-    // Note: Block name would be rendered here with proper text rendering
+    // Name beside the colour, block coordinates below
+    renderText(blockNameLabels[static_cast<int>(targetedBlockType)], std::floor(x + 38.0f), std::floor(y + 29.0f));
+    char text[48];
+    std::snprintf(text, sizeof(text), "%d, %d, %d", (int)targetedBlockPosition.x, (int)targetedBlockPosition.y,
+                  (int)targetedBlockPosition.z);
+    renderText(text, std::floor(x + 10.0f), std::floor(y + 10.0f), glm::vec3(0.8f, 0.8f, 0.8f));
 }
 
-void UI::initializeHUD() {
-    // Initialize HUD rendering objects
-    glGenVertexArrays(1, &hudVAO);
-    glGenBuffers(1, &hudVBO);
-    
-    // Simple quad for HUD elements
-    float hudVertices[] = {
-        0.0f, 0.0f,
-        1.0f, 0.0f,
-        1.0f, 1.0f,
-        0.0f, 1.0f
-    };
-    
-    glBindVertexArray(hudVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, hudVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(hudVertices), hudVertices, GL_STATIC_DRAW);
+void UI::renderDebugOverlay(int windowWidth, int windowHeight) {
+    const Profiler& profiler = Profiler::get();
+    const float graphWidth = (float)Profiler::HISTORY_FRAMES;   // One pixel per frame
+    const float graphHeight = 80.0f;
+    const float graphMaxMs = 50.0f;
+    const float budgetMs = 1000.0f / 60.0f;
+    const float pixelsPerMs = graphHeight / graphMaxMs;
     
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+    // Panel below the HUD box in the top-left corner
+    float x = 10.0f;
+    float panelTop = windowHeight - 50.0f;
+    float panelHeight = graphHeight + 156.0f;
+    drawQuad(x - 5.0f, panelTop - panelHeight, graphWidth + 10.0f, panelHeight, glm::vec3(0.0f, 0.0f, 0.0f), 0.6f);
+    
+    // Frame-time graph, newest frame on the right, one bar per frame
+    float graphY = panelTop - graphHeight - 5.0f;
+    int frameCount = profiler.getFrameCount();
+    for (int i = 0; i < frameCount; i++) {
+        float ms = profiler.getFrame(i).durationMs;
+        glm::vec3 color = ms > budgetMs ? glm::vec3(0.95f, 0.25f, 0.2f) : glm::vec3(0.3f, 0.9f, 0.4f);
+        drawQuad(x + graphWidth - 1.0f - i, graphY, 1.0f, std::min(ms, graphMaxMs) * pixelsPerMs, color, 0.9f);
+    }
+    // 60 and 30 fps lines
+    drawQuad(x, graphY + budgetMs * pixelsPerMs, graphWidth, 1.0f, glm::vec3(1.0f, 1.0f, 1.0f), 0.5f);
+    drawQuad(x, graphY + 2.0f * budgetMs * pixelsPerMs, graphWidth, 1.0f, glm::vec3(1.0f, 0.8f, 0.2f), 0.5f);
+    
+    // Average and worst frame of the graph, in its top-left corner
+    char text[64];
+    if (frameCount > 0) {
+        float totalMs = 0.0f, maxMs = 0.0f;
+        for (int i = 0; i < frameCount; i++) {
+            totalMs += profiler.getFrame(i).durationMs;
+            maxMs = std::max(maxMs, profiler.getFrame(i).durationMs);
+        }
+        std::snprintf(text, sizeof(text), "%.2f ms avg  %.2f max", totalMs / frameCount, maxMs);
+        renderText(text, x + 2.0f, graphY + graphHeight - 9.0f, glm::vec3(1.0f, 1.0f, 1.0f));
+    }
     
-    glBindVertexArray(0);
-}
-
-void UI::initializeInventory() {
-    // Initialize inventory rendering objects
-    glGenVertexArrays(1, &inventoryVAO);
-    glGenBuffers(1, &inventoryVBO);
-    glGenBuffers(1, &inventoryEBO);
-    
-    float inventoryVertices[] = {
-        0.0f, 0.0f,
-        1.0f, 0.0f,
-        1.0f, 1.0f,
-        0.0f, 1.0f
+    // Top-level profiler scopes of the last second, stacked left to right
+    // (graph width = one 60 fps frame budget); colours follow scope order
+    static const glm::vec3 scopeColors[] = {
+        glm::vec3(0.35f, 0.6f, 1.0f), glm::vec3(1.0f, 0.6f, 0.2f), glm::vec3(0.7f, 0.4f, 1.0f),
+        glm::vec3(0.3f, 0.9f, 0.9f), glm::vec3(1.0f, 0.9f, 0.3f), glm::vec3(0.9f, 0.4f, 0.6f)
     };
+    const int colorCount = sizeof(scopeColors) / sizeof(scopeColors[0]);
+    float scopeY = graphY - 20.0f;
+    drawQuad(x, scopeY, graphWidth, 12.0f, glm::vec3(0.2f, 0.2f, 0.2f), 0.8f);
+    if (frameCount > 0) {
+        const Profiler::Frame& latest = profiler.getFrame(0);
+        float scopeX = x;
+        int shown = 0;
+        for (int s = 0; s < latest.scopeCount; s++) {
+            if (latest.scopes[s].depth != 0) continue;
+            float ms = profiler.getAverageMs(latest.scopes[s].name, 60);
+            float width = std::min(ms / budgetMs * graphWidth, x + graphWidth - scopeX);
+            drawQuad(scopeX, scopeY, width, 12.0f, scopeColors[shown++ % colorCount], 1.0f);
+            scopeX += width;
+        }
+    }
     
-    unsigned int inventoryIndices[] = {
-        0, 1, 2,
-        2, 3, 0
+    // Gauges: loaded, rendered (then culled, in grey) and pending chunks,
+    // resident memory (scale 2 GiB), then heap allocations of the last frame
+    // (scale 100) where they are counted
+    int lastFrameAllocations = frameCount > 0 ? profiler.getFrame(0).allocations : 0;
+    float gauges[] = {
+        (float)debugStats.loadedChunks / debugStats.maxChunks,
+        (float)debugStats.renderedChunks / debugStats.maxChunks,
+        (float)debugStats.pendingChunks / debugStats.maxChunks,
+        (float)((double)debugStats.memoryBytes / (2048.0 * 1024.0 * 1024.0)),
+        lastFrameAllocations / 100.0f
     };
+    static const glm::vec3 gaugeColors[] = {
+        glm::vec3(0.4f, 0.8f, 0.4f), glm::vec3(0.4f, 0.6f, 1.0f),
+        glm::vec3(1.0f, 0.7f, 0.3f), glm::vec3(0.8f, 0.5f, 0.9f),
+        glm::vec3(0.95f, 0.3f, 0.3f)
+    };
+    int gaugeCount = AllocationTracker::isEnabled() ? GAUGE_COUNT : GAUGE_COUNT - 1;
+    for (int i = 0; i < gaugeCount; i++) {
+        float gaugeY = scopeY - 20.0f - i * 18.0f;
+        drawQuad(x, gaugeY, graphWidth, 10.0f, glm::vec3(0.2f, 0.2f, 0.2f), 0.8f);
+        drawQuad(x, gaugeY, graphWidth * std::min(std::max(gauges[i], 0.0f), 1.0f), 10.0f, gaugeColors[i], 1.0f);
+    }
+    float renderedWidth = graphWidth * std::min(std::max(gauges[1], 0.0f), 1.0f);
+    float culledWidth = std::min(graphWidth * debugStats.culledChunks / debugStats.maxChunks, graphWidth - renderedWidth);
+    if (culledWidth > 0.0f) {
+        drawQuad(x + renderedWidth, scopeY - 38.0f, culledWidth, 10.0f, glm::vec3(0.55f, 0.55f, 0.55f), 1.0f);
+    }
     
-    glBindVertexArray(inventoryVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, inventoryVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(inventoryVertices), inventoryVertices, GL_STATIC_DRAW);
-    
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, inventoryEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(inventoryIndices), inventoryIndices, GL_STATIC_DRAW);
-    
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+    // Gauge values over the bars, after their cached names
+    for (int i = 0; i < gaugeCount; i++) {
+        switch (i) {
+            case 0: std::snprintf(text, sizeof(text), "%d / %d", debugStats.loadedChunks, debugStats.maxChunks); break;
+            case 1: std::snprintf(text, sizeof(text), "%d, %d culled", debugStats.renderedChunks, debugStats.culledChunks); break;
+            case 2: std::snprintf(text, sizeof(text), "%d", debugStats.pendingChunks); break;
+            case 3: std::snprintf(text, sizeof(text), "%zu MB", debugStats.memoryBytes / (1024 * 1024)); break;
+            default: std::snprintf(text, sizeof(text), "%d this frame", lastFrameAllocations); break;
+        }
+        float gaugeY = scopeY - 20.0f - i * 18.0f + 2.0f;
+        renderText(gaugeLabels[i], x + 2.0f, gaugeY);
+        renderText(text, x + 2.0f + gaugeLabels[i].width + BitmapFont::ADVANCE, gaugeY, glm::vec3(1.0f, 1.0f, 1.0f));
+    }
     
-    glBindVertexArray(0);
+    // Accounted memory by category, CPU on the first bar and GPU estimates on
+    // the second (scale 256 MB each). A white tick marks where a budgeted
+    // category would end if it used its whole budget.
+    static const glm::vec3 categoryColors[MemoryStats::CATEGORY_COUNT] = {
+        glm::vec3(0.4f, 0.8f, 0.4f), glm::vec3(0.3f, 0.5f, 0.3f), glm::vec3(0.9f, 0.9f, 0.4f),
+        glm::vec3(0.6f, 0.6f, 0.6f), glm::vec3(0.4f, 0.6f, 1.0f), glm::vec3(0.3f, 0.9f, 0.9f),
+        glm::vec3(0.9f, 0.5f, 0.8f)
+    };
+    const float pixelsPerByte = graphWidth / (256.0f * 1024.0f * 1024.0f);
+    for (int bar = 0; bar < 2; bar++) {
+        float barY = scopeY - 20.0f - (gaugeCount + bar) * 18.0f;
+        drawQuad(x, barY, graphWidth, 10.0f, glm::vec3(0.2f, 0.2f, 0.2f), 0.8f);
+        float barX = x;
+        for (int i = 0; i < MemoryStats::CATEGORY_COUNT; i++) {
+            MemoryCategory category = static_cast<MemoryCategory>(i);
+            if (MemoryStats::isGpu(category) != (bar == 1)) continue;
+            float room = x + graphWidth - barX;
+            float width = std::min(MemoryStats::getBytes(category) * pixelsPerByte, room);
+            if (width > 0.0f) drawQuad(barX, barY, width, 10.0f, categoryColors[i], 1.0f);
+            size_t budget = MemoryStats::getBudget(category);
+            if (budget > 0 && budget * pixelsPerByte < room) {
+                drawQuad(barX + budget * pixelsPerByte, barY - 2.0f, 2.0f, 14.0f, glm::vec3(1.0f, 1.0f, 1.0f), 0.9f);
+            }
+            barX += width;
+        }
+        size_t total = bar == 0 ? MemoryStats::getCpuBytes() : MemoryStats::getGpuBytes();
+        std::snprintf(text, sizeof(text), "%.1f MB", total / (1024.0 * 1024.0));
+        renderText(memoryLabels[bar], x + 2.0f, barY + 2.0f);
+        renderText(text, x + 2.0f + memoryLabels[bar].width + BitmapFont::ADVANCE, barY + 2.0f, glm::vec3(1.0f, 1.0f, 1.0f));
+    }
 }
 
 void UI::initializeInventoryBlocks() {
@@ -488,19 +421,9 @@ void UI::initializeInventoryBlocks() {
 }
 
 void UI::drawQuad(float x, float y, float width, float height, const glm::vec3& color, float alpha) {
-    glUseProgram(uiShaderProgram);
-    
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, glm::vec3(x, y, 0.0f));
-    model = glm::scale(model, glm::vec3(width, height, 1.0f));
-    glUniformMatrix4fv(glGetUniformLocation(uiShaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(model));
-    
-    glUniform3f(glGetUniformLocation(uiShaderProgram, "color"), color.r, color.g, color.b);
-    glUniform1f(glGetUniformLocation(uiShaderProgram, "alpha"), alpha);
-    
-    glBindVertexArray(hudVAO);
-    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-    glBindVertexArray(0);
+    // Plain colour from the font's solid cell, so quads and text stay in one draw
+    quads.addQuad(x, y, width, height, glm::vec4(color, alpha),
+                  solidTexCoord.x, solidTexCoord.y, solidTexCoord.x, solidTexCoord.y);
 }
 
 void UI::drawBorder(float x, float y, float width, float height, const glm::vec3& color, float thickness) {
@@ -511,7 +434,7 @@ void UI::drawBorder(float x, float y, float width, float height, const glm::vec3
     drawQuad(x + width - thickness, y, thickness, height, color, 1.0f); // Right
 }
 
-std::string UI::getBlockName(BlockType blockType) {
+const char* UI::getBlockName(BlockType blockType) {
     // Simple block name mapping
     switch (blockType) {
         case BlockType::GRASS: return "Grass";
@@ -569,9 +492,12 @@ glm::vec3 UI::getBlockColor(BlockType blockType) {
     }
 }
 
-void UI::renderText(const std::string& text, float x, float y, float scale) {
-    // TODO: Implement proper text rendering with a bitmap font
-    // For now, this is a placeholder
+void UI::renderText(const char* text, float x, float y, const glm::vec3& color, float scale) {
+    font.addText(quads, text, x, y, glm::vec4(color, 1.0f), scale);
+}
+
+void UI::renderText(const TextLayout& layout, float x, float y) {
+    quads.addQuads(layout.vertices.data(), layout.quadCount, x, y);
 }
 
 void UI::addBlockToInventory(BlockType blockType) {
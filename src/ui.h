@@ -1,20 +1,32 @@
 #pragma once
 
-#include <glad/gl.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include "bitmap_font.h"
+#include "quad_batch.h"
+#include "render_device.h"
 #include "voxel_chunk.h"
 
+// Numbers shown by the F3 debug overlay, gathered by the game loop each frame
+struct DebugOverlayStats {
+    int loadedChunks = 0;
+    int renderedChunks = 0;
+    int pendingChunks = 0;
+    int culledChunks = 0;       // In render distance but hidden (cave or occlusion culling)
+    int maxChunks = 1;          // Scale of the chunk gauges
+    size_t memoryBytes = 0;     // Process resident memory
+};
+
 class UI {
 public:
     UI();
     ~UI();
     
-    // Initialize UI system (call after OpenGL is ready)
-    bool initialize();
+    // Initialize UI system (call after the graphics context is ready)
+    bool initialize(RenderDevice& device);
     
     // Render all UI elements
     void render(int windowWidth, int windowHeight);
@@ -30,6 +42,11 @@ public:
     void handleNumberKey(int key);
     void toggleInventory(); // F key to open/close inventory
     bool isInventoryOpen() const { return inventoryOpen; }
+    
+    // F3 debug overlay: frame-time graph, profiler scope breakdown and world gauges
+    void toggleDebugOverlay() { debugOverlayVisible = !debugOverlayVisible; }
+    bool isDebugOverlayVisible() const { return debugOverlayVisible; }
+    void setDebugStats(const DebugOverlayStats& stats) { debugStats = stats; }
 
     // Inventory manipulation (for mining/placing blocks)
     void addBlockToInventory(BlockType blockType);
@@ -39,7 +56,7 @@ public:
     // Game state display
     void setTargetedBlock(BlockType blockType, const glm::vec3& position);
     void clearTargetedBlock();
-    std::string getBlockName(BlockType blockType);
+    const char* getBlockName(BlockType blockType);
     
     // UI elements
     void renderCrosshair(int windowWidth, int windowHeight);
@@ -47,6 +64,7 @@ public:
     void renderHUD(int windowWidth, int windowHeight); // Health, coordinates, etc.
     void renderInventory(int windowWidth, int windowHeight);
     void renderBlockInfo(int windowWidth, int windowHeight); // Show targeted block info
+    void renderDebugOverlay(int windowWidth, int windowHeight);
     
     // Constants for UI sizing
     static const float CROSSHAIR_SIZE;
@@ -59,38 +77,39 @@ private:
     static const int HOTBAR_SIZE = 9;
     static const int INVENTORY_ROWS = 4;
     static const int INVENTORY_COLS = 9;
+    static const int BLOCK_TYPE_COUNT = static_cast<int>(BlockType::REDSTONE_ORE) + 1;
+    static const int GAUGE_COUNT = 5;
     BlockType hotbarBlocks[HOTBAR_SIZE];
     BlockType inventoryBlocks[INVENTORY_ROWS * INVENTORY_COLS];
     bool inventoryOpen;
+    bool debugOverlayVisible;
+    DebugOverlayStats debugStats;
     
     // Targeted block info
     bool hasTargetedBlock;
     BlockType targetedBlockType;
     glm::vec3 targetedBlockPosition;
     
-    // OpenGL objects for UI rendering
-    GLuint uiShaderProgram;
-    GLuint crosshairVAO, crosshairVBO;
-    GLuint hotbarVAO, hotbarVBO, hotbarEBO;
-    GLuint hudVAO, hudVBO;
-    GLuint inventoryVAO, inventoryVBO, inventoryEBO;
-    
-    // Shader creation helper
-    GLuint createUIShader();
+    // GPU objects for UI rendering
+    RenderDevice* device;          // Set by initialize()
+    QuadBatch quads;               // Every element of the frame, drawn at the end of render()
+    BitmapFont font;               // Its atlas is the only texture, so quads and text share one draw
+    glm::vec2 solidTexCoord;
     
-    // Initialize specific UI elements
-    void initializeCrosshair();
-    void initializeHotbar();
-    void initializeHUD();
-    void initializeInventory();
+    // Labels laid out once at initialize()
+    TextLayout blockNameLabels[BLOCK_TYPE_COUNT];
+    TextLayout inventoryLabel;
+    TextLayout gaugeLabels[GAUGE_COUNT];
+    TextLayout memoryLabels[2];
     
-    // Helper functions
+    // Helper functions; quads are drawn in the order they are added
     void drawQuad(float x, float y, float width, float height, const glm::vec3& color, float alpha = 1.0f);
     void drawBorder(float x, float y, float width, float height, const glm::vec3& color, float thickness = 0.002f);
     glm::vec3 getBlockColor(BlockType blockType);
     
-    // Text rendering (simple bitmap font)
-    void renderText(const std::string& text, float x, float y, float scale = 1.0f);
+    // Text rendering with the bitmap font; (x, y) is the bottom left of the first line
+    void renderText(const char* text, float x, float y, const glm::vec3& color, float scale = 1.0f);
+    void renderText(const TextLayout& layout, float x, float y);
     
     // Block inventory management
     void initializeInventoryBlocks();
@@ -1,13 +1,8 @@
 #include "voxel_chunk.h"
-#include <glad/gl.h>
+#include "profiler.h"
 #include <vector>
-#include <iostream>
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
 #include <cmath>
-
-// Static member definition
-TextureAtlas* VoxelChunk::textureAtlas = nullptr;
+#include <algorithm>
 
 // Simple noise function for terrain generation
 float simpleNoise(float x, float z) {
@@ -16,8 +11,18 @@ float simpleNoise(float x, float z) {
            sin(x * 0.02f) * cos(z * 0.02f) * 0.2f;
 }
 
-VoxelChunk::VoxelChunk(int worldX, int worldZ) : worldX(worldX), worldZ(worldZ)
+VoxelChunk::VoxelChunk(int worldX, int worldZ) : worldX(worldX), worldZ(worldZ), meshRevision(0), occluderCount(0), topHeight(0)
+{
+    // Note: Terrain generation is now handled by ChunkManager
+    // Mesh generation will be called after terrain is set
+    reset(worldX, worldZ);
+}
+
+void VoxelChunk::reset(int newWorldX, int newWorldZ)
 {
+    worldX = newWorldX;
+    worldZ = newWorldZ;
+    
     // Initialize all blocks to air
     for (int x = 0; x < CHUNK_SIZE; x++) {
         for (int y = 0; y < CHUNK_SIZE; y++) {
@@ -26,25 +31,36 @@ VoxelChunk::VoxelChunk(int worldX, int worldZ) : worldX(worldX), worldZ(worldZ)
             }
         }
     }
-
-    // Note: Terrain generation is now handled by ChunkManager
-    // Mesh generation will be called after terrain is set
+    
+    // Empty columns have no surface
+    for (int x = 0; x < CHUNK_SIZE; x++) {
+        for (int z = 0; z < CHUNK_SIZE; z++) {
+            heightMap[x][z] = -1;
+            topBlocks[x][z] = BlockType::AIR;
+        }
+    }
+    
+    // All air: every face sees every other
+    for (int section = 0; section < SECTION_COUNT; section++) {
+        sectionVisibility[section] = ~0ull >> (64 - FACE_COUNT * FACE_COUNT);
+    }
+    occluderCount = 0;
+    topHeight = 0;
 }
 
-void VoxelChunk::render(unsigned int shaderID)
+void VoxelChunk::generateMesh(ChunkMesh& out, int lod, ChunkMesh* water, const ChunkNeighbors* neighbors) const
 {
-    if (VAO == 0 || indices.empty()) {
-        std::cerr << "Warning: Chunk (" << worldX << "," << worldZ << ") has no mesh to render" << std::endl;
-        return;
+    PROFILE_SCOPE("VoxelChunk::generateMesh");
+    lod = std::clamp(lod, 0, LOD_LEVELS - 1);
+    out.clear();
+    if (water) water->clear();
+    if (lod == 0) {
+        generateFullMesh(out, water, neighbors);
+    } else {
+        generateLodMesh(lod, out, water, neighbors);
     }
-
-    glm::vec3 chunkOffset = glm::vec3(worldX * CHUNK_SIZE, 0, worldZ * CHUNK_SIZE);
-    glm::mat4 model = glm::translate(glm::mat4(1.0f), chunkOffset);
-    glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, glm::value_ptr(model));
-    
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    buildIndices(out);
+    if (water) buildIndices(*water);
 }
 
 bool VoxelChunk::isAir(int x, int y, int z) const
@@ -78,12 +94,8 @@ BlockType VoxelChunk::getBlockType(int x, int y, int z) const
     return blocks[x][y][z];
 }
 
-void VoxelChunk::generateMesh()
+void VoxelChunk::generateFullMesh(ChunkMesh& out, ChunkMesh* water, const ChunkNeighbors* neighbors) const
 {
-    vertices.clear();
-    indices.clear();
-
-    unsigned int indexOffset = 0;
 
     for (int x = 0; x < CHUNK_SIZE; x++)
     {
@@ -93,77 +105,200 @@ void VoxelChunk::generateMesh()
             {
                 BlockType blockType = blocks[x][y][z];
                 if (blockType == BlockType::AIR)
-                    continue;                // Front face (positive Z) - face direction 0
-                if (isTransparent(x, y, z + 1))
+                    continue;
+
+                // Solid blocks show a face wherever they can be seen through air
+                // or water; water only shows its faces toward air
+                bool isWater = blockType == BlockType::WATER;
+                if (isWater && !water)
+                    continue;
+                ChunkMesh& target = isWater ? *water : out;
+                auto faceState = [&](int nx, int ny, int nz) {
+                    if (isWater)
+                        return isOpenToWater(nx, ny, nz, neighbors) ? FaceState::VISIBLE : FaceState::HIDDEN;
+                    return getFaceState(nx, ny, nz, neighbors);
+                };
+                FaceState state;
+
+                // Front face (positive Z) - face direction 0
+                if ((state = faceState(x, y, z + 1)) != FaceState::HIDDEN)
                 {
-                    addFace(x, y, z + 1, x + 1, y, z + 1, x + 1, y + 1, z + 1, x, y + 1, z + 1, indexOffset, blockType, 0);
+                    addFace(x, y, z + 1, x + 1, y, z + 1, x + 1, y + 1, z + 1, x, y + 1, z + 1, blockType, 0, target,
+                            state == FaceState::SKIRT);
                 }
 
                 // Back face (negative Z) - face direction 1
-                if (isTransparent(x, y, z - 1))
+                if ((state = faceState(x, y, z - 1)) != FaceState::HIDDEN)
                 {
-                    addFace(x + 1, y, z, x, y, z, x, y + 1, z, x + 1, y + 1, z, indexOffset, blockType, 1);
+                    addFace(x + 1, y, z, x, y, z, x, y + 1, z, x + 1, y + 1, z, blockType, 1, target,
+                            state == FaceState::SKIRT);
                 }
 
                 // Right face (positive X) - face direction 2
-                if (isTransparent(x + 1, y, z))
+                if ((state = faceState(x + 1, y, z)) != FaceState::HIDDEN)
                 {
-                    addFace(x + 1, y, z, x + 1, y, z + 1, x + 1, y + 1, z + 1, x + 1, y + 1, z, indexOffset, blockType, 2);
+                    addFace(x + 1, y, z, x + 1, y, z + 1, x + 1, y + 1, z + 1, x + 1, y + 1, z, blockType, 2, target,
+                            state == FaceState::SKIRT);
                 }
 
                 // Left face (negative X) - face direction 3
-                if (isTransparent(x - 1, y, z))
+                if ((state = faceState(x - 1, y, z)) != FaceState::HIDDEN)
                 {
-                    addFace(x, y, z + 1, x, y, z, x, y + 1, z, x, y + 1, z + 1, indexOffset, blockType, 3);
+                    addFace(x, y, z + 1, x, y, z, x, y + 1, z, x, y + 1, z + 1, blockType, 3, target,
+                            state == FaceState::SKIRT);
                 }
 
                 // Top face (positive Y) - face direction 4
-                if (isTransparent(x, y + 1, z))
+                if (faceState(x, y + 1, z) != FaceState::HIDDEN)
                 {
-                    addFace(x, y + 1, z, x + 1, y + 1, z, x + 1, y + 1, z + 1, x, y + 1, z + 1, indexOffset, blockType, 4);
+                    addFace(x, y + 1, z, x + 1, y + 1, z, x + 1, y + 1, z + 1, x, y + 1, z + 1, blockType, 4, target);
                 }
 
                 // Bottom face (negative Y) - face direction 5
-                if (isTransparent(x, y - 1, z))
+                if (faceState(x, y - 1, z) != FaceState::HIDDEN)
                 {
-                    addFace(x, y, z + 1, x + 1, y, z + 1, x + 1, y, z, x, y, z, indexOffset, blockType, 5);
+                    addFace(x, y, z + 1, x + 1, y, z + 1, x + 1, y, z, x, y, z, blockType, 5, target);
                 }
             }
         }
     }
+}
 
-    // Setup GPU buffers after mesh generation
-    if (!VAO) {
-        glGenVertexArrays(1, &VAO);
-        glGenBuffers(1, &VBO);
-        glGenBuffers(1, &EBO);
+BlockType VoxelChunk::downsampleCell(int scale, int cx, int cy, int cz) const
+{
+    int solidCount = 0;
+    int topY = -1;
+    BlockType topType = BlockType::AIR;
+    for (int x = cx * scale; x < (cx + 1) * scale; x++) {
+        for (int y = cy * scale; y < (cy + 1) * scale; y++) {
+            for (int z = cz * scale; z < (cz + 1) * scale; z++) {
+                BlockType blockType = blocks[x][y][z];
+                if (blockType == BlockType::AIR)
+                    continue;
+                solidCount++;
+                if (y > topY) {
+                    topY = y;
+                    topType = blockType;
+                }
+            }
+        }
     }
+    return solidCount * 2 >= scale * scale * scale ? topType : BlockType::AIR;
+}
 
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+void VoxelChunk::generateLodMesh(int lod, ChunkMesh& out, ChunkMesh* water, const ChunkNeighbors* neighbors) const
+{
+    // Downsample the chunk into cells of scale^3 blocks. A cell is solid when at least
+    // half of its blocks are, and takes the type of its highest solid block so surface
+    // materials (grass, snow, sand) survive the reduction.
+    const int scale = 1 << lod;
+    const int cells = CHUNK_SIZE / scale;
+    // LOD levels start at 2x, so the cells always fit a half-resolution grid on the stack
+    const int maxCells = CHUNK_SIZE / 2;
+    BlockType cellBlocks[maxCells * maxCells * maxCells];
+    auto cellAt = [&](int cx, int cy, int cz) -> BlockType& {
+        return cellBlocks[(cx * cells + cy) * cells + cz];
+    };
+    for (int cx = 0; cx < cells; cx++) {
+        for (int cy = 0; cy < cells; cy++) {
+            for (int cz = 0; cz < cells; cz++) {
+                cellAt(cx, cy, cz) = downsampleCell(scale, cx, cy, cz);
+            }
+        }
+    }
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    // The neighbours' cells along each side, downsampled the same way, decide
+    // which side faces are skirts and where water meets air. Sides with no
+    // neighbour show every face.
+    BlockType sideCells[ChunkMesh::SIDES][maxCells * maxCells];
+    for (int side = 0; side < ChunkMesh::SIDES; side++) {
+        const VoxelChunk* neighbor = neighbors ? neighbors->chunks[side] : nullptr;
+        if (!neighbor)
+            continue;
+        for (int cy = 0; cy < cells; cy++) {
+            for (int along = 0; along < cells; along++) {
+                BlockType& cell = sideCells[side][cy * cells + along];
+                switch (side) {
+                    case 0: cell = neighbor->downsampleCell(scale, along, cy, 0); break;
+                    case 1: cell = neighbor->downsampleCell(scale, along, cy, cells - 1); break;
+                    case 2: cell = neighbor->downsampleCell(scale, 0, cy, along); break;
+                    default: cell = neighbor->downsampleCell(scale, cells - 1, cy, along); break;
+                }
+            }
+        }
+    }
 
-        // Position attribute (location 0) - 3 floats
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+    auto cellState = [&](int cx, int cy, int cz) {
+        if (cy < 0 || cy >= cells)
+            return FaceState::VISIBLE;
+        int side = getSide(cx * scale, cy * scale, cz * scale);
+        BlockType blockType;
+        if (side < 0) {
+            blockType = cellAt(cx, cy, cz);
+        } else if (neighbors && neighbors->chunks[side]) {
+            blockType = sideCells[side][cy * cells + (side < 2 ? cx : cz)];
+        } else {
+            return FaceState::VISIBLE;
+        }
+        if (blockType == BlockType::AIR || blockType == BlockType::WATER)
+            return FaceState::VISIBLE;
+        return side < 0 ? FaceState::HIDDEN : FaceState::SKIRT;
+    };
+    auto cellAir = [&](int cx, int cy, int cz) {
+        if (cy < 0 || cy >= cells)
+            return true;
+        int side = getSide(cx * scale, cy * scale, cz * scale);
+        if (side < 0)
+            return cellAt(cx, cy, cz) == BlockType::AIR;
+        if (neighbors && neighbors->chunks[side])
+            return sideCells[side][cy * cells + (side < 2 ? cx : cz)] == BlockType::AIR;
+        return true;
+    };
 
-    // Normal attribute (location 1) - 3 floats
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
 
-    // Texture coordinate attribute (location 2) - 2 floats
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+    for (int cx = 0; cx < cells; cx++) {
+        for (int cy = 0; cy < cells; cy++) {
+            for (int cz = 0; cz < cells; cz++) {
+                BlockType blockType = cellAt(cx, cy, cz);
+                if (blockType == BlockType::AIR)
+                    continue;
+
+                // Water cells go into the water mesh, with faces only toward air
+                bool isWater = blockType == BlockType::WATER;
+                if (isWater && !water)
+                    continue;
+                ChunkMesh& target = isWater ? *water : out;
+                auto faceState = [&](int nx, int ny, int nz) {
+                    if (isWater)
+                        return cellAir(nx, ny, nz) ? FaceState::VISIBLE : FaceState::HIDDEN;
+                    return cellState(nx, ny, nz);
+                };
+
+                float x0 = cx * scale, y0 = cy * scale, z0 = cz * scale;
+                float x1 = x0 + scale, y1 = y0 + scale, z1 = z0 + scale;
+                FaceState state;
+
+                if ((state = faceState(cx, cy, cz + 1)) != FaceState::HIDDEN)
+                    addFace(x0, y0, z1, x1, y0, z1, x1, y1, z1, x0, y1, z1, blockType, 0, target, state == FaceState::SKIRT);
+                if ((state = faceState(cx, cy, cz - 1)) != FaceState::HIDDEN)
+                    addFace(x1, y0, z0, x0, y0, z0, x0, y1, z0, x1, y1, z0, blockType, 1, target, state == FaceState::SKIRT);
+                if ((state = faceState(cx + 1, cy, cz)) != FaceState::HIDDEN)
+                    addFace(x1, y0, z0, x1, y0, z1, x1, y1, z1, x1, y1, z0, blockType, 2, target, state == FaceState::SKIRT);
+                if ((state = faceState(cx - 1, cy, cz)) != FaceState::HIDDEN)
+                    addFace(x0, y0, z1, x0, y0, z0, x0, y1, z0, x0, y1, z1, blockType, 3, target, state == FaceState::SKIRT);
+                if (faceState(cx, cy + 1, cz) != FaceState::HIDDEN)
+                    addFace(x0, y1, z0, x1, y1, z0, x1, y1, z1, x0, y1, z1, blockType, 4, target);
+                if (faceState(cx, cy - 1, cz) != FaceState::HIDDEN)
+                    addFace(x0, y0, z1, x1, y0, z1, x1, y0, z0, x0, y0, z0, blockType, 5, target);
+            }
+        }
+    }
 
-    glBindVertexArray(0);
 }
 
 void VoxelChunk::addFace(float x1, float y1, float z1, float x2, float y2, float z2,
                          float x3, float y3, float z3, float x4, float y4, float z4,
-                         unsigned int& indexOffset, BlockType blockType, int faceDirection)
+                         BlockType blockType, int faceDirection, ChunkMesh& out, bool skirt)
 {
     // Get texture coordinates for this block type and face
     TextureAtlas::TextureUV uv = getTextureForBlock(blockType, faceDirection);
@@ -190,106 +325,261 @@ void VoxelChunk::addFace(float x1, float y1, float z1, float x2, float y2, float
         x4, y4, z4, normal.x, normal.y, normal.z, uv.u1, uv.v2
     };
 
-    // Add face indices (two triangles)
-    unsigned int inds[] = {
-        0, 1, 2, 2, 3, 0
-    };
-
-    // Append vertices
+    // Append vertices; the indices are written by buildIndices once all
+    // faces are known, grouped by range
     for (float f : face)
     {
-        vertices.push_back(f);
+        out.vertices.push_back(f);
     }
+    int range = skirt ? ChunkMesh::skirtRange(faceDirection) : ChunkMesh::faceRange(faceDirection);
+    out.quadRanges.push_back(static_cast<uint8_t>(range));
+}
 
-    // Append indices with offset
-    for (unsigned int i : inds)
-    {
-        indices.push_back(i + indexOffset);
+void VoxelChunk::buildIndices(ChunkMesh& mesh)
+{
+    // Count the quads of each range, then place each quad's two triangles
+    // in its range
+    const int ranges = ChunkMesh::RANGE_COUNT;
+    size_t counts[ranges] = {};
+    for (uint8_t range : mesh.quadRanges) {
+        counts[range]++;
+    }
+    mesh.rangeStart[0] = 0;
+    for (int range = 0; range < ranges; range++) {
+        mesh.rangeStart[range + 1] = mesh.rangeStart[range] + counts[range] * 6;
     }
 
-    indexOffset += 4;
+    size_t next[ranges];
+    std::copy(mesh.rangeStart, mesh.rangeStart + ranges, next);
+    mesh.indices.resize(mesh.rangeStart[ranges]);
+    for (size_t quad = 0; quad < mesh.quadRanges.size(); quad++) {
+        unsigned int first = static_cast<unsigned int>(quad * 4);
+        const unsigned int pattern[] = { first, first + 1, first + 2, first + 2, first + 3, first };
+        size_t& slot = next[mesh.quadRanges[quad]];
+        std::copy(pattern, pattern + 6, mesh.indices.begin() + slot);
+        slot += 6;
+    }
 }
 
-TextureAtlas::TextureUV VoxelChunk::getTextureForBlock(BlockType blockType, int faceDirection) const
+TextureAtlas::TextureUV VoxelChunk::getTextureForBlock(BlockType blockType, int faceDirection)
 {
-    if (!textureAtlas) {
-        // Return default UV if no texture atlas is set
-        TextureAtlas::TextureUV defaultUV = {0.0f, 0.0f, 1.0f, 1.0f};
-        return defaultUV;
-    }
-    
+    // The atlas layout is fixed, so UVs need no atlas instance (or GL context)
     switch (blockType) {
         case BlockType::GRASS:
             if (faceDirection == 4) { // Top face
-                return textureAtlas->getUV(TextureAtlas::BlockType::GRASS_TOP);
+                return TextureAtlas::getUV(TextureAtlas::BlockType::GRASS_TOP);
             } else if (faceDirection == 5) { // Bottom face
-                return textureAtlas->getUV(TextureAtlas::BlockType::DIRT);
+                return TextureAtlas::getUV(TextureAtlas::BlockType::DIRT);
             } else { // Side faces
-                return textureAtlas->getUV(TextureAtlas::BlockType::GRASS_SIDE);
+                return TextureAtlas::getUV(TextureAtlas::BlockType::GRASS_SIDE);
             }
         case BlockType::DIRT:
-            return textureAtlas->getUV(TextureAtlas::BlockType::DIRT);
+            return TextureAtlas::getUV(TextureAtlas::BlockType::DIRT);
         case BlockType::STONE:
-            return textureAtlas->getUV(TextureAtlas::BlockType::STONE);
+            return TextureAtlas::getUV(TextureAtlas::BlockType::STONE);
         case BlockType::COBBLESTONE:
-            return textureAtlas->getUV(TextureAtlas::BlockType::COBBLESTONE);
+            return TextureAtlas::getUV(TextureAtlas::BlockType::COBBLESTONE);
         case BlockType::WOOD_PLANK:
-            return textureAtlas->getUV(TextureAtlas::BlockType::WOOD_PLANK);
+            return TextureAtlas::getUV(TextureAtlas::BlockType::WOOD_PLANK);
         case BlockType::WOOD_LOG:
             if (faceDirection == 4 || faceDirection == 5) { // Top/bottom faces
-                return textureAtlas->getUV(TextureAtlas::BlockType::WOOD_LOG_TOP);
+                return TextureAtlas::getUV(TextureAtlas::BlockType::WOOD_LOG_TOP);
             } else { // Side faces
-                return textureAtlas->getUV(TextureAtlas::BlockType::WOOD_LOG_SIDE);
+                return TextureAtlas::getUV(TextureAtlas::BlockType::WOOD_LOG_SIDE);
             }        case BlockType::LEAVES:
-            return textureAtlas->getUV(TextureAtlas::BlockType::LEAVES);
+            return TextureAtlas::getUV(TextureAtlas::BlockType::LEAVES);
         case BlockType::SAND:
-            return textureAtlas->getUV(TextureAtlas::BlockType::SAND);
+            return TextureAtlas::getUV(TextureAtlas::BlockType::SAND);
         case BlockType::WATER:
-            return textureAtlas->getUV(TextureAtlas::BlockType::WATER);
+            return TextureAtlas::getUV(TextureAtlas::BlockType::WATER);
         case BlockType::BEDROCK:
-            return textureAtlas->getUV(TextureAtlas::BlockType::BEDROCK);
+            return TextureAtlas::getUV(TextureAtlas::BlockType::BEDROCK);
         case BlockType::SNOW:
-            return textureAtlas->getUV(TextureAtlas::BlockType::SNOW);
+            return TextureAtlas::getUV(TextureAtlas::BlockType::SNOW);
         case BlockType::ICE:
-            return textureAtlas->getUV(TextureAtlas::BlockType::ICE);
+            return TextureAtlas::getUV(TextureAtlas::BlockType::ICE);
         case BlockType::GLOWSTONE:
-            return textureAtlas->getUV(TextureAtlas::BlockType::GLOWSTONE);
+            return TextureAtlas::getUV(TextureAtlas::BlockType::GLOWSTONE);
         case BlockType::OBSIDIAN:
-            return textureAtlas->getUV(TextureAtlas::BlockType::OBSIDIAN);
+            return TextureAtlas::getUV(TextureAtlas::BlockType::OBSIDIAN);
         case BlockType::BRICK:
-            return textureAtlas->getUV(TextureAtlas::BlockType::BRICK);
+            return TextureAtlas::getUV(TextureAtlas::BlockType::BRICK);
         case BlockType::MOSSY_STONE:
-            return textureAtlas->getUV(TextureAtlas::BlockType::MOSSY_STONE);
+            return TextureAtlas::getUV(TextureAtlas::BlockType::MOSSY_STONE);
         case BlockType::GRAVEL:
-            return textureAtlas->getUV(TextureAtlas::BlockType::GRAVEL);
+            return TextureAtlas::getUV(TextureAtlas::BlockType::GRAVEL);
         case BlockType::GOLD_ORE:
-            return textureAtlas->getUV(TextureAtlas::BlockType::GOLD_ORE);
+            return TextureAtlas::getUV(TextureAtlas::BlockType::GOLD_ORE);
         case BlockType::IRON_ORE:
-            return textureAtlas->getUV(TextureAtlas::BlockType::IRON_ORE);
+            return TextureAtlas::getUV(TextureAtlas::BlockType::IRON_ORE);
         case BlockType::DIAMOND_ORE:
-            return textureAtlas->getUV(TextureAtlas::BlockType::DIAMOND_ORE);
+            return TextureAtlas::getUV(TextureAtlas::BlockType::DIAMOND_ORE);
         case BlockType::EMERALD_ORE:
-            return textureAtlas->getUV(TextureAtlas::BlockType::EMERALD_ORE);
+            return TextureAtlas::getUV(TextureAtlas::BlockType::EMERALD_ORE);
         case BlockType::REDSTONE_ORE:
-            return textureAtlas->getUV(TextureAtlas::BlockType::REDSTONE_ORE);
+            return TextureAtlas::getUV(TextureAtlas::BlockType::REDSTONE_ORE);
         default:
-            return textureAtlas->getUV(TextureAtlas::BlockType::STONE);
+            return TextureAtlas::getUV(TextureAtlas::BlockType::STONE);
     }
 }
 
 void VoxelChunk::setBlock(int x, int y, int z, BlockType blockType) {
     if (x >= 0 && x < CHUNK_SIZE && y >= 0 && y < CHUNK_SIZE && z >= 0 && z < CHUNK_SIZE) {
         blocks[x][y][z] = blockType;
+        
+        // Keep the column summary current
+        if (blockType != BlockType::AIR) {
+            if (y >= heightMap[x][z]) {
+                heightMap[x][z] = static_cast<int8_t>(y);
+                topBlocks[x][z] = blockType;
+            }
+        } else if (y == heightMap[x][z]) {
+            rescanColumn(x, z, y - 1);
+        }
+    }
+}
+
+void VoxelChunk::rescanColumn(int x, int z, int fromY) {
+    for (int y = fromY; y >= 0; y--) {
+        if (blocks[x][y][z] != BlockType::AIR) {
+            heightMap[x][z] = static_cast<int8_t>(y);
+            topBlocks[x][z] = blocks[x][y][z];
+            return;
+        }
     }
+    heightMap[x][z] = -1;
+    topBlocks[x][z] = BlockType::AIR;
 }
 
 void VoxelChunk::regenerateMesh() {
-    // Clear existing mesh data
-    vertices.clear();
-    indices.clear();
+    // Every level is rebuilt on demand the next time it is rendered
+    meshRevision++;
+    updateVisibility();
+    updateOccluders();
+}
+
+void VoxelChunk::updateOccluders()
+{
+    const int half = CHUNK_SIZE / 2;
+    topHeight = 0;
+    for (int x = 0; x < CHUNK_SIZE; x++) {
+        for (int z = 0; z < CHUNK_SIZE; z++) {
+            topHeight = std::max(topHeight, heightMap[x][z] + 1);
+        }
+    }
+    
+    OccluderBox quadrants[4];
+    int quadrantCount = 0;
+    for (int quadrant = 0; quadrant < 4; quadrant++) {
+        int minX = (quadrant & 1) * half;
+        int minZ = (quadrant >> 1) * half;
+        
+        // Longest run of layers that are solid across the whole quadrant
+        int bestStart = 0, bestLength = 0, runStart = 0;
+        for (int y = 0; y <= CHUNK_SIZE; y++) {
+            bool solid = y < CHUNK_SIZE;
+            for (int x = minX; solid && x < minX + half; x++) {
+                for (int z = minZ; z < minZ + half; z++) {
+                    if (blocks[x][y][z] == BlockType::AIR || blocks[x][y][z] == BlockType::WATER) {
+                        solid = false;
+                        break;
+                    }
+                }
+            }
+            if (!solid) {
+                if (y - runStart > bestLength) {
+                    bestStart = runStart;
+                    bestLength = y - runStart;
+                }
+                runStart = y + 1;
+            }
+        }
+        
+        OccluderBox& box = quadrants[quadrant];
+        box = { static_cast<uint8_t>(minX), static_cast<uint8_t>(bestStart), static_cast<uint8_t>(minZ),
+                static_cast<uint8_t>(minX + half), static_cast<uint8_t>(bestStart + bestLength),
+                static_cast<uint8_t>(minZ + half) };
+        if (bestLength > 0) quadrantCount++;
+    }
     
-    // Regenerate the mesh
-    generateMesh();
+    occluderCount = 0;
+    bool uniform = quadrantCount == 4;
+    for (int quadrant = 1; uniform && quadrant < 4; quadrant++) {
+        uniform = quadrants[quadrant].minY == quadrants[0].minY && quadrants[quadrant].maxY == quadrants[0].maxY;
+    }
+    if (uniform) {
+        occluders[occluderCount++] = { 0, quadrants[0].minY, 0, CHUNK_SIZE, quadrants[0].maxY, CHUNK_SIZE };
+        return;
+    }
+    for (const OccluderBox& box : quadrants) {
+        if (box.maxY > box.minY) occluders[occluderCount++] = box;
+    }
+}
+
+void VoxelChunk::updateVisibility()
+{
+    PROFILE_SCOPE("VoxelChunk::updateVisibility");
+    const int cellCount = CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE;
+    const BlockType* cells = &blocks[0][0][0];   // Index (x * CHUNK_SIZE + y) * CHUNK_SIZE + z
+    bool visited[cellCount] = {};
+    uint16_t stack[cellCount];
+    
+    for (int section = 0; section < SECTION_COUNT; section++) {
+        int bottom = section * SECTION_HEIGHT;
+        int top = bottom + SECTION_HEIGHT - 1;
+        uint64_t visibility = 0;
+        
+        for (int x = 0; x < CHUNK_SIZE; x++) {
+            for (int y = bottom; y <= top; y++) {
+                for (int z = 0; z < CHUNK_SIZE; z++) {
+                    int start = (x * CHUNK_SIZE + y) * CHUNK_SIZE + z;
+                    if (visited[start] || (cells[start] != BlockType::AIR && cells[start] != BlockType::WATER))
+                        continue;
+                    
+                    // Faces touched by this connected region of transparent blocks
+                    unsigned int faces = 0;
+                    int stackSize = 0;
+                    stack[stackSize++] = static_cast<uint16_t>(start);
+                    visited[start] = true;
+                    while (stackSize > 0) {
+                        int cell = stack[--stackSize];
+                        int cx = cell / (CHUNK_SIZE * CHUNK_SIZE);
+                        int cy = (cell / CHUNK_SIZE) % CHUNK_SIZE;
+                        int cz = cell % CHUNK_SIZE;
+                        if (cz == CHUNK_SIZE - 1) faces |= 1u << 0;
+                        if (cz == 0) faces |= 1u << 1;
+                        if (cx == CHUNK_SIZE - 1) faces |= 1u << 2;
+                        if (cx == 0) faces |= 1u << 3;
+                        if (cy == top) faces |= 1u << 4;
+                        if (cy == bottom) faces |= 1u << 5;
+                        
+                        const int neighbors[6] = {
+                            cz < CHUNK_SIZE - 1 ? cell + 1 : -1,
+                            cz > 0 ? cell - 1 : -1,
+                            cx < CHUNK_SIZE - 1 ? cell + CHUNK_SIZE * CHUNK_SIZE : -1,
+                            cx > 0 ? cell - CHUNK_SIZE * CHUNK_SIZE : -1,
+                            cy < top ? cell + CHUNK_SIZE : -1,
+                            cy > bottom ? cell - CHUNK_SIZE : -1
+                        };
+                        for (int neighbor : neighbors) {
+                            if (neighbor < 0 || visited[neighbor]) continue;
+                            if (cells[neighbor] != BlockType::AIR && cells[neighbor] != BlockType::WATER) continue;
+                            visited[neighbor] = true;
+                            stack[stackSize++] = static_cast<uint16_t>(neighbor);
+                        }
+                    }
+                    
+                    for (int from = 0; from < FACE_COUNT; from++) {
+                        if (!(faces & (1u << from))) continue;
+                        for (int to = 0; to < FACE_COUNT; to++) {
+                            if (faces & (1u << to)) visibility |= 1ull << (from * FACE_COUNT + to);
+                        }
+                    }
+                }
+            }
+        }
+        sectionVisibility[section] = visibility;
+    }
 }
 
 bool VoxelChunk::isTransparent(int x, int y, int z) const
@@ -302,3 +592,49 @@ bool VoxelChunk::isTransparent(int x, int y, int z) const
     BlockType blockType = blocks[x][y][z];
     return blockType == BlockType::AIR || blockType == BlockType::WATER;
 }
+
+int VoxelChunk::getSide(int x, int y, int z)
+{
+    if (y < 0 || y >= CHUNK_SIZE)
+        return -1;
+    if (z >= CHUNK_SIZE) return 0;
+    if (z < 0) return 1;
+    if (x >= CHUNK_SIZE) return 2;
+    if (x < 0) return 3;
+    return -1;
+}
+
+VoxelChunk::FaceState VoxelChunk::getFaceState(int x, int y, int z, const ChunkNeighbors* neighbors) const
+{
+    int side = getSide(x, y, z);
+    if (side < 0)
+        return isTransparent(x, y, z) ? FaceState::VISIBLE : FaceState::HIDDEN;
+
+    // Past a side the neighbour decides, but the face stays in the mesh as a
+    // skirt for when the neighbour is drawn coarser or finer than this chunk
+    const VoxelChunk* neighbor = neighbors ? neighbors->chunks[side] : nullptr;
+    if (!neighbor)
+        return FaceState::VISIBLE;
+    BlockType blockType = neighbor->blocks[(x + CHUNK_SIZE) % CHUNK_SIZE][y][(z + CHUNK_SIZE) % CHUNK_SIZE];
+    return blockType == BlockType::AIR || blockType == BlockType::WATER ? FaceState::VISIBLE : FaceState::SKIRT;
+}
+
+bool VoxelChunk::isOpenToWater(int x, int y, int z, const ChunkNeighbors* neighbors) const
+{
+    // Above the chunk is sky; water is assumed to carry on below it. Past a
+    // side the neighbour decides, so lakes crossing chunk borders get no walls
+    // inside them but water next to air over the border still shows its side.
+    if (y >= CHUNK_SIZE)
+        return true;
+    if (y < 0)
+        return false;
+    int side = getSide(x, y, z);
+    if (side >= 0) {
+        const VoxelChunk* neighbor = neighbors ? neighbors->chunks[side] : nullptr;
+        if (!neighbor)
+            return true;
+        return neighbor->blocks[(x + CHUNK_SIZE) % CHUNK_SIZE][y][(z + CHUNK_SIZE) % CHUNK_SIZE] == BlockType::AIR;
+    }
+
+    return blocks[x][y][z] == BlockType::AIR;
+}
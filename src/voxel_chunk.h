@@ -1,7 +1,8 @@
 #pragma once
-#include <glad/gl.h>
 #include <glm/glm.hpp>
+#include <algorithm>
 #include <vector>
+#include <cstdint>
 #include "texture_atlas.h"
 
 // Block type enumeration
@@ -31,15 +32,65 @@ enum class BlockType : int {
     REDSTONE_ORE = 22
 };
 
+class VoxelChunk;
+
+// CPU-side chunk geometry: interleaved position, normal, uv (8 floats per
+// vertex), four vertices per quad. The indices are grouped into ranges by face
+// direction (as in VoxelChunk::generateMesh), so a renderer can skip whole
+// directions that face away from the camera. Faces on a chunk side that a
+// loaded neighbour's blocks cover are skirts, in a range of their own per
+// side: they only show where the neighbour is drawn at another level of
+// detail, or not at all.
+struct ChunkMesh {
+    static const int FACE_DIRECTIONS = 6;
+    static const int SIDES = 4;   // The horizontal directions, which border other chunks
+    static const int RANGE_COUNT = FACE_DIRECTIONS + SIDES;
+
+    // Range of a face direction's quads and of a side's skirt quads; each
+    // skirt follows its direction so the two can be drawn as one range
+    static int faceRange(int face) { return face < SIDES ? face * 2 : face + SIDES; }
+    static int skirtRange(int side) { return side * 2 + 1; }
+    static bool isSkirtRange(int range) { return range < SIDES * 2 && (range & 1); }
+
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<uint8_t> quadRanges;              // Range of each quad
+    size_t rangeStart[RANGE_COUNT + 1] = {};      // First index of each range, then the total
+
+    void clear() {
+        vertices.clear();
+        indices.clear();
+        quadRanges.clear();
+        std::fill(rangeStart, rangeStart + RANGE_COUNT + 1, 0);
+    }
+};
+
+// The loaded chunks beside a chunk, by side (face directions +Z, -Z, +X, -X);
+// null where none is loaded
+struct ChunkNeighbors {
+    const VoxelChunk* chunks[ChunkMesh::SIDES] = {};
+};
+
+/**
+ * VoxelChunk stores the blocks of one chunk and builds its meshes on the CPU.
+ * It has no GL dependency; uploading and drawing the meshes is up to the
+ * renderer, which watches getMeshRevision() to know when to rebuild them.
+ */
 class VoxelChunk
 {
 public:
     static const int CHUNK_SIZE = 16;
-    static TextureAtlas* textureAtlas; // Static reference to shared texture atlas
+    static const int LOD_LEVELS = 3;   // Full resolution, 2x and 4x downsampled
+    static const int FACE_COUNT = ChunkMesh::FACE_DIRECTIONS;   // As in generateMesh: +Z, -Z, +X, -X, +Y, -Y
+    static const int SECTION_HEIGHT = 4;   // Layers of a visibility section
+    static const int SECTION_COUNT = CHUNK_SIZE / SECTION_HEIGHT;
 
     // Constructor: optionally specify world position (defaults to 0,0)
     VoxelChunk(int worldX = 0, int worldZ = 0);
-    void render(unsigned int shaderID);
+    
+    // Make this an all-air chunk at another position, so chunk objects can be
+    // recycled instead of reallocated. The mesh revision keeps counting up.
+    void reset(int worldX, int worldZ);
 
     // Public methods for collision detection
     bool isBlockSolid(int x, int y, int z) const;
@@ -47,23 +98,93 @@ public:
     int getWorldZ() const { return worldZ; }
     BlockType getBlockType(int x, int y, int z) const;
     
+    // Column summaries, kept up to date by setBlock: highest non-air block of a
+    // column (-1 when empty) and its type. O(1) replacements for scanning y.
+    int getColumnHeight(int x, int z) const { return heightMap[x][z]; }
+    BlockType getColumnTopBlock(int x, int z) const { return topBlocks[x][z]; }
+    
     // Methods for chunk management
     void setBlock(int x, int y, int z, BlockType blockType);
     void regenerateMesh();
+    
+    // Bumped by regenerateMesh; meshes built at an older revision are stale
+    unsigned int getMeshRevision() const { return meshRevision; }
+    
+    // Face-to-face visibility through transparent blocks within a section (a
+    // horizontal slab of SECTION_HEIGHT layers), updated by regenerateMesh:
+    // whether open space connects the two faces, and whether a face has any opening
+    bool canSeeThrough(int section, int fromFace, int toFace) const {
+        return (sectionVisibility[section] >> (fromFace * FACE_COUNT + toFace)) & 1;
+    }
+    bool isFaceOpen(int section, int face) const { return canSeeThrough(section, face, face); }
+    
+    // Solid boxes for occlusion culling, updated by regenerateMesh: per 8x8
+    // quadrant the tallest run of layers with no transparent block (one box
+    // when all quadrants agree). Chunk-local block coordinates, max exclusive.
+    struct OccluderBox {
+        uint8_t minX, minY, minZ, maxX, maxY, maxZ;
+    };
+    static const int MAX_OCCLUDERS = 4;
+    int getOccluderCount() const { return occluderCount; }
+    const OccluderBox& getOccluder(int index) const { return occluders[index]; }
+    
+    // One above the highest non-air block, 0 for an empty chunk
+    int getTopHeight() const { return topHeight; }
+    
+    // Build the mesh for a level of detail into out (cleared first, capacity
+    // reused). Water is translucent and drawn in a pass of its own, so its
+    // faces go into water instead, or are left out when water is null. Faces
+    // on the sides are always kept; those a neighbour's blocks (downsampled to
+    // the same level) cover go into the skirt ranges.
+    void generateMesh(ChunkMesh& out, int lod = 0, ChunkMesh* water = nullptr,
+                      const ChunkNeighbors* neighbors = nullptr) const;
+    
+    // Atlas coordinates for a block face (face directions as in generateMesh)
+    static TextureAtlas::TextureUV getTextureForBlock(BlockType blockType, int faceDirection);
+    
+    // Write the indices of a mesh whose vertices and quadRanges are filled in,
+    // grouped by range, and set its rangeStart
+    static void buildIndices(ChunkMesh& mesh);
 
 private:
-    void generateMesh();
-    void addFace(float x1, float y1, float z1, float x2, float y2, float z2,
-                 float x3, float y3, float z3, float x4, float y4, float z4,
-                 unsigned int& indexOffset, BlockType blockType, int faceDirection);
+    // Whether a face is drawn: always, only as a skirt, or not at all
+    enum class FaceState { VISIBLE, SKIRT, HIDDEN };
+
+    void generateFullMesh(ChunkMesh& out, ChunkMesh* water, const ChunkNeighbors* neighbors) const;
+    void generateLodMesh(int lod, ChunkMesh& out, ChunkMesh* water, const ChunkNeighbors* neighbors) const;
+    static void addFace(float x1, float y1, float z1, float x2, float y2, float z2,
+                        float x3, float y3, float z3, float x4, float y4, float z4,
+                        BlockType blockType, int faceDirection, ChunkMesh& out, bool skirt = false);
     bool isAir(int x, int y, int z) const;
     bool isTransparent(int x, int y, int z) const;
-    TextureAtlas::TextureUV getTextureForBlock(BlockType blockType, int faceDirection) const;
+    bool isOpenToWater(int x, int y, int z, const ChunkNeighbors* neighbors) const;
+    
+    // State of an opaque face looking into block (x, y, z), which may be one
+    // step past a side into a neighbour
+    FaceState getFaceState(int x, int y, int z, const ChunkNeighbors* neighbors) const;
+    
+    // Side (as in ChunkNeighbors) a block one step outside the chunk lies
+    // past, or -1 inside the chunk or above or below it
+    static int getSide(int x, int y, int z);
+    
+    // The type a cell of scale^3 blocks is drawn as at a coarser level: its
+    // highest solid block's, if at least half its blocks are solid, else air
+    BlockType downsampleCell(int scale, int cx, int cy, int cz) const;
 
 private:
+    void rescanColumn(int x, int z, int fromY);
+    
+    // Flood fill the transparent blocks and record which faces each region touches
+    void updateVisibility();
+    void updateOccluders();
+
     BlockType blocks[CHUNK_SIZE][CHUNK_SIZE][CHUNK_SIZE];
+    int8_t heightMap[CHUNK_SIZE][CHUNK_SIZE];
+    BlockType topBlocks[CHUNK_SIZE][CHUNK_SIZE];
     int worldX, worldZ;
-    std::vector<float> vertices;
-    std::vector<unsigned int> indices;
-    GLuint VAO = 0, VBO = 0, EBO = 0;
+    unsigned int meshRevision;
+    uint64_t sectionVisibility[SECTION_COUNT];   // Bit fromFace * FACE_COUNT + toFace
+    OccluderBox occluders[MAX_OCCLUDERS];
+    int occluderCount;
+    int topHeight;
 };
@@ -1,28 +1,36 @@
 #include "water_shader.h"
-#include <iostream>
+#include "log.h"
 #include <cmath>
 
-WaterShader::WaterShader() : shaderProgram(0) {
+WaterShader::WaterShader() : device(nullptr), shaderProgram(0), modelLoc(-1), timeLoc(-1),
+                             waterLevelLoc(-1), lightDirLoc(-1) {
 }
 
 WaterShader::~WaterShader() {
-    if (shaderProgram) {
-        glDeleteProgram(shaderProgram);
+    if (device && shaderProgram) {
+        device->deleteProgram(shaderProgram);
     }
 }
 
-bool WaterShader::initialize() {
+bool WaterShader::initialize(RenderDevice& renderDevice) {
+    device = &renderDevice;
     const char* vertexShaderSource = R"(
         #version 330 core
         layout (location = 0) in vec3 aPos;
-        layout (location = 1) in vec2 aTexCoord;
+        layout (location = 1) in vec3 aNormal;
+        layout (location = 2) in vec2 aTexCoord;
         
         uniform mat4 model;
-        uniform mat4 view;
-        uniform mat4 projection;
         uniform float time;
         uniform float waterLevel;
         
+        layout(std140) uniform Camera {
+            mat4 view;
+            mat4 projection;
+            mat4 viewProjection;
+            vec4 cameraPosition;
+        };
+        
         out vec3 WorldPos;
         out vec2 TexCoord;
         out vec3 Normal;
@@ -36,7 +44,8 @@ bool WaterShader::initialize() {
             float wave2 = cos(worldPos.z * 0.3 + time * 1.5) * 0.08;
             float wave3 = sin((worldPos.x + worldPos.z) * 0.2 + time * 1.8) * 0.05;
             
-            WaveHeight = wave1 + wave2 + wave3;
+            // Only the surface moves; the sides of a pool stay put
+            WaveHeight = aNormal.y > 0.5 ? wave1 + wave2 + wave3 : 0.0;
             worldPos.y += WaveHeight;
             
             WorldPos = worldPos;
@@ -45,9 +54,9 @@ bool WaterShader::initialize() {
             // Calculate normal for lighting (simplified)
             vec3 tangent = vec3(1.0, cos(worldPos.x * 0.5 + time * 2.0) * 0.05, 0.0);
             vec3 bitangent = vec3(0.0, -sin(worldPos.z * 0.3 + time * 1.5) * 0.024, 1.0);
-            Normal = normalize(cross(tangent, bitangent));
+            Normal = aNormal.y > 0.5 ? normalize(cross(bitangent, tangent)) : aNormal;
             
-            gl_Position = projection * view * vec4(worldPos, 1.0);
+            gl_Position = viewProjection * vec4(worldPos, 1.0);
         }
     )";
     
@@ -64,9 +73,10 @@ bool WaterShader::initialize() {
         out vec4 FragColor;
         
         void main() {
-            // Animated water texture coordinates
-            vec2 uv1 = TexCoord + vec2(time * 0.02, time * 0.03);
-            vec2 uv2 = TexCoord + vec2(-time * 0.015, time * 0.025);
+            // Animated water coordinates; TexCoord is an atlas cell, too small
+            // to tile, so the pattern follows the world position
+            vec2 uv1 = WorldPos.xz * 0.25 + vec2(time * 0.02, time * 0.03);
+            vec2 uv2 = WorldPos.xz * 0.25 + vec2(-time * 0.015, time * 0.025);
             
             // Create water caustics pattern
             float caustic1 = sin(uv1.x * 20.0) * cos(uv1.y * 20.0);
@@ -98,92 +108,39 @@ bool WaterShader::initialize() {
         }
     )";
     
-    shaderProgram = createShader(vertexShaderSource, fragmentShaderSource);
+    shaderProgram = device->createProgram(vertexShaderSource, fragmentShaderSource);
     if (shaderProgram == 0) {
         return false;
     }
     
     getUniformLocations();
-    std::cout << "Water shader initialized successfully" << std::endl;
+    LOG_INFO("Water shader initialized successfully");
     return true;
 }
 
 void WaterShader::use() {
-    glUseProgram(shaderProgram);
+    device->useProgram(shaderProgram);
 }
 
-void WaterShader::setMatrices(const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection) {
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
+void WaterShader::setModel(const glm::mat4& model) {
+    device->setUniform(modelLoc, model);
 }
 
 void WaterShader::setTime(float time) {
-    glUniform1f(timeLoc, time);
+    device->setUniform(timeLoc, time);
 }
 
 void WaterShader::setWaterLevel(float level) {
-    glUniform1f(waterLevelLoc, level);
+    device->setUniform(waterLevelLoc, level);
 }
 
 void WaterShader::setLightDirection(const glm::vec3& direction) {
-    glUniform3fv(lightDirLoc, 1, glm::value_ptr(direction));
-}
-
-GLuint WaterShader::createShader(const char* vertexSource, const char* fragmentSource) {
-    // Vertex shader
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexSource, nullptr);
-    glCompileShader(vertexShader);
-    
-    // Check vertex shader compilation
-    int success;
-    char infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(vertexShader, 512, nullptr, infoLog);
-        std::cerr << "Water vertex shader compilation failed: " << infoLog << std::endl;
-        return 0;
-    }
-    
-    // Fragment shader
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentSource, nullptr);
-    glCompileShader(fragmentShader);
-    
-    // Check fragment shader compilation
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(fragmentShader, 512, nullptr, infoLog);
-        std::cerr << "Water fragment shader compilation failed: " << infoLog << std::endl;
-        return 0;
-    }
-    
-    // Link shaders
-    GLuint program = glCreateProgram();
-    glAttachShader(program, vertexShader);
-    glAttachShader(program, fragmentShader);
-    glLinkProgram(program);
-    
-    // Check linking
-    glGetProgramiv(program, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(program, 512, nullptr, infoLog);
-        std::cerr << "Water shader program linking failed: " << infoLog << std::endl;
-        return 0;
-    }
-    
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-    
-    return program;
+    device->setUniform(lightDirLoc, direction);
 }
 
 void WaterShader::getUniformLocations() {
-    modelLoc = glGetUniformLocation(shaderProgram, "model");
-    viewLoc = glGetUniformLocation(shaderProgram, "view");
-    projectionLoc = glGetUniformLocation(shaderProgram, "projection");
-    timeLoc = glGetUniformLocation(shaderProgram, "time");
-    waterLevelLoc = glGetUniformLocation(shaderProgram, "waterLevel");
-    lightDirLoc = glGetUniformLocation(shaderProgram, "lightDirection");
+    modelLoc = device->getUniformLocation(shaderProgram, "model");
+    timeLoc = device->getUniformLocation(shaderProgram, "time");
+    waterLevelLoc = device->getUniformLocation(shaderProgram, "waterLevel");
+    lightDirLoc = device->getUniformLocation(shaderProgram, "lightDirection");
 }
@@ -1,45 +1,44 @@
 #pragma once
 
-#include <glad/gl.h>
 #include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
+#include "render_device.h"
 
 /**
- * WaterShader handles animated water rendering with waves and transparency
+ * WaterShader handles animated water rendering with waves and transparency.
+ * It draws the chunks' water meshes, which share the terrain vertex layout,
+ * in a translucent pass after the opaque terrain.
+ * The camera comes from the shared camera uniform buffer; the remaining
+ * uniform locations are looked up once after the program links.
  */
 class WaterShader {
 public:
     WaterShader();
     ~WaterShader();
     
-    // Initialize the water shader system
-    bool initialize();
+    // Initialize the water shader system (call after the graphics context is ready)
+    bool initialize(RenderDevice& device);
     
     // Use the water shader for rendering
     void use();
     
-    // Set shader uniforms
-    void setMatrices(const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection);
+    // Set shader uniforms; the program must be in use
+    void setModel(const glm::mat4& model);
     void setTime(float time);
     void setWaterLevel(float level);
     void setLightDirection(const glm::vec3& direction);
     
     // Get shader program ID
-    GLuint getProgram() const { return shaderProgram; }
+    unsigned int getProgram() const { return shaderProgram; }
     
 private:
-    GLuint shaderProgram;
+    RenderDevice* device;          // Set by initialize()
+    unsigned int shaderProgram;
     
     // Uniform locations
-    GLint modelLoc;
-    GLint viewLoc;
-    GLint projectionLoc;
-    GLint timeLoc;
-    GLint waterLevelLoc;
-    GLint lightDirLoc;
+    UniformLocation modelLoc;
+    UniformLocation timeLoc;
+    UniformLocation waterLevelLoc;
+    UniformLocation lightDirLoc;
     
-    // Shader creation helper
-    GLuint createShader(const char* vertexSource, const char* fragmentSource);
     void getUniformLocations();
 };
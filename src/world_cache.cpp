@@ -0,0 +1,253 @@
+#include "world_cache.h"
+#include "log.h"
+#include "memory_stats.h"
+#include "profiler.h"
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#define NOGDI
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char CACHE_MAGIC[4] = { 'H', 'V', 'W', 'C' };
+const int BLOCKS_PER_CHUNK = VoxelChunk::CHUNK_SIZE * VoxelChunk::CHUNK_SIZE * VoxelChunk::CHUNK_SIZE;
+const int MAX_RUN = 255;
+
+}
+
+WorldCache::WorldCache()
+    : data(nullptr)
+    , dataSize(0)
+    , offsets(nullptr)
+    , payload(nullptr)
+    , minX(0), minZ(0), sizeX(0), sizeZ(0)
+#ifdef _WIN32
+    , fileHandle(nullptr)
+    , mappingHandle(nullptr)
+#endif
+{
+}
+
+WorldCache::~WorldCache() {
+    close();
+}
+
+bool WorldCache::open(const std::string& path, const TerrainGenerator& generator) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    HANDLE mapping = nullptr;
+    const void* view = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    data = static_cast<const uint8_t*>(view);
+    dataSize = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    void* view = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd); // The mapping keeps the file contents alive
+    if (view == MAP_FAILED) return false;
+    data = static_cast<const uint8_t*>(view);
+    dataSize = static_cast<size_t>(info.st_size);
+#endif
+
+    // Validate the header and offset table before trusting any of it
+    Header header;
+    bool valid = dataSize >= sizeof(Header);
+    if (valid) {
+        std::memcpy(&header, data, sizeof(Header));
+        valid = std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 &&
+                header.formatVersion == FORMAT_VERSION &&
+                header.sizeX > 0 && header.sizeZ > 0 &&
+                header.sizeX <= 4096 && header.sizeZ <= 4096;
+    }
+    size_t tableSize = valid ? (static_cast<size_t>(header.sizeX) * header.sizeZ + 1) * sizeof(uint32_t) : 0;
+    if (valid) {
+        valid = dataSize >= sizeof(Header) + tableSize;
+    }
+    if (valid) {
+        offsets = reinterpret_cast<const uint32_t*>(data + sizeof(Header));
+        payload = data + sizeof(Header) + tableSize;
+        size_t chunkCount = static_cast<size_t>(header.sizeX) * header.sizeZ;
+        valid = offsets[chunkCount] == dataSize - sizeof(Header) - tableSize;
+        for (size_t i = 0; valid && i < chunkCount; i++) {
+            valid = offsets[i] <= offsets[i + 1];
+        }
+    }
+    if (!valid) {
+        LOG_WARNING("World cache " << path << " is corrupt, ignoring it");
+        close();
+        return false;
+    }
+
+    if (header.generatorVersion != static_cast<uint32_t>(TerrainGenerator::GENERATOR_VERSION) ||
+        header.generatorFlags != getGeneratorFlags(generator)) {
+        LOG_INFO("World cache " << path << " was made by a different terrain generator, ignoring it");
+        close();
+        return false;
+    }
+
+    minX = header.minX;
+    minZ = header.minZ;
+    sizeX = header.sizeX;
+    sizeZ = header.sizeZ;
+    MemoryStats::add(MemoryCategory::WORLD_CACHE, static_cast<long long>(dataSize));
+    return true;
+}
+
+void WorldCache::close() {
+    // Only a successfully opened cache was counted, and only it has sizeX set
+    if (sizeX > 0) MemoryStats::add(MemoryCategory::WORLD_CACHE, -static_cast<long long>(dataSize));
+#ifdef _WIN32
+    if (data) UnmapViewOfFile(data);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+#else
+    if (data) munmap(const_cast<uint8_t*>(data), dataSize);
+#endif
+    data = nullptr;
+    dataSize = 0;
+    offsets = nullptr;
+    payload = nullptr;
+    minX = minZ = sizeX = sizeZ = 0;
+}
+
+bool WorldCache::contains(int chunkX, int chunkZ) const {
+    return data && chunkX >= minX && chunkX < minX + sizeX && chunkZ >= minZ && chunkZ < minZ + sizeZ;
+}
+
+bool WorldCache::loadChunk(VoxelChunk& chunk, int chunkX, int chunkZ) const {
+    if (!contains(chunkX, chunkZ)) return false;
+    PROFILE_SCOPE("WorldCache::loadChunk");
+
+    size_t index = static_cast<size_t>(chunkX - minX) * sizeZ + (chunkZ - minZ);
+    const uint8_t* run = payload + offsets[index];
+    const uint8_t* end = payload + offsets[index + 1];
+
+    // Runs walk the chunk layer by layer from the bottom, rows along x
+    const int size = VoxelChunk::CHUNK_SIZE;
+    int position = 0;
+    for (; run + 1 < end && position < BLOCKS_PER_CHUNK; run += 2) {
+        int length = run[0];
+        int type = run[1];
+        if (length == 0 || type > static_cast<int>(BlockType::REDSTONE_ORE) ||
+            position + length > BLOCKS_PER_CHUNK) {
+            break;
+        }
+        if (type != static_cast<int>(BlockType::AIR)) {
+            for (int i = position; i < position + length; i++) {
+                int row = i / size;
+                chunk.setBlock(i % size, row / size, row % size, static_cast<BlockType>(type));
+            }
+        }
+        position += length;
+    }
+
+    if (position != BLOCKS_PER_CHUNK || run != end) {
+        LOG_WARNING("World cache chunk (" << chunkX << ", " << chunkZ << ") is corrupt");
+        return false;
+    }
+    return true;
+}
+
+void WorldCache::encodeChunk(const VoxelChunk& chunk, std::vector<uint8_t>& out) {
+    out.clear();
+    const int size = VoxelChunk::CHUNK_SIZE;
+    int runType = -1;
+    int runLength = 0;
+    // Terrain is mostly horizontal layers, so layer order gives the longest runs
+    for (int y = 0; y < size; y++) {
+        for (int z = 0; z < size; z++) {
+            for (int x = 0; x < size; x++) {
+                int type = static_cast<int>(chunk.getBlockType(x, y, z));
+                if (type == runType && runLength < MAX_RUN) {
+                    runLength++;
+                    continue;
+                }
+                if (runLength > 0) {
+                    out.push_back(static_cast<uint8_t>(runLength));
+                    out.push_back(static_cast<uint8_t>(runType));
+                }
+                runType = type;
+                runLength = 1;
+            }
+        }
+    }
+    out.push_back(static_cast<uint8_t>(runLength));
+    out.push_back(static_cast<uint8_t>(runType));
+}
+
+bool WorldCache::write(const std::string& path, const TerrainGenerator& generator,
+                       int minX, int minZ, int sizeX, int sizeZ,
+                       const std::vector<std::vector<uint8_t>>& payloads) {
+    size_t chunkCount = static_cast<size_t>(sizeX) * sizeZ;
+    if (sizeX <= 0 || sizeZ <= 0 || payloads.size() != chunkCount) {
+        LOG_ERROR("World cache: payload count does not match a " << sizeX << "x" << sizeZ << " region");
+        return false;
+    }
+
+    Header header;
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.formatVersion = FORMAT_VERSION;
+    header.generatorVersion = static_cast<uint32_t>(TerrainGenerator::GENERATOR_VERSION);
+    header.generatorFlags = getGeneratorFlags(generator);
+    header.minX = minX;
+    header.minZ = minZ;
+    header.sizeX = sizeX;
+    header.sizeZ = sizeZ;
+
+    std::vector<uint32_t> offsetTable(chunkCount + 1);
+    uint32_t offset = 0;
+    for (size_t i = 0; i < chunkCount; i++) {
+        offsetTable[i] = offset;
+        offset += static_cast<uint32_t>(payloads[i].size());
+    }
+    offsetTable[chunkCount] = offset;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        LOG_ERROR("World cache: cannot open " << path << " for writing");
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    file.write(reinterpret_cast<const char*>(offsetTable.data()), offsetTable.size() * sizeof(uint32_t));
+    for (const std::vector<uint8_t>& chunkPayload : payloads) {
+        file.write(reinterpret_cast<const char*>(chunkPayload.data()), chunkPayload.size());
+    }
+    return static_cast<bool>(file);
+}
+
+uint32_t WorldCache::getGeneratorFlags(const TerrainGenerator& generator) {
+    // Batched and pointwise noise give identical blocks; the sparse lattice does not
+    return generator.isInterpolatedCaves() ? 1u : 0u;
+}
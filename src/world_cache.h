@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "voxel_chunk.h"
+#include "terrain_generator.h"
+
+/**
+ * WorldCache is a pregenerated rectangle of chunks in a compact binary file,
+ * read through a single read-only memory map. Chunks are run-length encoded
+ * layer by layer, so a typical chunk takes about 500 bytes and loads in a few
+ * microseconds instead of being generated again. Written by hackvoxel-gen --output.
+ *
+ * File layout (native byte order):
+ *   Header
+ *   uint32 offsets[sizeX * sizeZ + 1]   payload start of each chunk, x-major; last = end
+ *   payload                             (run length, block type) byte pairs
+ *
+ * A cache only opens if its format and generator version and generation
+ * settings match the running TerrainGenerator.
+ */
+class WorldCache {
+public:
+    static const uint32_t FORMAT_VERSION = 1;
+
+    WorldCache();
+    ~WorldCache();
+
+    WorldCache(const WorldCache&) = delete;
+    WorldCache& operator=(const WorldCache&) = delete;
+
+    // Map a cache file; false (and nothing mapped) if missing, corrupt or stale
+    bool open(const std::string& path, const TerrainGenerator& generator);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+
+    bool contains(int chunkX, int chunkZ) const;
+
+    // Fill a freshly constructed chunk from the cache; false if not cached
+    bool loadChunk(VoxelChunk& chunk, int chunkX, int chunkZ) const;
+
+    int getChunkCount() const { return sizeX * sizeZ; }
+
+    // Encode one chunk's blocks as a payload for write()
+    static void encodeChunk(const VoxelChunk& chunk, std::vector<uint8_t>& out);
+
+    // Write a cache of sizeX * sizeZ chunks starting at (minX, minZ); payloads are
+    // x-major (index (x - minX) * sizeZ + (z - minZ)) and produced by encodeChunk
+    static bool write(const std::string& path, const TerrainGenerator& generator,
+                      int minX, int minZ, int sizeX, int sizeZ,
+                      const std::vector<std::vector<uint8_t>>& payloads);
+
+private:
+    struct Header {
+        char magic[4];
+        uint32_t formatVersion;
+        uint32_t generatorVersion;
+        uint32_t generatorFlags;
+        int32_t minX, minZ;
+        int32_t sizeX, sizeZ;
+    };
+
+    static uint32_t getGeneratorFlags(const TerrainGenerator& generator);
+
+    const uint8_t* data;
+    size_t dataSize;
+    const uint32_t* offsets;
+    const uint8_t* payload;
+    int minX, minZ, sizeX, sizeZ;
+
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+};
@@ -0,0 +1,204 @@
+// Headless world generator: generates (and meshes) a square region of chunks on
+// a pool of worker threads using only the GL-free core library, and reports
+// throughput. Runs on machines without a GPU or display.
+//
+//   hackvoxel-gen [--radius R] [--center X Z] [--threads N] [--lods] [--exact] [--output FILE]
+//                 [--trace FILE]
+//
+//   --radius R     Region of (2R+1)^2 chunks around the centre (default 16)
+//   --center X Z   Centre chunk coordinates (default 0 0)
+//   --threads N    Worker threads (default: hardware concurrency)
+//   --lods         Also build the 2x and 4x level-of-detail meshes
+//   --exact        Exact cave/ore noise instead of the game's sparse lattice
+//   --output FILE  Also write the region as a world cache (e.g. spawn.hvw for the game)
+//   --trace FILE   Capture a Chrome trace of the workers (open in ui.perfetto.dev)
+
+#include "chunk_coord.h"
+#include "terrain_generator.h"
+#include "trace.h"
+#include "voxel_chunk.h"
+#include "world_cache.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct Options {
+    int radius = 16;
+    int centerX = 0;
+    int centerZ = 0;
+    int threads = 0;
+    bool lods = false;
+    bool exact = false;
+    std::string output;
+    std::string trace;
+};
+
+// Per-thread totals, merged after the workers join
+struct WorkerStats {
+    int chunks = 0;
+    double generateSeconds = 0.0;
+    double meshSeconds = 0.0;
+    long long vertices = 0;
+    long long triangles = 0;
+};
+
+void printUsage() {
+    std::cerr << "usage: hackvoxel-gen [--radius R] [--center X Z] [--threads N] [--lods] [--exact] [--output FILE]\n"
+                 "                     [--trace FILE]" << std::endl;
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "--radius") == 0 && i + 1 < argc) {
+            options.radius = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--center") == 0 && i + 2 < argc) {
+            options.centerX = std::atoi(argv[++i]);
+            options.centerZ = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--threads") == 0 && i + 1 < argc) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--lods") == 0) {
+            options.lods = true;
+        } else if (std::strcmp(arg, "--exact") == 0) {
+            options.exact = true;
+        } else if (std::strcmp(arg, "--output") == 0 && i + 1 < argc) {
+            options.output = argv[++i];
+        } else if (std::strcmp(arg, "--trace") == 0 && i + 1 < argc) {
+            options.trace = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    if (options.threads <= 0) {
+        options.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    return options.radius >= 0;
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    // Same configuration as the game's ChunkManager
+    TerrainGenerator generator;
+    generator.setInterpolatedCaves(!options.exact);
+
+    // x-major, matching the world cache chunk order
+    std::vector<ChunkCoord> region;
+    region.reserve((2 * options.radius + 1) * (2 * options.radius + 1));
+    for (int x = options.centerX - options.radius; x <= options.centerX + options.radius; x++) {
+        for (int z = options.centerZ - options.radius; z <= options.centerZ + options.radius; z++) {
+            region.emplace_back(x, z);
+        }
+    }
+
+    std::cout << "Generating " << region.size() << " chunks around (" << options.centerX << ", "
+              << options.centerZ << ") on " << options.threads << " thread(s), noise backend "
+              << BatchNoise::getBackendName(BatchNoise::getBackend()) << std::endl;
+
+    // Workers pull chunk indices from a shared counter; the generator is const and thread-safe
+    std::atomic<size_t> nextChunk{0};
+    std::vector<WorkerStats> stats(options.threads);
+    const int meshLevels = options.lods ? VoxelChunk::LOD_LEVELS : 1;
+    std::vector<std::vector<uint8_t>> payloads(options.output.empty() ? 0 : region.size());
+
+    auto worker = [&](int index) {
+        WorkerStats& out = stats[index];
+        Trace::setThreadName(("worker " + std::to_string(index + 1)).c_str());
+        ChunkMesh mesh;
+        ChunkMesh waterMesh;
+        for (size_t i = nextChunk++; i < region.size(); i = nextChunk++) {
+            const ChunkCoord& coord = region[i];
+            VoxelChunk chunk(coord.x, coord.z);
+
+            Clock::time_point start = Clock::now();
+            generator.generateChunk(chunk, coord.x, coord.z);
+            out.generateSeconds += secondsSince(start);
+
+            start = Clock::now();
+            for (int lod = 0; lod < meshLevels; lod++) {
+                chunk.generateMesh(mesh, lod, &waterMesh);
+                out.vertices += (mesh.vertices.size() + waterMesh.vertices.size()) / 8;
+                out.triangles += (mesh.indices.size() + waterMesh.indices.size()) / 3;
+            }
+            out.meshSeconds += secondsSince(start);
+            out.chunks++;
+
+            if (!payloads.empty()) {
+                WorldCache::encodeChunk(chunk, payloads[i]);
+            }
+        }
+    };
+
+    if (!options.trace.empty()) {
+        Trace::start();
+    }
+    Clock::time_point start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < options.threads; t++) {
+        threads.emplace_back(worker, t);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double wallSeconds = secondsSince(start);
+    if (!options.trace.empty()) {
+        Trace::stop();
+        if (!Trace::write(options.trace)) return 1;
+        std::cout << "Trace:         " << Trace::getEventCount() << " events written to " << options.trace;
+        if (Trace::getDroppedCount() > 0) std::cout << " (" << Trace::getDroppedCount() << " dropped)";
+        std::cout << std::endl;
+    }
+
+    WorkerStats total;
+    for (const WorkerStats& s : stats) {
+        total.chunks += s.chunks;
+        total.generateSeconds += s.generateSeconds;
+        total.meshSeconds += s.meshSeconds;
+        total.vertices += s.vertices;
+        total.triangles += s.triangles;
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Chunks:        " << total.chunks << " in " << wallSeconds * 1000.0 << " ms" << std::endl;
+    std::cout << "Throughput:    " << total.chunks / wallSeconds << " chunks/s" << std::endl;
+    std::cout << std::setprecision(3);
+    std::cout << "Per chunk:     generate " << total.generateSeconds * 1000.0 / total.chunks << " ms, mesh "
+              << total.meshSeconds * 1000.0 / total.chunks << " ms (thread time)" << std::endl;
+    std::cout << "Mesh output:   " << total.vertices << " vertices, " << total.triangles << " triangles" << std::endl;
+
+    if (!options.output.empty()) {
+        int side = 2 * options.radius + 1;
+        if (!WorldCache::write(options.output, generator, options.centerX - options.radius,
+                               options.centerZ - options.radius, side, side, payloads)) {
+            return 1;
+        }
+        size_t bytes = 0;
+        for (const std::vector<uint8_t>& payload : payloads) {
+            bytes += payload.size();
+        }
+        std::cout << "World cache:   " << options.output << ", " << bytes / 1024 << " KB of chunk data ("
+                  << bytes / payloads.size() << " bytes/chunk)" << std::endl;
+    }
+    return 0;
+}